@@ -105,7 +105,8 @@ int main(int argc, char **argv)
                         break;
                     }
 
-                    if (pElfFile->Header().e_ident[EI_ABIVERSION] != DLX_ELFOSABIVER_DLX)
+                    if ((pElfFile->Header().e_ident[EI_ABIVERSION] != DLX_ELFOSABIVER_DLX) &&
+                        (pElfFile->Header().e_ident[EI_ABIVERSION] != DLX_ELFOSABIVER_DLX_V1))
                     {
                         printf("  *** Incorrect OSABIVERSION in header\n");
                         break;
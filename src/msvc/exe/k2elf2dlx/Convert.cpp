@@ -31,7 +31,14 @@
 //
 #include "elf2dlx.h"
 
-#define TARGET_SYMENT_BYTES (sizeof(K2TREE_NODE) + sizeof(char *))
+#include <stdlib.h>
+
+typedef struct _GROUPREL GROUPREL;
+struct _GROUPREL
+{
+    UINT32  mKey;       // (kind << 16) | symbol segment
+    UINT32  mOffset;    // offset into target section
+};
 
 typedef struct _STRENT STRENT;
 struct _STRENT
@@ -81,7 +88,11 @@ static bool sTargetSections(void)
             continue;
         if ((pSrcSecHdr->sh_flags & DLX_SHF_TYPE_MASK) == DLX_SHF_TYPE_IMPORTS)
         {
-            gOut.mpSecMap[secIx].mSegmentIndex = DlxSeg_Reloc;
+            // code imports that are bound lazily stay loaded with the stubs' names
+            if ((gOut.mLazyBind) && (pSrcSecHdr->sh_flags & SHF_EXECINSTR))
+                gOut.mpSecMap[secIx].mSegmentIndex = DlxSeg_Read;
+            else
+                gOut.mpSecMap[secIx].mSegmentIndex = DlxSeg_Reloc;
             gOut.mpSecMap[secIx].mFlags |= SECTION_FLAG_PLACED;
             
             gOut.mppWorkSecData[secIx] = (UINT8 *)K2ELF32_GetSectionData(&gOut.Parse, secIx);
@@ -946,65 +957,671 @@ static bool sShrinkStringTables(bool aKeepAllGlobalSymbols)
     return true;
 }
 
-static bool sResizeSymTables(void)
+static bool sGetLazyRef(Elf32_Sym const *apSym, DLX_EXPORTS_SECTION const *apImpSec, UINT32 *apRetRefIx)
 {
-    Elf32_Shdr *    pSrcSecHdr;
-    UINT32          secIx;
-    UINT32          entBytes;
-    UINT32          entCount;
-    UINT8 *         pNewSymData;
-    UINT8 *         pOldSymData;
-    UINT32          symIx;
+    Elf32_Shdr const *  pOrigSecHdr;
+    UINT32              offset;
+
+    // symbol values are still source addresses here
+    pOrigSecHdr = (Elf32_Shdr const *)K2ELF32_GetSectionHeader(&gOut.Parse, gOut.mpRevRemap[apSym->st_shndx]);
+    offset = apSym->st_value - pOrigSecHdr->sh_addr;
+    if ((offset < (sizeof(DLX_EXPORTS_SECTION) - sizeof(DLX_EXPORT_REF))) ||
+        (((offset - (sizeof(DLX_EXPORTS_SECTION) - sizeof(DLX_EXPORT_REF))) % sizeof(DLX_EXPORT_REF)) != 0))
+        return false;
+    offset = (offset - (sizeof(DLX_EXPORTS_SECTION) - sizeof(DLX_EXPORT_REF))) / sizeof(DLX_EXPORT_REF);
+    if (offset >= apImpSec->mCount)
+        return false;
+    *apRetRefIx = offset;
+    return true;
+}
+
+static bool sAddLazyBindSections(void)
+{
+    Elf32_Shdr *                pSymSecHdr;
+    Elf32_Shdr *                pSecHdr;
+    Elf32_Shdr *                pNewSecHdr;
+    UINT8 **                    ppNewWorkSecData;
+    ELFFILE_SECTION_MAPPING *   pNewSecMap;
+    DLX_EXPORTS_SECTION *       pImpSec;
+    UINT32 **                   ppStubOfRef;
+    UINT32 *                    pStubCount;
+    UINT32 *                    pNameBytes;
+    UINT32                      ix;
+    UINT32                      impSecIx;
+    UINT32                      secIx;
+    UINT32                      segIx;
+    UINT32                      newSecIx;
+    UINT32                      newCount;
+    UINT32                      entBytes;
+    UINT32                      entCount;
+    UINT32                      symIx;
+    UINT32                      refIx;
+    UINT32                      impBytes;
+    UINT8 *                     pWork;
+    char const *                pName;
+    Elf32_Sym                   symEnt;
 
-    // make sure symbol table entries are large enough to 
-    // permit a tree node + a char pointer to facilitate
-    // a symbol lookup tree that uses the tree nodes in the
-    // same place as the symbol entries after load
-    for (secIx = 3;secIx < gOut.mOutSecCount; secIx++)
+    //
+    // calls to a lazy bound code import go to a stub in the text segment that
+    // jumps through a slot in the data segment.  the symbols for the imports are
+    // moved to the stubs, so calls to them are just calls inside this dlx.  the
+    // import section stays loaded and gets the names of the imports called so
+    // that the slots can be bound by name after the load
+    //
+    gOut.mFirstLazySecIx = gOut.mOutSecCount;
+    if (!gOut.mLazyBind)
+        return true;
+
+    ppStubOfRef = new UINT32 *[gOut.mImportSecCount];
+    pStubCount = new UINT32[gOut.mImportSecCount * 2];
+    if ((ppStubOfRef == NULL) || (pStubCount == NULL))
     {
-        pSrcSecHdr = &gOut.mpOutSecHdr[secIx];
-        if (pSrcSecHdr->sh_size == 0)
+        printf("*** Memory allocation failed\n");
+        return false;
+    }
+    K2MEM_Zero(ppStubOfRef, sizeof(UINT32 *) * gOut.mImportSecCount);
+    K2MEM_Zero(pStubCount, sizeof(UINT32) * gOut.mImportSecCount * 2);
+    pNameBytes = pStubCount + gOut.mImportSecCount;
+
+    newCount = 0;
+    for (ix = 0; ix < gOut.mImportSecCount; ix++)
+    {
+        impSecIx = gOut.mpImportSecIx[ix];
+        if (gOut.mpSecMap[impSecIx].mSegmentIndex != DlxSeg_Read)
             continue;
-        if (pSrcSecHdr->sh_type != SHT_SYMTAB)
+
+        pImpSec = (DLX_EXPORTS_SECTION *)gOut.mppWorkSecData[impSecIx];
+        ppStubOfRef[ix] = new UINT32[pImpSec->mCount];
+        if (ppStubOfRef[ix] == NULL)
+        {
+            printf("*** Memory allocation failed\n");
+            return false;
+        }
+        K2MEM_Set32(ppStubOfRef[ix], (UINT32)-1, sizeof(UINT32) * pImpSec->mCount);
+
+        // one stub for each import that is used
+        for (secIx = 3; secIx < gOut.mOutSecCount; secIx++)
+        {
+            pSymSecHdr = &gOut.mpOutSecHdr[secIx];
+            if ((pSymSecHdr->sh_type != SHT_SYMTAB) || (pSymSecHdr->sh_size == 0))
+                continue;
+
+            entBytes = pSymSecHdr->sh_entsize;
+            entCount = pSymSecHdr->sh_size / entBytes;
+            for (symIx = 1; symIx < entCount; symIx++)
+            {
+                K2MEM_Copy(&symEnt, gOut.mppWorkSecData[secIx] + (symIx * entBytes), sizeof(Elf32_Sym));
+                if (symEnt.st_shndx != impSecIx)
+                    continue;
+                if ((symEnt.st_name == 0) ||
+                    (!sGetLazyRef(&symEnt, pImpSec, &refIx)))
+                {
+                    printf("*** Code import symbol %d cannot be bound lazily\n", symIx);
+                    return false;
+                }
+                if (ppStubOfRef[ix][refIx] != (UINT32)-1)
+                    continue;
+                ppStubOfRef[ix][refIx] = pStubCount[ix]++;
+                pName = (char const *)gOut.mppWorkSecData[pSymSecHdr->sh_link] + symEnt.st_name;
+                pNameBytes[ix] += K2ASC_Len(pName) + 1;
+            }
+        }
+
+        if (pStubCount[ix] > 0)
+            newCount += 2;
+    }
+
+    if (newCount > 0)
+    {
+        pNewSecHdr = new Elf32_Shdr[gOut.mOutSecCount + newCount];
+        ppNewWorkSecData = new UINT8 *[gOut.mOutSecCount + newCount];
+        pNewSecMap = new ELFFILE_SECTION_MAPPING[gOut.mOutSecCount + newCount];
+        if ((pNewSecHdr == NULL) || (ppNewWorkSecData == NULL) || (pNewSecMap == NULL))
+        {
+            printf("*** Memory allocation failed\n");
+            return false;
+        }
+        K2MEM_Zero(pNewSecHdr, sizeof(Elf32_Shdr) * (gOut.mOutSecCount + newCount));
+        K2MEM_Zero(ppNewWorkSecData, sizeof(UINT8 *) * (gOut.mOutSecCount + newCount));
+        K2MEM_Zero(pNewSecMap, sizeof(ELFFILE_SECTION_MAPPING) * (gOut.mOutSecCount + newCount));
+        K2MEM_Copy(pNewSecHdr, gOut.mpOutSecHdr, sizeof(Elf32_Shdr) * gOut.mOutSecCount);
+        K2MEM_Copy(ppNewWorkSecData, gOut.mppWorkSecData, sizeof(UINT8 *) * gOut.mOutSecCount);
+        K2MEM_Copy(pNewSecMap, gOut.mpSecMap, sizeof(ELFFILE_SECTION_MAPPING) * gOut.mOutSecCount);
+        delete[] gOut.mpOutSecHdr;
+        delete[] gOut.mppWorkSecData;
+        delete[] gOut.mpSecMap;
+        gOut.mpOutSecHdr = pNewSecHdr;
+        gOut.mppWorkSecData = ppNewWorkSecData;
+        gOut.mpSecMap = pNewSecMap;
+    }
+
+    newSecIx = gOut.mOutSecCount;
+    for (ix = 0; ix < gOut.mImportSecCount; ix++)
+    {
+        if (pStubCount[ix] == 0)
+        {
+            if (ppStubOfRef[ix] != NULL)
+                delete[] ppStubOfRef[ix];
             continue;
+        }
 
-        entBytes = pSrcSecHdr->sh_entsize;
-        if (entBytes >= TARGET_SYMENT_BYTES)
+        impSecIx = gOut.mpImportSecIx[ix];
+        pSecHdr = &gOut.mpOutSecHdr[impSecIx];
+
+        // import section gets the names of the imports that are called
+        impBytes = K2_ROUNDUP(pSecHdr->sh_size, 4);
+        pWork = new UINT8[K2_ROUNDUP(impBytes + pNameBytes[ix], 4)];
+        if (pWork == NULL)
+        {
+            printf("*** Memory allocation failed\n");
+            return false;
+        }
+        K2MEM_Zero(pWork, K2_ROUNDUP(impBytes + pNameBytes[ix], 4));
+        K2MEM_Copy(pWork, gOut.mppWorkSecData[impSecIx], pSecHdr->sh_size);
+        gOut.mppWorkSecData[impSecIx] = pWork;
+        pImpSec = (DLX_EXPORTS_SECTION *)pWork;
+        pSecHdr->sh_size = K2_ROUNDUP(impBytes + pNameBytes[ix], 4);
+
+        // stubs hold the index of the import they call.  the loader does the rest
+        pWork = new UINT8[pStubCount[ix] * DLX_LAZY_STUB_BYTES];
+        gOut.mppWorkSecData[newSecIx + 1] = new UINT8[pStubCount[ix] * sizeof(UINT32)];
+        if ((pWork == NULL) || (gOut.mppWorkSecData[newSecIx + 1] == NULL))
+        {
+            printf("*** Memory allocation failed\n");
+            return false;
+        }
+        K2MEM_Zero(pWork, pStubCount[ix] * DLX_LAZY_STUB_BYTES);
+        K2MEM_Zero(gOut.mppWorkSecData[newSecIx + 1], pStubCount[ix] * sizeof(UINT32));
+        gOut.mppWorkSecData[newSecIx] = pWork;
+        for (refIx = 0; refIx < pImpSec->mCount; refIx++)
+        {
+            if (ppStubOfRef[ix][refIx] != (UINT32)-1)
+                K2MEM_Copy(pWork + (ppStubOfRef[ix][refIx] * DLX_LAZY_STUB_BYTES) + DLX_LAZY_STUB_IXOFFSET, &refIx, sizeof(UINT32));
+        }
+
+        // move the import symbols to the stubs.  their values are left as the
+        // source address of the import ref so the relocations can still be undone
+        for (secIx = 3; secIx < gOut.mFirstLazySecIx; secIx++)
+        {
+            pSymSecHdr = &gOut.mpOutSecHdr[secIx];
+            if ((pSymSecHdr->sh_type != SHT_SYMTAB) || (pSymSecHdr->sh_size == 0))
+                continue;
+
+            entBytes = pSymSecHdr->sh_entsize;
+            entCount = pSymSecHdr->sh_size / entBytes;
+            for (symIx = 1; symIx < entCount; symIx++)
+            {
+                K2MEM_Copy(&symEnt, gOut.mppWorkSecData[secIx] + (symIx * entBytes), sizeof(Elf32_Sym));
+                if (symEnt.st_shndx != impSecIx)
+                    continue;
+                sGetLazyRef(&symEnt, pImpSec, &refIx);
+                if (pImpSec->Export[refIx].mNameOffset == 0)
+                {
+                    pName = (char const *)gOut.mppWorkSecData[pSymSecHdr->sh_link] + symEnt.st_name;
+                    K2ASC_Copy((char *)pImpSec + impBytes, pName);
+                    pImpSec->Export[refIx].mNameOffset = impBytes;
+                    impBytes += K2ASC_Len(pName) + 1;
+                }
+                symEnt.st_shndx = (Elf32_Half)newSecIx;
+                K2MEM_Copy(gOut.mppWorkSecData[secIx] + (symIx * entBytes), &symEnt, sizeof(Elf32_Sym));
+            }
+        }
+
+        delete[] ppStubOfRef[ix];
+
+        pSecHdr = &gOut.mpOutSecHdr[newSecIx];
+        pSecHdr->sh_type = DLX_SHT_DLX_LAZYSTUB;
+        pSecHdr->sh_flags = SHF_ALLOC | SHF_EXECINSTR;
+        pSecHdr->sh_addr = (Elf32_Addr)-1;
+        pSecHdr->sh_size = pStubCount[ix] * DLX_LAZY_STUB_BYTES;
+        pSecHdr->sh_link = impSecIx;
+        pSecHdr->sh_info = newSecIx + 1;
+        pSecHdr->sh_addralign = sizeof(UINT32);
+        pSecHdr->sh_entsize = DLX_LAZY_STUB_BYTES;
+        gOut.mpSecMap[newSecIx].mSegmentIndex = DlxSeg_Text;
+        gOut.mpSecMap[newSecIx].mFlags = SECTION_FLAG_PLACED;
+
+        pSecHdr = &gOut.mpOutSecHdr[newSecIx + 1];
+        pSecHdr->sh_type = SHT_PROGBITS;
+        pSecHdr->sh_flags = SHF_ALLOC | SHF_WRITE;
+        pSecHdr->sh_addr = (Elf32_Addr)-1;
+        pSecHdr->sh_size = pStubCount[ix] * sizeof(UINT32);
+        pSecHdr->sh_addralign = sizeof(UINT32);
+        pSecHdr->sh_entsize = sizeof(UINT32);
+        gOut.mpSecMap[newSecIx + 1].mSegmentIndex = DlxSeg_Data;
+        gOut.mpSecMap[newSecIx + 1].mFlags = SECTION_FLAG_PLACED;
+
+        for (secIx = newSecIx; secIx < newSecIx + 2; secIx++)
+        {
+            segIx = gOut.mpSecMap[secIx].mSegmentIndex;
+            gOut.FileAlloc.Segment[segIx].mSecCount++;
+            if (gOut.FileAlloc.Segment[segIx].mMemAlign < sizeof(UINT32))
+            {
+                gOut.FileAlloc.Segment[segIx].mMemAlign = sizeof(UINT32);
+                gOut.FileAlloc.Segment[segIx].mMemByteCount = secIx;
+            }
+        }
+
+        newSecIx += 2;
+    }
+    K2_ASSERT(newSecIx == gOut.mOutSecCount + newCount);
+
+    delete[] ppStubOfRef;
+    delete[] pStubCount;
+
+    gOut.mOutSecCount = newSecIx;
+
+    return true;
+}
+
+static int sCompareGroupRel(void const *apLeft, void const *apRight)
+{
+    GROUPREL const *pLeft = (GROUPREL const *)apLeft;
+    GROUPREL const *pRight = (GROUPREL const *)apRight;
+
+    if (pLeft->mKey != pRight->mKey)
+        return (pLeft->mKey < pRight->mKey) ? -1 : 1;
+    if (pLeft->mOffset != pRight->mOffset)
+        return (pLeft->mOffset < pRight->mOffset) ? -1 : 1;
+    return 0;
+}
+
+static UINT32 sEncodeGroup(GROUPREL const *apRel, UINT32 aCount, UINT32 *apOut)
+{
+    UINT32  ix;
+    UINT32  cursor;
+    UINT32  word;
+    UINT32  delta;
+    UINT32  wordCount;
+
+    wordCount = 0;
+    ix = 0;
+    while (ix < aCount)
+    {
+        apOut[wordCount++] = apRel[ix].mOffset << 1;
+        cursor = apRel[ix].mOffset + sizeof(UINT32);
+        ix++;
+
+        // follow with as many bitmap words as we can
+        while (ix < aCount)
+        {
+            word = 0;
+            while (ix < aCount)
+            {
+                if (apRel[ix].mOffset < cursor)
+                    break;
+                delta = apRel[ix].mOffset - cursor;
+                if ((delta >= (31 * sizeof(UINT32))) || (delta & 3))
+                    break;
+                word |= ((UINT32)1) << ((delta / sizeof(UINT32)) + 1);
+                ix++;
+            }
+            if (word == 0)
+                break;
+            apOut[wordCount++] = word | 1;
+            cursor += 31 * sizeof(UINT32);
+        }
+    }
+
+    return wordCount;
+}
+
+static bool sCompactRelocs(void)
+{
+    Elf32_Shdr *        pRelSecHdr;
+    Elf32_Shdr *        pSymSecHdr;
+    Elf32_Shdr const *  pOrigTrgSecHdr;
+    UINT32              secIx;
+    UINT32              trgSecIx;
+    UINT32              trgSegIx;
+    UINT32              symSegIx;
+    UINT32              origTrgAddr;
+    UINT32              relEntBytes;
+    UINT32              relCount;
+    UINT32              relIx;
+    UINT32              symEntBytes;
+    UINT32              machine;
+    UINT32              relType;
+    UINT32              kind;
+    UINT32              groupRelCount;
+    UINT32              leftCount;
+    UINT32              groupCount;
+    UINT32              compactBytes;
+    UINT32              ix;
+    UINT32              first;
+    Elf32_Rel           relEnt;
+    Elf32_Sym           symEnt;
+    GROUPREL *          pGroupRel;
+    Elf32_Rel *         pFullRel;
+    UINT8 *             pOut;
+    UINT8 *             pWork;
+    DLX_RELOC_HDR *     pRelHdr;
+    DLX_RELOC_GROUP *   pGroup;
+
+    gOut.mppFullRel = new UINT8 *[gOut.mOutSecCount];
+    gOut.mpFullRelCount = new UINT32[gOut.mOutSecCount];
+    if ((gOut.mppFullRel == NULL) || (gOut.mpFullRelCount == NULL))
+    {
+        printf("*** Memory allocation failed\n");
+        return false;
+    }
+    K2MEM_Zero(gOut.mppFullRel, sizeof(UINT8 *) * gOut.mOutSecCount);
+    K2MEM_Zero(gOut.mpFullRelCount, sizeof(UINT32) * gOut.mOutSecCount);
+
+    machine = gOut.Parse.mpRawFileData->e_machine;
+
+    //
+    // relocations against symbols inside this dlx only need the move of a
+    // segment added at load time, so they go into sorted offset groups.
+    // pc-relative ones within the same segment never change at load time
+    // and are dropped.  everything else stays as an Elf32_Rel.
+    //
+    for (secIx = 3; secIx < gOut.mOutSecCount; secIx++)
+    {
+        pRelSecHdr = &gOut.mpOutSecHdr[secIx];
+        if (pRelSecHdr->sh_size == 0)
+            continue;
+        if (pRelSecHdr->sh_type != SHT_REL)
             continue;
 
-        if (entBytes == 0)
-            entBytes = sizeof(Elf32_Sym);
+        trgSecIx = pRelSecHdr->sh_info;
+        trgSegIx = gOut.mpSecMap[trgSecIx].mSegmentIndex;
+        if ((trgSegIx < DlxSeg_Text) || (trgSegIx > DlxSeg_Data))
+            continue;
 
-        entCount = pSrcSecHdr->sh_size / entBytes;
+        pOrigTrgSecHdr = (Elf32_Shdr const *)K2ELF32_GetSectionHeader(&gOut.Parse, gOut.mpRevRemap[trgSecIx]);
+        origTrgAddr = pOrigTrgSecHdr->sh_addr;
+
+        pSymSecHdr = &gOut.mpOutSecHdr[pRelSecHdr->sh_link];
+        symEntBytes = pSymSecHdr->sh_entsize;
+        if (symEntBytes == 0)
+            symEntBytes = sizeof(Elf32_Sym);
 
-        pNewSymData = new UINT8[entCount * TARGET_SYMENT_BYTES];
-        if (pNewSymData == NULL)
+        relEntBytes = pRelSecHdr->sh_entsize;
+        relCount = pRelSecHdr->sh_size / relEntBytes;
+
+        pGroupRel = new GROUPREL[relCount];
+        pFullRel = (Elf32_Rel *)new UINT8[relCount * sizeof(Elf32_Rel)];
+        if ((pGroupRel == NULL) || (pFullRel == NULL))
         {
             printf("*** Memory allocation failed\n");
             return false;
         }
-        K2MEM_Zero(pNewSymData, entCount * TARGET_SYMENT_BYTES);
 
-        pOldSymData = gOut.mppWorkSecData[secIx];
+        groupRelCount = 0;
+        leftCount = 0;
+        for (relIx = 0; relIx < relCount; relIx++)
+        {
+            K2MEM_Copy(&relEnt, gOut.mppWorkSecData[secIx] + (relIx * relEntBytes), sizeof(Elf32_Rel));
+            K2MEM_Copy(&pFullRel[relIx], &relEnt, sizeof(Elf32_Rel));
+
+            K2MEM_Copy(&symEnt, gOut.mppWorkSecData[pRelSecHdr->sh_link] + (ELF32_R_SYM(relEnt.r_info) * symEntBytes), sizeof(Elf32_Sym));
+            symSegIx = DlxSeg_Other;
+            if ((symEnt.st_shndx != 0) &&
+                (symEnt.st_shndx < gOut.mOutSecCount))
+                symSegIx = gOut.mpSecMap[symEnt.st_shndx].mSegmentIndex;
+
+            relType = ELF32_R_TYPE(relEnt.r_info);
+            kind = (UINT32)-1;
+            if ((symSegIx >= DlxSeg_Text) && (symSegIx <= DlxSeg_Data))
+            {
+                if (machine == EM_X32)
+                {
+                    if (relType == R_386_32)
+                        kind = DLX_RELOC_KIND_ABS32;
+                    else if (relType == R_386_PC32)
+                    {
+                        if (symSegIx == trgSegIx)
+                            continue;
+                        kind = DLX_RELOC_KIND_PC32;
+                    }
+                }
+                else
+                {
+                    if (relType == R_ARM_ABS32)
+                        kind = DLX_RELOC_KIND_ABS32;
+                    else if (((relType == R_ARM_PC24) ||
+                              (relType == R_ARM_CALL) ||
+                              (relType == R_ARM_JUMP24)) &&
+                             (symSegIx == trgSegIx))
+                        continue;
+                }
+            }
+
+            if (kind == (UINT32)-1)
+            {
+                K2MEM_Copy(gOut.mppWorkSecData[secIx] + (leftCount * sizeof(Elf32_Rel)), &relEnt, sizeof(Elf32_Rel));
+                leftCount++;
+                continue;
+            }
 
-        for (symIx = 0; symIx < entCount; symIx++)
+            pGroupRel[groupRelCount].mKey = (kind << 16) | symSegIx;
+            pGroupRel[groupRelCount].mOffset = relEnt.r_offset - origTrgAddr;
+            groupRelCount++;
+        }
+
+        qsort(pGroupRel, groupRelCount, sizeof(GROUPREL), sCompareGroupRel);
+
+        pOut = new UINT8[sizeof(DLX_RELOC_HDR) +
+            (groupRelCount * (sizeof(DLX_RELOC_GROUP) + (2 * sizeof(UINT32)))) +
+            (leftCount * sizeof(Elf32_Rel))];
+        if (pOut == NULL)
         {
-            K2MEM_Copy(
-                pNewSymData + (symIx * TARGET_SYMENT_BYTES),
-                pOldSymData + (symIx * entBytes),
-                entBytes);
+            printf("*** Memory allocation failed\n");
+            return false;
         }
 
-        pSrcSecHdr->sh_size = (entCount * TARGET_SYMENT_BYTES);
-        pSrcSecHdr->sh_entsize = TARGET_SYMENT_BYTES;
+        pWork = pOut + sizeof(DLX_RELOC_HDR);
+        groupCount = 0;
+        ix = 0;
+        while (ix < groupRelCount)
+        {
+            first = ix;
+            do
+            {
+                ix++;
+            } while ((ix < groupRelCount) && (pGroupRel[ix].mKey == pGroupRel[first].mKey));
+
+            pGroup = (DLX_RELOC_GROUP *)pWork;
+            pGroup->mKind = (UINT16)(pGroupRel[first].mKey >> 16);
+            pGroup->mSymSegment = (UINT16)(pGroupRel[first].mKey & 0xFFFF);
+            pGroup->mWordCount = sEncodeGroup(&pGroupRel[first], ix - first, (UINT32 *)(pGroup + 1));
+            pWork += sizeof(DLX_RELOC_GROUP) + (pGroup->mWordCount * sizeof(UINT32));
+            groupCount++;
+        }
+
+        K2MEM_Copy(pWork, gOut.mppWorkSecData[secIx], leftCount * sizeof(Elf32_Rel));
+        pWork += leftCount * sizeof(Elf32_Rel);
+
+        pRelHdr = (DLX_RELOC_HDR *)pOut;
+        pRelHdr->mGroupCount = groupCount;
+        pRelHdr->mRelCount = leftCount;
+
+        compactBytes = (UINT32)(pWork - pOut);
+
+        delete[] pGroupRel;
+
+        if (compactBytes >= relCount * relEntBytes)
+        {
+            // not worth it - put back the original entries
+            for (relIx = 0; relIx < relCount; relIx++)
+                K2MEM_Copy(gOut.mppWorkSecData[secIx] + (relIx * relEntBytes), &pFullRel[relIx], sizeof(Elf32_Rel));
+            delete[] ((UINT8 *)pFullRel);
+            delete[] pOut;
+            continue;
+        }
+
+        // target keeps the full set to apply at link address
+        gOut.mppFullRel[secIx] = (UINT8 *)pFullRel;
+        gOut.mpFullRelCount[secIx] = relCount;
 
-        delete[] gOut.mppWorkSecData[secIx];
-        gOut.mppWorkSecData[secIx] = pNewSymData;
+        gOut.mppWorkSecData[secIx] = pOut;
+        pRelSecHdr->sh_type = DLX_SHT_DLX_RELOC;
+        pRelSecHdr->sh_entsize = sizeof(Elf32_Rel);
+        pRelSecHdr->sh_size = compactBytes;
     }
 
     return true;
 }
 
+static UINT32 sSymSegment(Elf32_Sym const *apSym)
+{
+    Elf32_Shdr const * pTrgSecHdr;
+
+    if ((apSym->st_shndx == 0) ||
+        (apSym->st_shndx >= gOut.mOutSecCount))
+        return DlxSeg_Other;
+
+    pTrgSecHdr = &gOut.mpOutSecHdr[apSym->st_shndx];
+    if ((pTrgSecHdr->sh_flags & DLX_SHF_TYPE_MASK) == DLX_SHF_TYPE_IMPORTS)
+        return DlxSeg_Other;
+
+    return gOut.mpSecMap[apSym->st_shndx].mSegmentIndex;
+}
+
+static UINT32 sCountSegSymbols(UINT32 aSymSecIx, UINT32 aSegIx)
+{
+    Elf32_Shdr const *  pSymSecHdr;
+    UINT32              entBytes;
+    UINT32              entCount;
+    UINT32              symIx;
+    UINT32              count;
+    Elf32_Sym           symEnt;
+
+    pSymSecHdr = &gOut.mpOutSecHdr[aSymSecIx];
+    entBytes = pSymSecHdr->sh_entsize;
+    entCount = pSymSecHdr->sh_size / entBytes;
+
+    count = 0;
+    for (symIx = 1; symIx < entCount; symIx++)
+    {
+        K2MEM_Copy(&symEnt, gOut.mppWorkSecData[aSymSecIx] + (symIx * entBytes), sizeof(Elf32_Sym));
+        if (sSymSegment(&symEnt) == aSegIx)
+            count++;
+    }
+
+    return count;
+}
+
+static bool sAddSymIndexSections(void)
+{
+    Elf32_Shdr *                pSymSecHdr;
+    Elf32_Shdr *                pSecHdr;
+    Elf32_Shdr *                pNewSecHdr;
+    UINT8 **                    ppNewWorkSecData;
+    ELFFILE_SECTION_MAPPING *   pNewSecMap;
+    UINT32                      secIx;
+    UINT32                      segIx;
+    UINT32                      newSecIx;
+    UINT32                      newCount;
+    UINT32                      entBytes;
+    UINT32                      entCount;
+    UINT32                      symIx;
+    UINT32                      ixCount;
+    Elf32_Sym                   symEnt;
+    UINT32 *                    pIx;
+
+    // one index of symbols per segment per symbol table.  they are filled
+    // in here and sorted by address when the target is created, since
+    // that is when the final section positions in the segments are known
+    newCount = 0;
+    for (secIx = 3; secIx < gOut.mOutSecCount; secIx++)
+    {
+        pSymSecHdr = &gOut.mpOutSecHdr[secIx];
+        if ((pSymSecHdr->sh_type != SHT_SYMTAB) || (pSymSecHdr->sh_size == 0))
+            continue;
+        for (segIx = DlxSeg_Text; segIx <= DlxSeg_Data; segIx++)
+        {
+            if (sCountSegSymbols(secIx, segIx) > 0)
+                newCount++;
+        }
+    }
+
+    gOut.mFirstSymIxSecIx = gOut.mOutSecCount;
+    if (newCount == 0)
+        return true;
+
+    pNewSecHdr = new Elf32_Shdr[gOut.mOutSecCount + newCount];
+    ppNewWorkSecData = new UINT8 *[gOut.mOutSecCount + newCount];
+    pNewSecMap = new ELFFILE_SECTION_MAPPING[gOut.mOutSecCount + newCount];
+    if ((pNewSecHdr == NULL) || (ppNewWorkSecData == NULL) || (pNewSecMap == NULL))
+    {
+        printf("*** Memory allocation failed\n");
+        return false;
+    }
+    K2MEM_Zero(pNewSecHdr, sizeof(Elf32_Shdr) * (gOut.mOutSecCount + newCount));
+    K2MEM_Zero(ppNewWorkSecData, sizeof(UINT8 *) * (gOut.mOutSecCount + newCount));
+    K2MEM_Zero(pNewSecMap, sizeof(ELFFILE_SECTION_MAPPING) * (gOut.mOutSecCount + newCount));
+    K2MEM_Copy(pNewSecHdr, gOut.mpOutSecHdr, sizeof(Elf32_Shdr) * gOut.mOutSecCount);
+    K2MEM_Copy(ppNewWorkSecData, gOut.mppWorkSecData, sizeof(UINT8 *) * gOut.mOutSecCount);
+    K2MEM_Copy(pNewSecMap, gOut.mpSecMap, sizeof(ELFFILE_SECTION_MAPPING) * gOut.mOutSecCount);
+    delete[] gOut.mpOutSecHdr;
+    delete[] gOut.mppWorkSecData;
+    delete[] gOut.mpSecMap;
+    gOut.mpOutSecHdr = pNewSecHdr;
+    gOut.mppWorkSecData = ppNewWorkSecData;
+    gOut.mpSecMap = pNewSecMap;
+
+    newSecIx = gOut.mOutSecCount;
+    for (secIx = 3; secIx < gOut.mFirstSymIxSecIx; secIx++)
+    {
+        pSymSecHdr = &gOut.mpOutSecHdr[secIx];
+        if ((pSymSecHdr->sh_type != SHT_SYMTAB) || (pSymSecHdr->sh_size == 0))
+            continue;
+
+        entBytes = pSymSecHdr->sh_entsize;
+        entCount = pSymSecHdr->sh_size / entBytes;
+
+        for (segIx = DlxSeg_Text; segIx <= DlxSeg_Data; segIx++)
+        {
+            ixCount = sCountSegSymbols(secIx, segIx);
+            if (ixCount == 0)
+                continue;
+
+            pIx = new UINT32[ixCount];
+            if (pIx == NULL)
+            {
+                printf("*** Memory allocation failed\n");
+                return false;
+            }
+            gOut.mppWorkSecData[newSecIx] = (UINT8 *)pIx;
+
+            for (symIx = 1; symIx < entCount; symIx++)
+            {
+                K2MEM_Copy(&symEnt, gOut.mppWorkSecData[secIx] + (symIx * entBytes), sizeof(Elf32_Sym));
+                if (sSymSegment(&symEnt) == segIx)
+                    *(pIx++) = symIx;
+            }
+
+            pSecHdr = &gOut.mpOutSecHdr[newSecIx];
+            pSecHdr->sh_type = DLX_SHT_DLX_SYMIDX;
+            pSecHdr->sh_addr = (Elf32_Addr)-1;
+            pSecHdr->sh_size = ixCount * sizeof(UINT32);
+            pSecHdr->sh_link = secIx;
+            pSecHdr->sh_info = segIx;
+            pSecHdr->sh_addralign = sizeof(UINT32);
+            pSecHdr->sh_entsize = sizeof(UINT32);
+
+            gOut.mpSecMap[newSecIx].mSegmentIndex = DlxSeg_Sym;
+            gOut.mpSecMap[newSecIx].mFlags = SECTION_FLAG_PLACED;
+
+            gOut.FileAlloc.Segment[DlxSeg_Sym].mSecCount++;
+            if (gOut.FileAlloc.Segment[DlxSeg_Sym].mMemAlign < sizeof(UINT32))
+            {
+                gOut.FileAlloc.Segment[DlxSeg_Sym].mMemAlign = sizeof(UINT32);
+                gOut.FileAlloc.Segment[DlxSeg_Sym].mMemByteCount = newSecIx;
+            }
+
+            newSecIx++;
+        }
+    }
+    K2_ASSERT(newSecIx == gOut.mOutSecCount + newCount);
+
+    gOut.mOutSecCount = newSecIx;
+
+    return true;
+}
+
 static bool sPlaceSegmentSections(void)
 {
     UINT32          segIx;
@@ -1221,7 +1838,10 @@ static bool sLayoutFile(void)
     fileOffset = K2_ROUNDUP(fileOffset, DLX_SECTOR_BYTES);
     gOut.mpDstInfo->SegInfo[segIx].mFileBytes = fileOffset - gOut.mpDstInfo->SegInfo[segIx].mFileOffset;
 
-    memAddr = 0x400000;
+    if (gOut.mPrelinkBase != 0)
+        memAddr = gOut.mPrelinkBase;
+    else
+        memAddr = 0x400000;
 
     for (segIx = DlxSeg_Info + 1;segIx < DlxSeg_Other; segIx++)
     {
@@ -1299,7 +1919,13 @@ int Convert(void)
     if (!sShrinkStringTables(true))
         return -405;
 
-    if (!sResizeSymTables())
+    if (!sAddLazyBindSections())
+        return -410;
+
+    if (!sCompactRelocs())
+        return -409;
+
+    if (!sAddSymIndexSections())
         return -406;
 
     if (!sPlaceSegmentSections())
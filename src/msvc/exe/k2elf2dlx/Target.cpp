@@ -31,6 +31,8 @@
 //
 #include "elf2dlx.h"
 
+#include <stdlib.h>
+
 typedef struct _RELCTX RELCTX;
 struct _RELCTX
 {
@@ -49,6 +51,26 @@ struct _RELCTX
 
 static RELCTX sgRel;
 
+static UINT8 const *    sgpSortSymBase;
+static UINT32           sgSortSymEntBytes;
+
+static int sCompareSymIx(void const *apLeft, void const *apRight)
+{
+    UINT32      leftIx = *((UINT32 const *)apLeft);
+    UINT32      rightIx = *((UINT32 const *)apRight);
+    Elf32_Sym   leftSym;
+    Elf32_Sym   rightSym;
+
+    K2MEM_Copy(&leftSym, sgpSortSymBase + (leftIx * sgSortSymEntBytes), sizeof(Elf32_Sym));
+    K2MEM_Copy(&rightSym, sgpSortSymBase + (rightIx * sgSortSymEntBytes), sizeof(Elf32_Sym));
+
+    if (leftSym.st_value != rightSym.st_value)
+        return (leftSym.st_value < rightSym.st_value) ? -1 : 1;
+    if (leftIx != rightIx)
+        return (leftIx < rightIx) ? -1 : 1;
+    return 0;
+}
+
 typedef bool(*pfDoReloc)(void);
 
 static pfDoReloc sDoReloc = NULL;
@@ -162,6 +184,32 @@ static bool sDoRelocA32(void)
     return true;
 }
 
+static UINT32 sLazyStubAddr(UINT8 const *apAlignOut, UINT32 const *apOrigSecAddr, UINT32 aStubSecIx, UINT32 aRefAddr)
+{
+    Elf32_Shdr const *  pStubSecHdr;
+    UINT8 const *       pStub;
+    UINT32              refIx;
+    UINT32              stubIx;
+    UINT32              stubRefIx;
+
+    // symbol still holds the source address of the import ref it calls
+    pStubSecHdr = &gOut.mpOutSecHdr[aStubSecIx];
+    refIx = aRefAddr - apOrigSecAddr[pStubSecHdr->sh_link];
+    refIx = (refIx - (sizeof(DLX_EXPORTS_SECTION) - sizeof(DLX_EXPORT_REF))) / sizeof(DLX_EXPORT_REF);
+
+    pStub = apAlignOut + pStubSecHdr->sh_offset;
+    for (stubIx = 0; stubIx < pStubSecHdr->sh_size / DLX_LAZY_STUB_BYTES; stubIx++)
+    {
+        K2MEM_Copy(&stubRefIx, pStub + DLX_LAZY_STUB_IXOFFSET, sizeof(UINT32));
+        if (stubRefIx == refIx)
+            return pStubSecHdr->sh_addr + (stubIx * DLX_LAZY_STUB_BYTES);
+        pStub += DLX_LAZY_STUB_BYTES;
+    }
+
+    K2_ASSERT(0);
+    return 0;
+}
+
 int CreateTargetDLX(void)
 {
     UINT8 *         pRawOut;
@@ -182,6 +230,11 @@ int CreateTargetDLX(void)
     Elf32_Rel       relEnt;
     UINT32          segIx;
     UINT32          fileOffset;
+    Elf32_Shdr *    pImpSecHdr;
+    DLX_EXPORTS_SECTION * pExpSec;
+    UINT32          ixExp;
+    DLX_RELOC_HDR * pRelHdr;
+    int             ret;
 
     if (gOut.Parse.mpRawFileData->e_machine == EM_X32)
         sDoReloc = sDoRelocX32;
@@ -196,6 +249,12 @@ int CreateTargetDLX(void)
     }
     for (secIx = 1; secIx < gOut.mOutSecCount; secIx++)
     {
+        if (secIx >= gOut.mFirstLazySecIx)
+        {
+            // made by us - not in the source file
+            pOrigSecAddr[secIx] = 0;
+            continue;
+        }
         pSecHdr = (Elf32_Shdr *)K2ELF32_GetSectionHeader(&gOut.Parse, gOut.mpRevRemap[secIx]);
         pOrigSecAddr[secIx] = pSecHdr->sh_addr;
     }
@@ -229,6 +288,8 @@ int CreateTargetDLX(void)
         pOutHdr->e_flags = DLX_EF_KERNEL_ONLY;
     if (pOutHdr->e_machine == EM_A32)
         pOutHdr->e_flags |= EF_A32_ABIVER;
+    if (gOut.mPrelinkBase != 0)
+        pOutHdr->e_flags |= DLX_EF_PRELINKED;
     pOutHdr->e_ehsize = sizeof(Elf32_Ehdr);
     pOutHdr->e_shentsize = sizeof(Elf32_Shdr);
     pOutHdr->e_shnum = gOut.mOutSecCount;
@@ -249,7 +310,8 @@ int CreateTargetDLX(void)
     // change symbol addresses and entry point address
     for (secIx = 1; secIx < gOut.mOutSecCount;secIx++)
     {
-        if ((pOutHdr->e_entry >= pOrigSecAddr[secIx]) &&
+        if ((secIx < gOut.mFirstLazySecIx) &&
+            (pOutHdr->e_entry >= pOrigSecAddr[secIx]) &&
             ((pOutHdr->e_entry - pOrigSecAddr[secIx]) < gOut.mpOutSecHdr[secIx].sh_size))
         {
             pOutHdr->e_entry -= pOrigSecAddr[secIx];
@@ -271,25 +333,63 @@ int CreateTargetDLX(void)
                 if ((symEnt.st_shndx != 0) &&
                     (symEnt.st_shndx < gOut.mOutSecCount))
                 {
-                    symEnt.st_value -= pOrigSecAddr[symEnt.st_shndx];
-                    symEnt.st_value += gOut.mpOutSecHdr[symEnt.st_shndx].sh_addr;
+                    if (gOut.mpOutSecHdr[symEnt.st_shndx].sh_type == DLX_SHT_DLX_LAZYSTUB)
+                        symEnt.st_value = sLazyStubAddr(pAlignOut, pOrigSecAddr, symEnt.st_shndx, symEnt.st_value);
+                    else
+                    {
+                        symEnt.st_value -= pOrigSecAddr[symEnt.st_shndx];
+                        symEnt.st_value += gOut.mpOutSecHdr[symEnt.st_shndx].sh_addr;
+                    }
                     K2MEM_Copy(pSymNew + (symIx * symEntBytes), &symEnt, sizeof(Elf32_Sym));
                 }
             }
         }
     }
 
+    // symbols are at their final addresses so the symbol indexes can be sorted
+    for (secIx = gOut.mFirstSymIxSecIx; secIx < gOut.mOutSecCount; secIx++)
+    {
+        pSecHdr = &gOut.mpOutSecHdr[secIx];
+        K2_ASSERT(pSecHdr->sh_type == DLX_SHT_DLX_SYMIDX);
+        sgpSortSymBase = pAlignOut + gOut.mpOutSecHdr[pSecHdr->sh_link].sh_offset;
+        sgSortSymEntBytes = gOut.mpOutSecHdr[pSecHdr->sh_link].sh_entsize;
+        qsort(pAlignOut + pSecHdr->sh_offset, pSecHdr->sh_size / sizeof(UINT32), sizeof(UINT32), sCompareSymIx);
+    }
+
+    // imports from a prelinked dlx carry the addresses that dlx will be at.
+    // if we are prelinking too then we bind to those and record the digest
+    if (gOut.mPrelinkBase != 0)
+    {
+        for (secIx = 0; secIx < gOut.mImportSecCount; secIx++)
+        {
+            pImpSecHdr = &gOut.mpOutSecHdr[gOut.mpImportSecIx[secIx]];
+            pExpSec = (DLX_EXPORTS_SECTION *)(pAlignOut + pImpSecHdr->sh_offset);
+            if ((pExpSec->mCount > 0) && (pExpSec->Export[0].mAddr != 0))
+                pImpSecHdr->sh_info = CalcExportDigest(pExpSec);
+            else
+                pImpSecHdr->sh_info = 0;
+        }
+    }
+
     // apply relocations
     K2MEM_Zero(&sgRel, sizeof(sgRel));
     for (secIx = 1; secIx < gOut.mOutSecCount;secIx++)
     {
         pSecHdr = &gOut.mpOutSecHdr[secIx];
-        if (pSecHdr->sh_type != SHT_REL)
+        if (pSecHdr->sh_type == SHT_REL)
+        {
+            pRelWork = pAlignOut + pSecHdr->sh_offset;
+            relEntCount = pSecHdr->sh_size / pSecHdr->sh_entsize;
+        }
+        else if (pSecHdr->sh_type == DLX_SHT_DLX_RELOC)
+        {
+            // apply the full set. only the ungrouped ones are in the output
+            pRelWork = gOut.mppFullRel[secIx];
+            relEntCount = gOut.mpFullRelCount[secIx];
+        }
+        else
             continue;
-
-        pRelWork = pAlignOut + pSecHdr->sh_offset;
         relEntBytes = pSecHdr->sh_entsize;
-        relEntCount = pSecHdr->sh_size / relEntBytes;
 
         pSymNew = pAlignOut + gOut.mpOutSecHdr[pSecHdr->sh_link].sh_offset;
         pSymOld = gOut.mppWorkSecData[pSecHdr->sh_link];
@@ -308,6 +408,21 @@ int CreateTargetDLX(void)
             K2_ASSERT((symIx != 0) && (symIx < symEntCount));
             K2MEM_Copy(&sgRel.OldSym, pSymOld + (symIx * symEntBytes), sizeof(Elf32_Sym));
             K2MEM_Copy(&sgRel.NewSym, pSymNew + (symIx * symEntBytes), sizeof(Elf32_Sym));
+            if ((gOut.mPrelinkBase != 0) &&
+                (sgRel.NewSym.st_shndx != 0) &&
+                (sgRel.NewSym.st_shndx < gOut.mOutSecCount))
+            {
+                pImpSecHdr = &gOut.mpOutSecHdr[sgRel.NewSym.st_shndx];
+                if (((pImpSecHdr->sh_flags & DLX_SHF_TYPE_MASK) == DLX_SHF_TYPE_IMPORTS) &&
+                    (pImpSecHdr->sh_info != 0))
+                {
+                    // bind to the prelinked address of the export. symbol keeps
+                    // pointing at the import ref so the loader can still rebind
+                    K2MEM_Copy(&sgRel.NewSym.st_value,
+                        pAlignOut + pImpSecHdr->sh_offset + (sgRel.NewSym.st_value - pImpSecHdr->sh_addr),
+                        sizeof(UINT32));
+                }
+            }
             sgRel.mType = ELF32_R_TYPE(relEnt.r_info);
             sgRel.mOffset = relEnt.r_offset - sgRel.mOldTargetSecAddr;
             if (!sDoReloc())
@@ -316,6 +431,41 @@ int CreateTargetDLX(void)
             K2MEM_Copy(pRelWork, &relEnt, sizeof(Elf32_Rel));
             pRelWork += relEntBytes;
         } while (--relEntCount);
+
+        if (pSecHdr->sh_type == DLX_SHT_DLX_RELOC)
+        {
+            // ungrouped relocations are at the end of the section
+            pRelHdr = (DLX_RELOC_HDR *)(pAlignOut + pSecHdr->sh_offset);
+            pRelWork = pAlignOut + pSecHdr->sh_offset + pSecHdr->sh_size - (pRelHdr->mRelCount * sizeof(Elf32_Rel));
+            for (relEntCount = pRelHdr->mRelCount; relEntCount > 0; relEntCount--)
+            {
+                K2MEM_Copy(&relEnt, pRelWork, sizeof(Elf32_Rel));
+                relEnt.r_offset = (relEnt.r_offset - sgRel.mOldTargetSecAddr) + sgRel.mNewTargetSecAddr;
+                K2MEM_Copy(pRelWork, &relEnt, sizeof(Elf32_Rel));
+                pRelWork += sizeof(Elf32_Rel);
+            }
+            delete[] gOut.mppFullRel[secIx];
+            gOut.mppFullRel[secIx] = NULL;
+        }
+    }
+
+    // remember final export addresses for the import library
+    if (gOut.mPrelinkBase != 0)
+    {
+        for (ixExp = 0; ixExp < 3; ixExp++)
+        {
+            if (gOut.mpExpSec[ixExp] == NULL)
+                continue;
+            pExpSec = (DLX_EXPORTS_SECTION *)(pAlignOut + gOut.mpOutSecHdr[gOut.mpRemap[gOut.mExpSecIx[ixExp]]].sh_offset);
+            gOut.mpPrelinkExpAddr[ixExp] = new UINT32[pExpSec->mCount];
+            if (gOut.mpPrelinkExpAddr[ixExp] == NULL)
+            {
+                printf("*** Memory allocation failed\n");
+                return -506;
+            }
+            for (symIx = 0; symIx < pExpSec->mCount; symIx++)
+                gOut.mpPrelinkExpAddr[ixExp][symIx] = pExpSec->Export[symIx].mAddr;
+        }
     }
 
     // set segment CRCs
@@ -336,6 +486,14 @@ int CreateTargetDLX(void)
         }
     }
 
+    // deflate segments after their crcs are taken.  this changes file offsets
+    if (gOut.mCompress)
+    {
+        ret = CompressSegments(pAlignOut);
+        if (ret != 0)
+            return ret;
+    }
+
     // set elf headers crc
     gOut.mpDstInfo->mElfCRC = K2CRC_Calc32(0, pAlignOut, gOut.mpOutSecHdr[1].sh_offset);
 
@@ -222,8 +222,8 @@ bool ValidateLoad(void)
 //                printf("    %08X %s\n", pExp->Export[ixExp].mAddr, ((char *)pExp) + pExp->Export[ixExp].mNameOffset);
 //            }
             gOut.mTotalExportCount += pExp->mCount;
-            gOut.mTotalExportStrSize += pSecHdr->sh_size -
-                (sizeof(DLX_EXPORTS_SECTION) + (sizeof(DLX_EXPORT_REF) * (pExp->mCount - 1)));
+            // names are at the end of the section, after any hash index
+            gOut.mTotalExportStrSize += pSecHdr->sh_size - pExp->Export[0].mNameOffset;
         }
     }
 
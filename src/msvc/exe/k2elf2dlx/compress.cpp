@@ -0,0 +1,189 @@
+//   
+//   BSD 3-Clause License
+//   
+//   Copyright (c) 2020, Kurt Kennett
+//   All rights reserved.
+//   
+//   Redistribution and use in source and binary forms, with or without
+//   modification, are permitted provided that the following conditions are met:
+//   
+//   1. Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//   
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//   
+//   3. Neither the name of the copyright holder nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//   
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//   FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//   SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//   CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+#include "elf2dlx.h"
+#include <lib/zlib.h>
+
+#define DEFLATE_LEVEL       9
+#define DEFLATE_MEMLEVEL    8
+
+static
+voidpf
+sZAlloc(
+    voidpf  aOpaque,
+    uInt    aItems,
+    uInt    aSize
+    )
+{
+    return (voidpf) new UINT8[aItems * aSize];
+}
+
+static
+void
+sZFree(
+    voidpf  aOpaque,
+    voidpf  aAddress
+    )
+{
+    delete[] ((UINT8 *)aAddress);
+}
+
+static
+bool
+sDeflate(
+    UINT8 const *   apSrc,
+    UINT32          aSrcBytes,
+    UINT8 *         apDst,
+    UINT32 *        apIoDstBytes
+    )
+{
+    z_stream    strm;
+    int         zRet;
+
+    K2MEM_Zero(&strm, sizeof(strm));
+    strm.zalloc = sZAlloc;
+    strm.zfree = sZFree;
+
+    // raw deflate stream - the segment crc already covers the data
+    if (deflateInit2(&strm, DEFLATE_LEVEL, Z_DEFLATED, -DLX_DEFLATE_WINDOW_BITS, DEFLATE_MEMLEVEL, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        printf("*** Could not initialize deflate\n");
+        return false;
+    }
+
+    strm.next_in = (Bytef *)apSrc;
+    strm.avail_in = aSrcBytes;
+    strm.next_out = apDst;
+    strm.avail_out = *apIoDstBytes;
+
+    zRet = deflate(&strm, Z_FINISH);
+
+    deflateEnd(&strm);
+
+    // stream does not fit in the space given if it did not finish
+    if (zRet != Z_STREAM_END)
+        return false;
+
+    *apIoDstBytes = (UINT32)strm.total_out;
+
+    return true;
+}
+
+int
+CompressSegments(
+    UINT8 * apAlignOut
+    )
+{
+    Elf32_Ehdr *    pOutHdr;
+    DLX_INFO *      pInfo;
+    UINT8 *         pWork;
+    UINT32          segIx;
+    UINT32          secIx;
+    UINT32          workBytes;
+    UINT32          readOffset;
+    UINT32          writeOffset;
+    UINT32          rawBytes;
+    UINT32          outBytes;
+
+    pOutHdr = (Elf32_Ehdr *)apAlignOut;
+    pInfo = gOut.mpDstInfo;
+
+    workBytes = 0;
+    for (segIx = DlxSeg_Text; segIx <= DlxSeg_Data; segIx++)
+    {
+        if (pInfo->SegInfo[segIx].mFileBytes > workBytes)
+            workBytes = pInfo->SegInfo[segIx].mFileBytes;
+    }
+    if (workBytes == 0)
+        return 0;
+
+    pWork = new UINT8[workBytes];
+    if (pWork == NULL)
+    {
+        printf("*** Memory allocation failed\n");
+        return -600;
+    }
+
+    //
+    // segments only ever get smaller so the file is packed down in place.
+    // a segment is only kept deflated if that saves at least one sector
+    //
+    writeOffset = pInfo->SegInfo[DlxSeg_Text].mFileOffset;
+    for (segIx = DlxSeg_Text; segIx < DlxSeg_Count; segIx++)
+    {
+        readOffset = pInfo->SegInfo[segIx].mFileOffset;
+        rawBytes = pInfo->SegInfo[segIx].mFileBytes;
+
+        outBytes = 0;
+        if ((segIx <= DlxSeg_Data) && (rawBytes > DLX_SECTOR_BYTES))
+        {
+            outBytes = rawBytes - DLX_SECTOR_BYTES;
+            if (sDeflate(apAlignOut + readOffset, rawBytes, pWork, &outBytes))
+            {
+                K2MEM_Copy(apAlignOut + writeOffset, pWork, outBytes);
+                K2MEM_Zero(apAlignOut + writeOffset + outBytes, K2_ROUNDUP(outBytes, DLX_SECTOR_BYTES) - outBytes);
+                outBytes = K2_ROUNDUP(outBytes, DLX_SECTOR_BYTES);
+                pOutHdr->e_flags |= DLX_EF_DEFLATED(segIx);
+            }
+            else
+                outBytes = 0;
+        }
+
+        if (outBytes == 0)
+        {
+            outBytes = rawBytes;
+            if ((outBytes > 0) && (writeOffset != readOffset))
+                memmove(apAlignOut + writeOffset, apAlignOut + readOffset, outBytes);
+        }
+
+        // section offsets move with their segment
+        for (secIx = 1; secIx < gOut.mOutSecCount; secIx++)
+        {
+            if ((gOut.mpOutSecHdr[secIx].sh_type != SHT_NOBITS) &&
+                (gOut.mpOutSecHdr[secIx].sh_offset >= readOffset) &&
+                ((gOut.mpOutSecHdr[secIx].sh_offset - readOffset) < rawBytes))
+            {
+                gOut.mpOutSecHdr[secIx].sh_offset -= readOffset;
+                gOut.mpOutSecHdr[secIx].sh_offset += writeOffset;
+            }
+        }
+
+        pInfo->SegInfo[segIx].mFileOffset = writeOffset;
+        pInfo->SegInfo[segIx].mFileBytes = outBytes;
+        writeOffset += outBytes;
+    }
+
+    delete[] pWork;
+
+    gOut.mOutFileBytes = writeOffset;
+
+    return 0;
+}
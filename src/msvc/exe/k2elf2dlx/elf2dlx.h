@@ -100,6 +100,15 @@ struct _OUTCTX
     // -k
     bool                        mIsKernelDLX;
 
+    // -p preferred link base (zero if not prelinking)
+    UINT32                      mPrelinkBase;
+
+    // -z
+    bool                        mCompress;
+
+    // -d
+    bool                        mLazyBind;
+
     // VerifyLoad sets up
     K2ELF32PARSE                Parse;
     ELFFILE_SECTION_MAPPING *   mpSecMap;
@@ -122,12 +131,19 @@ struct _OUTCTX
     UINT32                      mDlxInfoSize;
     DLX_INFO *                  mpDstInfo;
     UINT32                      mOutBssCount;
+    UINT32                      mFirstLazySecIx;    // lazy stub and slot sections follow the source ones
+    UINT32                      mFirstSymIxSecIx;   // symbol index sections are at the end
+    UINT8 **                    mppFullRel;         // original entries of compacted reloc sections
+    UINT32 *                    mpFullRelCount;
 
     HANDLE                      mhOutput;
     HANDLE                      mhOutLib;
     Elf32_Shdr *                mpOutSecHdr;
     UINT8 **                    mppWorkSecData;
     UINT32                      mOutFileBytes;
+
+    // Target (prelink only) - final export addresses for the import library
+    UINT32 *                    mpPrelinkExpAddr[3];
 };
 
 int TreeStrCompare(UINT32 aKey, K2TREE_NODE * apNode);
@@ -136,10 +152,13 @@ extern OUTCTX  gOut;
 
 bool SetupFilePath(char const *apArgument, char **appTarget);
 bool SetupEntryStackSize(char const *apArgument, UINT32 *apRetSize);
+bool SetupPrelinkBase(char const *apArgument, UINT32 *apRetBase);
+UINT32 CalcExportDigest(DLX_EXPORTS_SECTION const *apSec);
 bool ValidateLoad(void);
 int  CreateImportLib(void);
 int  Convert(void);
 int  CreateTargetDLX(void);
+int  CompressSegments(UINT8 *apAlignOut);
 void VerifyAndDump(void);
 
 /* --------------------------------------------------------------------- */
@@ -307,6 +307,10 @@ int CreateImportLib(void)
                     symType = ELF32_MAKE_SYMBOL_INFO(STB_GLOBAL, STT_OBJECT);
                 for (ixExport = 0;ixExport < gOut.mpExpSec[ixExpType]->mCount;ixExport++)
                 {
+                    // prelinked target publishes where its exports will be
+                    if (gOut.mpPrelinkExpAddr[ixExpType] != NULL)
+                        pOutExpSec[ixExpType]->Export[ixExport].mAddr = gOut.mpPrelinkExpAddr[ixExpType][ixExport];
+
                     pOutSymTab[ixSym].st_name = (outSymStrWork.mAsVal - outSymStrBase.mAsVal);
                     pOutSymTab[ixSym].st_value = (sizeof(DLX_EXPORTS_SECTION) - sizeof(DLX_EXPORT_REF)) +
                         (ixExport * sizeof(DLX_EXPORT_REF));
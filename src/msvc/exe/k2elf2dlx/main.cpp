@@ -42,6 +42,23 @@ TreeStrCompare(
     return K2ASC_Comp((char const *)aKey, (char const *)apNode->mUserVal);
 }
 
+static int sMakeImportLib(void)
+{
+    int ret;
+
+    ret = CreateImportLib();
+
+    if (gOut.mhOutLib != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(gOut.mhOutLib);
+        gOut.mhOutLib = INVALID_HANDLE_VALUE;
+        if (ret != 0)
+            DeleteFile(gOut.mpImportLibFilePath);
+    }
+
+    return ret;
+}
+
 int main(int argc, char **argv)
 {
     ArgParser   parse;
@@ -81,6 +98,14 @@ int main(int argc, char **argv)
             {
                 gOut.mIsKernelDLX = true;
             }
+            else if (K2ASC_ToUpper(pArg[1])=='Z')
+            {
+                gOut.mCompress = true;
+            }
+            else if (K2ASC_ToUpper(pArg[1])=='D')
+            {
+                gOut.mLazyBind = true;
+            }
             else
             {
                 switch (pArg[1])
@@ -109,6 +134,12 @@ int main(int argc, char **argv)
                         return -7;
                     break;
 
+                case 'p':
+                case 'P':
+                    if (!SetupPrelinkBase(parse.Arg(), &gOut.mPrelinkBase))
+                        return -7;
+                    break;
+
                 default:
                     printf("*** Unknown switch '%c' found\n", pArg[1]);
                     return -7;
@@ -191,14 +222,14 @@ int main(int argc, char **argv)
             return -12;
         }
 
-        ret = CreateImportLib();
-
-        if (gOut.mhOutLib != INVALID_HANDLE_VALUE)
-        {
-            CloseHandle(gOut.mhOutLib);
-            if (ret != 0)
-                DeleteFile(gOut.mpImportLibFilePath);
-        }
+        //
+        // a prelinked target only knows its final export addresses once its
+        // relocations are applied, so its import library is made after it
+        //
+        if (gOut.mPrelinkBase == 0)
+            ret = sMakeImportLib();
+        else
+            ret = 0;
     }
     else
     {
@@ -213,12 +244,22 @@ int main(int argc, char **argv)
         if (ret == 0)
             ret = CreateTargetDLX();
 
+        if ((ret == 0) && (gOut.mTotalExportCount > 0) && (gOut.mPrelinkBase != 0))
+            ret = sMakeImportLib();
+
         CloseHandle(gOut.mhOutput);
         if (ret != 0)
         {
             DeleteFile(gOut.mpOutputFilePath);
             if (gOut.mTotalExportCount > 0)
+            {
+                if (gOut.mhOutLib != INVALID_HANDLE_VALUE)
+                {
+                    CloseHandle(gOut.mhOutLib);
+                    gOut.mhOutLib = INVALID_HANDLE_VALUE;
+                }
                 DeleteFile(gOut.mpImportLibFilePath);
+            }
         }
         else
             VerifyAndDump();
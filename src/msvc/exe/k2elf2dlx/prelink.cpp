@@ -0,0 +1,70 @@
+//   
+//   BSD 3-Clause License
+//   
+//   Copyright (c) 2020, Kurt Kennett
+//   All rights reserved.
+//   
+//   Redistribution and use in source and binary forms, with or without
+//   modification, are permitted provided that the following conditions are met:
+//   
+//   1. Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//   
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//   
+//   3. Neither the name of the copyright holder nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//   
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//   FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//   SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//   CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+#include "elf2dlx.h"
+
+bool
+SetupPrelinkBase(
+    char const *    apArgument,
+    UINT32 *        apRetBase
+    )
+{
+    UINT32 base;
+
+    if (K2ASC_NumType(apArgument) == K2_NUMTYPE_None)
+    {
+        printf("*** Could not parse prelink base argument \"%s\"\n", apArgument);
+        return false;
+    }
+    base = K2ASC_NumValue32(apArgument);
+    if ((base == 0) || (base & K2_VA32_MEMPAGE_OFFSET_MASK))
+    {
+        printf("*** Prelink base must be a nonzero page aligned address\n");
+        return false;
+    }
+    *apRetBase = base;
+    return true;
+}
+
+UINT32
+CalcExportDigest(
+    DLX_EXPORTS_SECTION const * apSec
+    )
+{
+    UINT32  crc;
+    UINT32  ix;
+
+    crc = 0;
+    for (ix = 0; ix < apSec->mCount; ix++)
+        crc = K2CRC_Calc32(crc, &apSec->Export[ix].mAddr, sizeof(UINT32));
+
+    return crc;
+}
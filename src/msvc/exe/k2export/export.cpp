@@ -42,6 +42,118 @@ static char const * const sgpSecStr_Rel = ".?export.rel";
 static char const * const sgpSymExp = "dlx_?export";
 static char const * const sgpSymInfo = "gpDlxInfo";
 
+#define EXPORT_HASH_BLOOM_SHIFT 6
+
+static
+void
+sSizeHash(
+    UINT32 aIx
+    )
+{
+    UINT32 count;
+    UINT32 bloomWords;
+
+    count = gOut.mOutSec[aIx].mCount;
+
+    // about two exports per bucket and eight bloom bits per export
+    gOut.mOutSec[aIx].mBucketCount = (count / 2) + 1;
+    bloomWords = 1;
+    while ((bloomWords * 4) < count)
+        bloomWords <<= 1;
+    gOut.mOutSec[aIx].mBloomWords = bloomWords;
+
+    gOut.mOutSec[aIx].mHashBytes = sizeof(DLX_EXPORTS_HASH) +
+        (bloomWords * sizeof(UINT32)) +
+        (gOut.mOutSec[aIx].mBucketCount * sizeof(UINT32)) +
+        (count * sizeof(DLX_EXPORT_HASHENT));
+}
+
+static
+bool
+sEmitHash(
+    UINT32 aIx
+    )
+{
+    DLX_EXPORTS_HASH *      pHash;
+    UINT32 *                pBloom;
+    UINT32 *                pBucket;
+    DLX_EXPORT_HASHENT *    pChain;
+    UINT32 *                pNameHash;
+    UINT32 *                pNext;
+    EXPORT_SPEC *           pSpec;
+    UINT32                  count;
+    UINT32                  bucketCount;
+    UINT32                  ix;
+    UINT32                  b;
+    UINT32                  h;
+    UINT32                  chainIx;
+
+    count = gOut.mOutSec[aIx].mCount;
+    bucketCount = gOut.mOutSec[aIx].mBucketCount;
+
+    pNameHash = new UINT32[count + bucketCount];
+    if (pNameHash == NULL)
+    {
+        printf("*** Memory allocation failed\n");
+        return false;
+    }
+    pNext = pNameHash + count;
+
+    pHash = gOut.mOutSec[aIx].mpExpHash;
+    pHash->mBucketCount = bucketCount;
+    pHash->mBloomWords = gOut.mOutSec[aIx].mBloomWords;
+    pHash->mBloomShift = EXPORT_HASH_BLOOM_SHIFT;
+    pBloom = (UINT32 *)(pHash + 1);
+    pBucket = pBloom + pHash->mBloomWords;
+    pChain = (DLX_EXPORT_HASHENT *)(pBucket + bucketCount);
+
+    // hash names and count entries per bucket
+    K2MEM_Zero(pNext, sizeof(UINT32) * bucketCount);
+    pSpec = gOut.mOutSec[aIx].mpSpec;
+    for (ix = 0; ix < count; ix++)
+    {
+        h = DLX_ExportNameHash(pSpec->mpName);
+        pNameHash[ix] = h;
+        pBloom[(h / 32) & (pHash->mBloomWords - 1)] |=
+            (((UINT32)1) << (h & 31)) | (((UINT32)1) << ((h >> EXPORT_HASH_BLOOM_SHIFT) & 31));
+        pNext[h % bucketCount]++;
+        pSpec = pSpec->mpNext;
+    }
+
+    // buckets get contiguous runs of the chain
+    chainIx = 0;
+    for (b = 0; b < bucketCount; b++)
+    {
+        if (pNext[b] == 0)
+        {
+            pBucket[b] = DLX_EXPORT_HASH_EMPTY;
+            continue;
+        }
+        pBucket[b] = chainIx;
+        chainIx += pNext[b];
+        pNext[b] = pBucket[b];
+    }
+
+    for (ix = 0; ix < count; ix++)
+    {
+        b = pNameHash[ix] % bucketCount;
+        chainIx = pNext[b]++;
+        pChain[chainIx].mHash = pNameHash[ix] & ~1;
+        pChain[chainIx].mExportIx = ix;
+    }
+
+    // mark the end of each run
+    for (b = 0; b < bucketCount; b++)
+    {
+        if (pBucket[b] != DLX_EXPORT_HASH_EMPTY)
+            pChain[pNext[b] - 1].mHash |= 1;
+    }
+
+    delete[] pNameHash;
+
+    return true;
+}
+
 static
 void
 sPrepSection(
@@ -69,6 +181,8 @@ sPrepSection(
     startOffset = gOut.mFileSizeBytes;
     gOut.mFileSizeBytes += sizeof(DLX_EXPORTS_SECTION) - sizeof(DLX_EXPORT_REF);
     gOut.mFileSizeBytes += gOut.mOutSec[aIx].mCount * sizeof(DLX_EXPORT_REF);
+    sSizeHash(aIx);
+    gOut.mFileSizeBytes += gOut.mOutSec[aIx].mHashBytes;
     startOffset = gOut.mFileSizeBytes - startOffset;
     work = 0;
     pSpec = gOut.mOutSec[aIx].mpSpec;
@@ -126,6 +240,9 @@ sPlaceSection(
     gOut.mRawWork += sizeof(DLX_EXPORTS_SECTION) - sizeof(DLX_EXPORT_REF);
     gOut.mRawWork += gOut.mOutSec[aIx].mCount * sizeof(DLX_EXPORT_REF);
 
+    gOut.mOutSec[aIx].mpExpHash = (DLX_EXPORTS_HASH *)gOut.mRawWork;
+    gOut.mRawWork += gOut.mOutSec[aIx].mHashBytes;
+
     gOut.mOutSec[aIx].mpExpStrBase = (char *)gOut.mRawWork;
     gOut.mRawWork += gOut.mOutSec[aIx].mExpStrBytes;
 
@@ -139,7 +256,7 @@ sPlaceSection(
 }
 
 static
-void
+bool
 sEmitSection(
     UINT32   aIx
     )
@@ -152,7 +269,7 @@ sEmitSection(
     char *              pExpSecSymName;
 
     if (gOut.mOutSec[aIx].mCount == 0)
-        return;
+        return true;
 
     gOut.mpSecHdrs[gOut.mOutSec[aIx].mIx].sh_name = (Elf32_Word)(gOut.mpSecStrWork - gOut.mpSecStrBase);
     K2ASC_Copy(gOut.mpSecStrWork, sgpSecStr_Exp);
@@ -219,6 +336,9 @@ sEmitSection(
     gOut.mOutSec[aIx].mpExpBase->mCount = gOut.mOutSec[aIx].mCount;
     gOut.mOutSec[aIx].mpExpBase->mCRC32 = K2CRC_Calc32(0, gOut.mOutSec[aIx].mpExpStrBase, gOut.mOutSec[aIx].mExpStrBytes);
 
+    if (!sEmitHash(aIx))
+        return false;
+
     // name of symbol for export section
     pExpSecSymName = gOut.mpSymStrBase + gOut.mOutSec[aIx].mExpSymNameOffset;
     K2ASC_Copy(pExpSecSymName, sgpSymExp);
@@ -248,6 +368,8 @@ sEmitSection(
 //    DLX_EXPORTS_SECTION ** ppExpSec;
 //    ppExpSec = &gOut.mpInfo->mpExpCode;
 //    ppExpSec[aIx] = (DLX_EXPORTS_SECTION *)gOut.mpSecHdrs[gOut.mOutSec[aIx].mIx].sh_offset;
+
+    return true;
 }
 
 static
@@ -466,7 +588,12 @@ sCreateOutputFile(
             gOut.mpSecHdrs[SECIX_DLXINFO_RELOC].sh_entsize = sizeof(Elf32_Rel);
 
             for (ix = 0;ix < OUTSEC_COUNT;ix++)
-                sEmitSection(ix);
+            {
+                if (!sEmitSection(ix))
+                    break;
+            }
+            if (ix < OUTSEC_COUNT)
+                break;
         }
 
         if (0 != K2ELF32_Parse((UINT8 const *)gOut.mpFileHdr, gOut.mFileSizeBytes, &elfFile))
@@ -78,6 +78,10 @@ struct _EXPSECT
     EXPORT_SPEC *           mpSpec;
 
     DLX_EXPORTS_SECTION *   mpExpBase;
+    DLX_EXPORTS_HASH *      mpExpHash;
+    UINT32                  mHashBytes;
+    UINT32                  mBucketCount;
+    UINT32                  mBloomWords;
     char *                  mpExpStrBase;
     UINT32                  mExpStrBytes;
 
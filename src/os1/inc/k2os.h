@@ -49,6 +49,41 @@ UINT64  K2_CALLCONV_REGS         K2OS_SysUpTimeMs(void);
 
 BOOL    K2_CALLCONV_CALLERCLEANS K2OS_SysGetProperty(UINT32 aPropertyId, void *apRetValue, UINT32 aValueBufferBytes);
 
+#define K2OS_MEMSTATS_PAGELIST_COUNT    32
+
+typedef struct _K2OS_PROC_MEMSTATS K2OS_PROC_MEMSTATS;
+struct _K2OS_PROC_MEMSTATS
+{
+    UINT32  mCommittedPages;        // pages of virtual space covered by the process' segments
+    UINT32  mResidentPages;         // physical pages mapped into those segments
+    UINT32  mResidentPagesHigh;
+    UINT32  mPageTablePages;        // pagetables mapping the process' user space
+};
+
+typedef struct _K2OS_MEMSTATS K2OS_MEMSTATS;
+struct _K2OS_MEMSTATS
+{
+    UINT32              mStructBytes;
+
+    UINT32              mPhysPagesTotal;    // all trackable physical pages
+    UINT32              mPhysPagesInUse;    // pages not on the system free lists
+    UINT32              mPhysPagesInUseHigh;
+    UINT32              mCoreCachedPages;   // free pages held in per-core caches and pools
+    UINT32              mPageTablePages;
+    UINT32              mPageTablePagesHigh;
+    UINT32              mListPages[K2OS_MEMSTATS_PAGELIST_COUNT];   // by kernel page list index
+
+    UINT32              mHeapAllocCount;
+    UINT32              mHeapTotalAlloc;
+    UINT32              mHeapTotalAllocHigh;
+    UINT32              mHeapTotalFree;
+    UINT32              mHeapTotalOverhead;
+
+    K2OS_PROC_MEMSTATS  Proc;
+};
+
+BOOL    K2_CALLCONV_CALLERCLEANS K2OS_SysGetMemStats(UINT32 aProcessId, K2OS_MEMSTATS *apRetStats);
+
 //
 //------------------------------------------------------------------------
 //
@@ -309,6 +344,7 @@ BOOL   K2_CALLCONV_CALLERCLEANS K2OS_HeapGetState(K2OS_HEAP_STATE *apRetState);
 //
 
 #define K2OS_VIRTALLOCFLAG_ALSO_COMMIT  0x00000001
+#define K2OS_VIRTALLOCFLAG_LAZY_COMMIT  0x00000002
 #define K2OS_VIRTALLOCFLAG_TOP_DOWN     0x80000000
 
 BOOL K2_CALLCONV_CALLERCLEANS K2OS_VirtPagesAlloc(UINT32 *apAddr, UINT32 aPageCount, UINT32 aVirtAllocFlags, UINT32 aPageAttrFlags);
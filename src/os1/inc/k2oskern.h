@@ -197,6 +197,54 @@ K2OSKERN_GetCpuIndex(
 //------------------------------------------------------------------------
 //
 
+//
+// a thread entering an owned critical section spins for a few microseconds
+// before it blocks if the owner of the section is running on another core
+//
+#define K2OSKERN_CRITSEC_DEFAULT_SPIN   20
+#define K2OSKERN_CRITSEC_MAX_SPIN       100
+
+typedef struct _K2OSKERN_CRITSEC_STATS K2OSKERN_CRITSEC_STATS;
+struct _K2OSKERN_CRITSEC_STATS
+{
+    UINT32  mSpinLimit;         // max microseconds to spin before blocking
+    UINT32  mSpinAcquireCount;  // entries that got the section while spinning
+    UINT32  mBlockCount;        // entries that had to block
+    UINT32  mSpinIterCount;     // total spin iterations (wrapping)
+};
+
+typedef
+BOOL
+(K2_CALLCONV_REGS *K2OSKERN_pf_CritSecSetSpin)(
+    K2OS_CRITSEC *  apSec,
+    UINT32          aSpinLimit
+);
+
+BOOL
+K2_CALLCONV_REGS
+K2OSKERN_CritSecSetSpin(
+    K2OS_CRITSEC *  apSec,
+    UINT32          aSpinLimit
+);
+
+typedef
+BOOL
+(K2_CALLCONV_REGS *K2OSKERN_pf_CritSecGetStats)(
+    K2OS_CRITSEC *              apSec,
+    K2OSKERN_CRITSEC_STATS *    apRetStats
+);
+
+BOOL
+K2_CALLCONV_REGS
+K2OSKERN_CritSecGetStats(
+    K2OS_CRITSEC *              apSec,
+    K2OSKERN_CRITSEC_STATS *    apRetStats
+);
+
+//
+//------------------------------------------------------------------------
+//
+
 typedef struct _K2OSKERN_OBJ_HEADER K2OSKERN_OBJ_HEADER;
 
 typedef
@@ -498,6 +546,14 @@ struct _K2OSKERN_SVC_MSGIO
 };
 K2_STATIC_ASSERT(sizeof(K2OSKERN_SVC_MSGIO) == sizeof(K2OS_MSGIO));
 
+//
+// page aligned service call buffers at least this big can be lent to the
+// service by mapping the caller's pages for the duration of the call
+// instead of being accessed through the caller's address. lending is
+// compiled out of the kernel until user address lending works
+//
+#define K2OSKERN_SVC_BULK_MIN_BYTES     (4 * K2_VA32_MEMPAGE_BYTES)
+
 //
 // enumerate services that publish a specific interface
 //
@@ -43,3 +43,9 @@ BOOL K2_CALLCONV_CALLERCLEANS K2OS_SysGetProperty(UINT32 aPropertyId, void *apRe
     K2OS_ThreadSetStatus(K2STAT_ERROR_NOT_IMPL);
     return FALSE;
 }
+
+BOOL K2_CALLCONV_CALLERCLEANS K2OS_SysGetMemStats(UINT32 aProcessId, K2OS_MEMSTATS *apRetStats)
+{
+    K2OS_ThreadSetStatus(K2STAT_ERROR_NOT_IMPL);
+    return FALSE;
+}
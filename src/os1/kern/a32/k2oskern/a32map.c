@@ -277,6 +277,95 @@ void KernArch_WritePTE(BOOL aIsMake, UINT32 aVirtAddr, UINT32* apPTE, UINT32 aPT
     K2OSKERN_SetIntr(intState);
 }
 
+void KernArch_FlushPTERange(UINT32 aVirtAddr, UINT32 *apFirstPTE, UINT32 aPteCount)
+{
+    BOOL intState;
+
+    intState = K2OSKERN_SetIntr(FALSE);
+
+    //
+    // clean only the lines holding the entries that were written, then
+    // do the tlb and instruction invalidate once for the whole run
+    //
+    A32_DSB();
+    K2OS_CacheOperation(K2OS_CACHEOP_FlushData, apFirstPTE, aPteCount * sizeof(UINT32));
+    A32_TLBInvalidateAll_UP();
+    K2OS_CacheOperation(K2OS_CACHEOP_InvalidateInstructions, NULL, 0);
+    A32_ISB();
+
+    K2OSKERN_SetIntr(intState);
+}
+
+UINT32 KernArch_MakeLargePDE(UINT32 aPhysAddr, UINT32 aPageMapAttr)
+{
+    UINT32 pte;
+    UINT32 ttbe;
+
+    K2_ASSERT(0 == (aPhysAddr & (K2_VA32_PAGETABLE_MAP_BYTES - 1)));
+
+    //
+    // build a small page entry and move its bits to where a section wants them
+    //
+    pte = KernArch_MakePTE(aPhysAddr, aPageMapAttr);
+
+    ttbe = A32_TTBE_SECTION_PRESENT | (aPhysAddr & A32_TTBE_SECTION_PHYSADDR_MASK);
+    ttbe |= pte & (A32_PTE_B | A32_PTE_C);
+    if (pte & A32_PTE_EXEC_NEVER)
+        ttbe |= A32_TTBE_SECTION_EXEC_NEVER;
+    ttbe |= (pte & (A32_PTE_AP_MASK | A32_PTE_TEX_MASK | A32_PTE_SHARED | A32_PTE_NOT_GLOBAL)) << 6;
+
+    return ttbe;
+}
+
+void KernArch_WriteLargePDE(UINT32 *apPDE, UINT32 aPDE)
+{
+    BOOL    intState;
+    UINT32  ix;
+
+    intState = K2OSKERN_SetIntr(FALSE);
+
+    //
+    // one 4MB chunk is four 1MB sections
+    //
+    for (ix = 0; ix < 4; ix++)
+    {
+        apPDE[ix] = aPDE;
+        if (aPDE != 0)
+            aPDE += A32_TTBE_SECTION_BYTES;
+    }
+    A32_DSB();
+
+    K2OS_CacheOperation(K2OS_CACHEOP_FlushData, NULL, 0);
+    A32_TLBInvalidateAll_UP();
+    K2OS_CacheOperation(K2OS_CACHEOP_InvalidateInstructions, NULL, 0);
+    A32_ISB();
+
+    K2OSKERN_SetIntr(intState);
+}
+
+BOOL KernArch_IsLargePDE(UINT32 aPDE)
+{
+    return ((aPDE & A32_TTBE_SECTION_TYPE_MASK) == A32_TTBE_SECTION_PRESENT) ? TRUE : FALSE;
+}
+
+UINT32 KernArch_LargePDEToPTE(UINT32 aPDE, UINT32 aVirtAddr)
+{
+    UINT32 pte;
+
+    //
+    // aPDE is the first of the four sections in the 4MB chunk. undo what
+    // KernArch_MakeLargePDE did to get the small page entry for aVirtAddr
+    //
+    pte = A32_PTE_PRESENT;
+    pte |= ((aPDE & A32_TTBE_SECTION_PHYSADDR_MASK) + (aVirtAddr & (K2_VA32_PAGETABLE_MAP_BYTES - 1))) & A32_PTE_PAGEPHYS_MASK;
+    pte |= aPDE & (A32_PTE_B | A32_PTE_C);
+    if (aPDE & A32_TTBE_SECTION_EXEC_NEVER)
+        pte |= A32_PTE_EXEC_NEVER;
+    pte |= (aPDE >> 6) & (A32_PTE_AP_MASK | A32_PTE_TEX_MASK | A32_PTE_SHARED | A32_PTE_NOT_GLOBAL);
+
+    return pte;
+}
+
 UINT32 * KernArch_Translate(K2OSKERN_OBJ_PROCESS *apProc, UINT32 aVirtAddr, UINT32 *apRetPDE, BOOL *apRetPtPresent, UINT32 *apRetPte, UINT32 *apRetMemPageAttr)
 {
     UINT32          transBase;
@@ -304,37 +393,52 @@ UINT32 * KernArch_Translate(K2OSKERN_OBJ_PROCESS *apProc, UINT32 aVirtAddr, UINT
 
     chk = pQuad->Quad[0];
     *apRetPDE = chk.mAsUINT32;
-    if (chk.PTBits.mPresent == 0)
-    {
-        *apRetPtPresent = FALSE;
-        return NULL;
-    }
-    K2_ASSERT((chk.mAsUINT32 + 0x400) == pQuad->Quad[1].mAsUINT32);
-    K2_ASSERT((chk.mAsUINT32 + 0x800) == pQuad->Quad[2].mAsUINT32);
-    K2_ASSERT((chk.mAsUINT32 + 0xC00) == pQuad->Quad[3].mAsUINT32);
-
-    *apRetPtPresent = TRUE;
     *apRetMemPageAttr = 0;
 
-    if (aVirtAddr >= K2OS_KVA_KERN_BASE)
+    if (KernArch_IsLargePDE(chk.mAsUINT32))
     {
-        pPTE = ((UINT32*)K2OS_KVA_TO_PTE_ADDR(aVirtAddr));
-
-        *apRetMemPageAttr |= K2OS_MEMPAGE_ATTR_KERNEL;
+        //
+        // no pagetable. report the pte the large page implies for this address
+        //
+        *apRetPtPresent = TRUE;
+        if (aVirtAddr >= K2OS_KVA_KERN_BASE)
+            *apRetMemPageAttr |= K2OS_MEMPAGE_ATTR_KERNEL;
+        pPTE = NULL;
+        *apRetPte = pte = KernArch_LargePDEToPTE(chk.mAsUINT32, aVirtAddr);
     }
     else
     {
-        //
-        // this may get called before proc0 is set up. so if we are called with proc 0
-        // we just use the kernel va map base as that is the same thing.
-        //
-        if (apProc == gpProc0)
+        if (chk.PTBits.mPresent == 0)
+        {
+            *apRetPtPresent = FALSE;
+            return NULL;
+        }
+        K2_ASSERT((chk.mAsUINT32 + 0x400) == pQuad->Quad[1].mAsUINT32);
+        K2_ASSERT((chk.mAsUINT32 + 0x800) == pQuad->Quad[2].mAsUINT32);
+        K2_ASSERT((chk.mAsUINT32 + 0xC00) == pQuad->Quad[3].mAsUINT32);
+
+        *apRetPtPresent = TRUE;
+
+        if (aVirtAddr >= K2OS_KVA_KERN_BASE)
+        {
             pPTE = ((UINT32*)K2OS_KVA_TO_PTE_ADDR(aVirtAddr));
+
+            *apRetMemPageAttr |= K2OS_MEMPAGE_ATTR_KERNEL;
+        }
         else
-            pPTE = ((UINT32*)K2_VA32_TO_PTE_ADDR(apProc->mVirtMapKVA, aVirtAddr));
-    }
+        {
+            //
+            // this may get called before proc0 is set up. so if we are called with proc 0
+            // we just use the kernel va map base as that is the same thing.
+            //
+            if (apProc == gpProc0)
+                pPTE = ((UINT32*)K2OS_KVA_TO_PTE_ADDR(aVirtAddr));
+            else
+                pPTE = ((UINT32*)K2_VA32_TO_PTE_ADDR(apProc->mVirtMapKVA, aVirtAddr));
+        }
 
-    *apRetPte = pte = *pPTE;
+        *apRetPte = pte = *pPTE;
+    }
 
     memProp = (A32_MMU_PTE_TEX_111 | A32_PTE_B | A32_PTE_C) & pte;
 
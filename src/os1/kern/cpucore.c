@@ -45,6 +45,10 @@ static void sInit_AtDlxEntry(void)
         pCore = K2OSKERN_COREIX_TO_CPUCORE(coreIx);
         K2MEM_Zero((void *)pCore, sizeof(K2OSKERN_CPUCORE));
         pCore->mCoreIx = coreIx;
+        K2OSKERN_SeqIntrInit((K2OSKERN_SEQLOCK *)&pCore->PhysCacheSeqLock);
+        K2LIST_Init((K2LIST_ANCHOR *)&pCore->PhysCache_Clean);
+        K2LIST_Init((K2LIST_ANCHOR *)&pCore->PhysCache_Dirty);
+        K2LIST_Init((K2LIST_ANCHOR *)&pCore->PtPool);
         K2_CpuWriteBarrier();
     }
 }
@@ -92,36 +92,20 @@ K2OSKERN_MapDevice(
             //
             // map the device pages to the virtual range just created
             //
-            chunkLeft = KERN_MEMMAP_CHUNK;
             virtAddr = pSeg->ProcSegTreeNode.mUserVal;
 
-            disp = K2OSKERN_SeqIntrLock(&gData.KernVirtMapLock);
-
             do {
-                KernMap_MakeOnePresentPage(
-                    K2OS_KVA_KERNVAMAP_BASE,
-                    virtAddr,
-                    aPhysDeviceAddr,
-                    K2OS_MAPTYPE_KERN_DEVICEIO);
-                virtAddr += K2_VA32_MEMPAGE_BYTES;
-                aPhysDeviceAddr += K2_VA32_MEMPAGE_BYTES;
-
-                if (--aPageCount == 0)
-                    break;
-
-                if (--chunkLeft == 0)
-                {
-                    if (aPageCount > 1)
-                    {
-                        K2OSKERN_SeqIntrUnlock(&gData.KernVirtMapLock, disp);
-                        disp = K2OSKERN_SeqIntrLock(&gData.KernVirtMapLock);
-                        chunkLeft = KERN_MEMMAP_CHUNK;
-                    }
-                }
-
-            } while (1);
-
-            K2OSKERN_SeqIntrUnlock(&gData.KernVirtMapLock, disp);
+                chunkLeft = (aPageCount < KERN_MEMMAP_CHUNK) ? aPageCount : KERN_MEMMAP_CHUNK;
+
+                disp = K2OSKERN_SeqIntrLock(&gData.KernVirtMapLock);
+                KernMap_MapRange(K2OS_KVA_KERNVAMAP_BASE, virtAddr, chunkLeft, aPhysDeviceAddr, NULL, K2OS_MAPTYPE_KERN_DEVICEIO);
+                K2OSKERN_SeqIntrUnlock(&gData.KernVirtMapLock, disp);
+
+                virtAddr += chunkLeft * K2_VA32_MEMPAGE_BYTES;
+                aPhysDeviceAddr += chunkLeft * K2_VA32_MEMPAGE_BYTES;
+                aPageCount -= chunkLeft;
+
+            } while (aPageCount > 0);
         }
         else
         {
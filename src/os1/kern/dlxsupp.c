@@ -130,10 +130,7 @@ void KernDlxSupp_AtReInit(DLX *apDlx, UINT32 aModulePageLinkAddr, K2DLXSUPP_HOST
 
 UINT32 KernDlx_FindClosestSymbol(K2OSKERN_OBJ_PROCESS *apCurProc, UINT32 aAddr, char *apRetSymName, UINT32 aRetSymNameBufLen)
 {
-    BOOL                    disp;
-    K2TREE_NODE *           pTreeNode;
     K2OSKERN_OBJ_SEGMENT *  pSeg;
-    K2STAT                  stat;
     K2OSKERN_OBJ_DLX *      pDlxObj;
     char const *            pStockStr;
     UINT32                  symAddr;
@@ -142,58 +139,14 @@ UINT32 KernDlx_FindClosestSymbol(K2OSKERN_OBJ_PROCESS *apCurProc, UINT32 aAddr,
     if (aAddr >= K2OS_KVA_KERN_BASE)
         apCurProc = gpProc0;
 
-    disp = K2OSKERN_SeqIntrLock(&apCurProc->SegTreeSeqLock);
+    pSeg = KernMem_SegTreeFindAndRef(apCurProc, aAddr);
 
-    pTreeNode = K2TREE_FindOrAfter(&apCurProc->SegTree, aAddr);
-    if (pTreeNode == NULL)
-    {
-        pTreeNode = K2TREE_LastNode(&apCurProc->SegTree);
-        pTreeNode = K2TREE_PrevNode(&apCurProc->SegTree, pTreeNode);
-        if (pTreeNode != NULL)
-        {
-            pSeg = K2_GET_CONTAINER(K2OSKERN_OBJ_SEGMENT, pTreeNode, ProcSegTreeNode);
-            K2_ASSERT(pSeg->ProcSegTreeNode.mUserVal < aAddr);
-        }
-        else
-        {
-            K2_ASSERT(apCurProc->SegTree.mNodeCount == 0);
-            pSeg = NULL;
-        }
-    }
-    else
-    {
-        if (pTreeNode->mUserVal != aAddr)
-        {
-            pTreeNode = K2TREE_PrevNode(&apCurProc->SegTree, pTreeNode);
-            if (pTreeNode != NULL)
-            {
-                pSeg = K2_GET_CONTAINER(K2OSKERN_OBJ_SEGMENT, pTreeNode, ProcSegTreeNode);
-                K2_ASSERT(pSeg->ProcSegTreeNode.mUserVal < aAddr);
-            }
-            else
-            {
-                pSeg = NULL;
-            }
-        }
-        else
-        {
-            pSeg = K2_GET_CONTAINER(K2OSKERN_OBJ_SEGMENT, pTreeNode, ProcSegTreeNode);
-        }
-    }
+    symAddr = 0;
 
     if (pSeg != NULL)
     {
-        stat = K2OSKERN_AddRefObject(&pSeg->Hdr);
-        K2_ASSERT(!K2STAT_IS_ERROR(stat));
-        symAddr = aAddr;
-    }
-
-    K2OSKERN_SeqIntrUnlock(&apCurProc->SegTreeSeqLock, disp);
-
-    symAddr = pSeg->ProcSegTreeNode.mUserVal;
+        symAddr = pSeg->ProcSegTreeNode.mUserVal;
 
-    if (pSeg != NULL)
-    {
         pStockStr = NULL;
 
         //
@@ -244,6 +197,9 @@ UINT32 KernDlx_FindClosestSymbol(K2OSKERN_OBJ_PROCESS *apCurProc, UINT32 aAddr,
         case K2OSKERN_SEG_ATTR_TYPE_CONTIG_PHYS:
             pStockStr = "CONTIG_PHYS";
             break;
+        case K2OSKERN_SEG_ATTR_TYPE_LENT:
+            pStockStr = "LENT";
+            break;
         default:
             K2_ASSERT(0);
             break;
@@ -379,6 +335,32 @@ K2STAT KernDlxSupp_ReadSectors(void *apAcqContext, K2DLXSUPP_HOST_FILE aHostFile
     return stat;
 }
 
+K2STAT KernDlxSupp_ReadSectorsAsync(void *apAcqContext, K2DLXSUPP_HOST_FILE aHostFile, K2DLXSUPP_READ *apRead)
+{
+    K2OSKERN_OBJ_DLX *  pDlx;
+    K2STAT              stat;
+
+    //
+    // exec reads complete when they are started. if the provider has the file
+    // resident we get a pointer to the data and the loader copies it out
+    //
+    pDlx = (K2OSKERN_OBJ_DLX *)aHostFile;
+    apRead->mpHostData = NULL;
+    if (gData.mfExecStartReadDlx != NULL)
+        stat = gData.mfExecStartReadDlx(pDlx->mTokFile, apRead->mpBuffer, pDlx->mCurSector, apRead->mSectorCount, &apRead->mpHostData);
+    else
+        stat = gData.mfExecReadDlx(pDlx->mTokFile, apRead->mpBuffer, pDlx->mCurSector, apRead->mSectorCount);
+    apRead->mHostContext = (UINT32)stat;
+    if (!K2STAT_IS_ERROR(stat))
+        pDlx->mCurSector += apRead->mSectorCount;
+    return stat;
+}
+
+K2STAT KernDlxSupp_ReadComplete(void *apAcqContext, K2DLXSUPP_HOST_FILE aHostFile, K2DLXSUPP_READ *apRead)
+{
+    return (K2STAT)apRead->mHostContext;
+}
+
 K2STAT 
 KernDlxSupp_Prepare(
     void *                  apAcqContext,
@@ -394,6 +376,7 @@ KernDlxSupp_Prepare(
     K2OSKERN_OBJ_DLX *      pDlxObj;
     UINT32                  segIx;
     UINT32                  allocSize;
+    UINT32                  preferAddr;
     K2OSKERN_OBJ_SEGMENT *  pSeg;
 
     pDlxObj = (K2OSKERN_OBJ_DLX *)aHostFile;
@@ -429,7 +412,15 @@ KernDlxSupp_Prepare(
             pSeg->Info.DlxPart.mSegmentIndex = segIx;
             K2MEM_Copy(&pSeg->Info.DlxPart.DlxSegmentInfo, &apInfo->SegInfo[segIx], sizeof(DLX_SEGMENT_INFO));
 
-            stat = KernMem_AllocMapAndCreateSegment(pSeg);
+            //
+            // a prelinked dlx skips relocation if it lands at its link addresses
+            //
+            preferAddr = apInfo->SegInfo[segIx].mLinkAddr;
+            if ((preferAddr < K2OS_KVA_KERN_BASE) ||
+                (preferAddr & K2_VA32_MEMPAGE_OFFSET_MASK))
+                preferAddr = 0;
+
+            stat = KernMem_AllocMapAndCreateSegmentAt(pSeg, preferAddr);
             if (K2STAT_IS_ERROR(stat))
             {
                 K2MEM_Zero(pSeg, sizeof(K2OSKERN_OBJ_SEGMENT));
@@ -699,6 +690,183 @@ K2STAT KernDlxSupp_ErrorPoint(char const *apFile, int aLine, K2STAT aStatus)
     return aStatus;
 }
 
+void * KernDlxSupp_AllocScratch(void *apAcqContext, UINT32 aBytes)
+{
+    return K2OS_HeapAlloc(aBytes);
+}
+
+void KernDlxSupp_FreeScratch(void *apAcqContext, void *apMem)
+{
+    BOOL ok;
+    ok = K2OS_HeapFree(apMem);
+    K2_ASSERT(ok);
+}
+
+//
+// parallel linking is off until the per-module load stats show it pays for
+// the thread handoffs on real boots. when on, the helper threads are made 
+// on first use and then kept, parked on their own events, for every load
+// after that
+//
+#define KERNDLX_PARALLEL_LINK   0
+
+typedef struct _KERNDLX_PARALLEL KERNDLX_PARALLEL;
+struct _KERNDLX_PARALLEL
+{
+    void *                      mpAcqContext;
+    pfK2DLXSUPP_ParallelWork    mfWork;
+    void *                      mpArg;
+    UINT32                      mCount;
+    INT32 volatile              mNextIx;
+    INT32 volatile              mHelpersLeft;
+};
+
+typedef struct _KERNDLX_POOL KERNDLX_POOL;
+struct _KERNDLX_POOL
+{
+    BOOL                        mTriedCreate;
+    UINT32                      mHelperCount;
+    K2OS_TOKEN                  mTokDone;
+    K2OS_TOKEN                  mTokGo[K2OS_MAX_CPU_COUNT];
+    KERNDLX_PARALLEL * volatile mpJob;
+};
+
+static KERNDLX_POOL sgDlxPool;
+
+K2_STATIC void sParallelWork(KERNDLX_PARALLEL *apPar)
+{
+    UINT32 ix;
+
+    do {
+        ix = (UINT32)K2ATOMIC_AddExchange(&apPar->mNextIx, 1);
+        if (ix >= apPar->mCount)
+            break;
+        apPar->mfWork(apPar->mpAcqContext, apPar->mpArg, ix);
+    } while (1);
+}
+
+static UINT32 K2_CALLCONV_REGS sParallelWorker(void *apArg)
+{
+    K2OS_TOKEN          tokGo;
+    KERNDLX_PARALLEL *  pPar;
+
+    tokGo = sgDlxPool.mTokGo[(UINT32)apArg];
+
+    do {
+        K2OS_ThreadWait(1, &tokGo, FALSE, K2OS_TIMEOUT_INFINITE);
+
+        pPar = sgDlxPool.mpJob;
+        K2_ASSERT(pPar != NULL);
+
+        sParallelWork(pPar);
+
+        if (1 == K2ATOMIC_AddExchange(&pPar->mHelpersLeft, -1))
+            K2OS_EventSet(sgDlxPool.mTokDone);
+
+    } while (1);
+
+    return 0;
+}
+
+K2_STATIC void sCreatePool(void)
+{
+    K2OS_THREADCREATE   cret;
+    K2OS_TOKEN          tokThread;
+    UINT32              ix;
+
+    //
+    // DLX critical section is held. one helper per extra cpu. if any part of this 
+    // fails we just run with the helpers we got, which may be none
+    //
+    sgDlxPool.mTriedCreate = TRUE;
+
+    if (gData.mCpuCount < 2)
+        return;
+
+    sgDlxPool.mTokDone = K2OS_EventCreate(NULL, TRUE, FALSE);
+    if (sgDlxPool.mTokDone == NULL)
+        return;
+
+    K2MEM_Zero(&cret, sizeof(cret));
+    cret.mStructBytes = sizeof(cret);
+    cret.mEntrypoint = sParallelWorker;
+
+    for (ix = 0; ix < gData.mCpuCount - 1; ix++)
+    {
+        sgDlxPool.mTokGo[ix] = K2OS_EventCreate(NULL, TRUE, FALSE);
+        if (sgDlxPool.mTokGo[ix] == NULL)
+            break;
+
+        cret.mpArg = (void *)ix;
+        tokThread = K2OS_ThreadCreate(&cret);
+        if (tokThread == NULL)
+        {
+            K2OS_TokenDestroy(sgDlxPool.mTokGo[ix]);
+            sgDlxPool.mTokGo[ix] = NULL;
+            break;
+        }
+
+        //
+        // thread holds its own reference
+        //
+        K2OS_TokenDestroy(tokThread);
+    }
+
+    sgDlxPool.mHelperCount = ix;
+}
+
+void KernDlxSupp_RunParallel(void *apAcqContext, pfK2DLXSUPP_ParallelWork afWork, void *apArg, UINT32 aCount)
+{
+    KERNDLX_PARALLEL    par;
+    UINT32              helperCount;
+    UINT32              ix;
+    UINT32              waitResult;
+
+    //
+    // the DLX critical section is held for the whole acquire, so there is
+    // only ever one job going through the pool at a time
+    //
+    if (!sgDlxPool.mTriedCreate)
+        sCreatePool();
+
+    par.mpAcqContext = apAcqContext;
+    par.mfWork = afWork;
+    par.mpArg = apArg;
+    par.mCount = aCount;
+    par.mNextIx = 0;
+
+    //
+    // this thread does work as well, so only wake helpers for the rest
+    //
+    helperCount = (aCount > 0) ? aCount - 1 : 0;
+    if (helperCount > sgDlxPool.mHelperCount)
+        helperCount = sgDlxPool.mHelperCount;
+
+    par.mHelpersLeft = (INT32)helperCount;
+
+    if (helperCount > 0)
+    {
+        sgDlxPool.mpJob = &par;
+        for (ix = 0; ix < helperCount; ix++)
+            K2OS_EventSet(sgDlxPool.mTokGo[ix]);
+    }
+
+    sParallelWork(&par);
+
+    if (helperCount > 0)
+    {
+        waitResult = K2OS_ThreadWait(1, &sgDlxPool.mTokDone, FALSE, K2OS_TIMEOUT_INFINITE);
+        K2_ASSERT(waitResult == K2OS_WAIT_SIGNALLED_0);
+        K2_ASSERT(par.mHelpersLeft == 0);
+        sgDlxPool.mpJob = NULL;
+    }
+}
+
+UINT64 KernDlxSupp_GetTime(void)
+{
+    return K2OS_SysUpTimeMs();
+}
+
 K2_STATIC void sAddOneBuiltinDlx(K2OSKERN_OBJ_DLX *apDlxObj)
 {
     K2STAT stat;
@@ -733,6 +901,16 @@ K2_STATIC void sSetupThreaded(void)
     gData.DlxHost.RefChange = KernDlxSupp_RefChange;
     gData.DlxHost.Purge = KernDlxSupp_Purge;
     gData.DlxHost.ErrorPoint = KernDlxSupp_ErrorPoint;
+    gData.DlxHost.AllocScratch = KernDlxSupp_AllocScratch;
+    gData.DlxHost.FreeScratch = KernDlxSupp_FreeScratch;
+    gData.DlxHost.ReadSectorsAsync = KernDlxSupp_ReadSectorsAsync;
+    gData.DlxHost.ReadComplete = KernDlxSupp_ReadComplete;
+#if KERNDLX_PARALLEL_LINK
+    gData.DlxHost.RunParallel = KernDlxSupp_RunParallel;
+#else
+    gData.DlxHost.RunParallel = NULL;
+#endif
+    gData.DlxHost.GetTime = KernDlxSupp_GetTime;
 
     stat = K2DLXSUPP_Init((void *)K2OS_KVA_LOADERPAGE_BASE, &gData.DlxHost, TRUE, TRUE);
     K2_ASSERT(!K2STAT_IS_ERROR(stat));
@@ -756,6 +934,51 @@ void KernInit_Dlx(void)
     }
 }
 
+K2_STATIC char const * const sgpLoadPhaseName[DlxLoadPhase_Count] =
+{
+    "OPEN",
+    "HDRREAD",
+    "SEGREAD",
+    "CRC",
+    "RELOC",
+    "IMPORT",
+    "CALLBACK"
+};
+
+K2_STATIC char const * const sgpRelocStatName[DlxRelocStat_Count] =
+{
+    "GRP ABS32",
+    "GRP PC32",
+    "ABS32",
+    "PC32",
+    "BRANCH",
+    "MOVW",
+    "MOVT",
+    "PREL31"
+};
+
+K2_STATIC void sDumpLoadStats(DLX *apDlx)
+{
+    DLX_LOAD_STATS  stats;
+    K2STAT          stat;
+    UINT32          ix;
+
+    // builtin dlx were loaded by the os loader, which has no clock, so only
+    // their counts are filled in
+    stat = DLX_GetLoadStats(apDlx, &stats);
+    if (K2STAT_IS_ERROR(stat))
+        return;
+
+    for (ix = 0; ix < DlxLoadPhase_Count; ix++)
+        K2OSKERN_Debug("  %-8s %6dms\n", sgpLoadPhaseName[ix], (UINT32)stats.mPhaseTime[ix]);
+    for (ix = 0; ix < DlxRelocStat_Count; ix++)
+    {
+        if (stats.mRelocCount[ix] > 0)
+            K2OSKERN_Debug("  %-9s %6d\n", sgpRelocStatName[ix], stats.mRelocCount[ix]);
+    }
+    K2OSKERN_Debug("  IMPORTS  %d fast, %d slow\n", stats.mFastImportCount, stats.mSlowImportCount);
+}
+
 K2_STATIC void sDumpOneDlx(K2OSKERN_OBJ_DLX * apDlxObj)
 {
     UINT32 segIx;
@@ -770,6 +993,8 @@ K2_STATIC void sDumpOneDlx(K2OSKERN_OBJ_DLX * apDlxObj)
         if (apDlxObj->SegObj[segIx].mPagesBytes > 0)
             K2OSKERN_Debug("  SEG[%d]  %08X\n", segIx, &apDlxObj->SegObj[segIx]);
     }
+    if (apDlxObj->mpDlx != NULL)
+        sDumpLoadStats(apDlxObj->mpDlx);
 }
 
 void KernDlx_Dump(void)
@@ -746,6 +746,8 @@ static void sAddSegmentToTree(K2OSKERN_OBJ_SEGMENT *apSeg)
     virtAddr = apSeg->ProcSegTreeNode.mUserVal;
     pageCount = apSeg->mPagesBytes / K2_VA32_MEMPAGE_BYTES;
 
+    gpProc0->MemStats.mCommittedPages += pageCount;
+
     if ((apSeg->mSegAndMemPageAttr & K2OSKERN_SEG_ATTR_TYPE_MASK) == K2OSKERN_SEG_ATTR_TYPE_THREAD)
     {
         // bottom-most page is a guard page
@@ -765,8 +767,11 @@ static void sAddSegmentToTree(K2OSKERN_OBJ_SEGMENT *apSeg)
         pPhysPage = (K2OSKERN_PHYSTRACK_PAGE *)K2OS_PHYS32_TO_PHYSTRACK(pte & K2_VA32_PAGEFRAME_MASK);
         K2_ASSERT((pPhysPage->mFlags & K2OSKERN_PHYSTRACK_UNALLOC_FLAG) == 0);
         pPhysPage->mpOwnerObject = (void *)apSeg;
+        gpProc0->MemStats.mResidentPages++;
         virtAddr += K2_VA32_MEMPAGE_BYTES;
     } while (--pageCount);
+
+    gpProc0->MemStats.mResidentPagesHigh = gpProc0->MemStats.mResidentPages;
 }
 
 static void sInitMapDlxSegments(K2OSKERN_OBJ_DLX *apDlxObj)
@@ -127,6 +127,31 @@ sBuiltin_Read(
     return K2STAT_NO_ERROR;
 }
 
+static 
+K2STAT 
+sBuiltin_Map(
+    FSPROV_OPAQUE   aFile, 
+    UINT32          aSectorOffset,
+    UINT32          aSectorCount,
+    void const **   appRetData
+)
+{
+    K2ROFS_FILE const * pFile;
+    UINT32              fileSectors;
+
+    pFile = (K2ROFS_FILE const *)aFile;
+
+    fileSectors = K2_ROUNDUP(pFile->mSizeBytes, K2ROFS_SECTOR_BYTES) / K2ROFS_SECTOR_BYTES;
+
+    if ((aSectorOffset >= fileSectors) ||
+        ((fileSectors - aSectorOffset) < aSectorCount))
+        return K2STAT_ERROR_BAD_ARGUMENT;
+
+    *appRetData = K2ROFS_FILEDATA(sgpRofs, pFile) + (aSectorOffset * K2ROFS_SECTOR_BYTES);
+
+    return K2STAT_NO_ERROR;
+}
+
 static 
 K2STAT 
 sBuiltin_Close(
@@ -142,7 +167,8 @@ gFsProv_Builtin_Direct =
     K2OSEXEC_FSPROV_CURRENT_VERSION,
     sBuiltin_Open,
     sBuiltin_Read,
-    sBuiltin_Close
+    sBuiltin_Close,
+    sBuiltin_Map
 };
 
 void 
@@ -220,6 +220,50 @@ sReadDlx(
     return stat;
 }
 
+static
+K2STAT
+sStartReadDlx(
+    K2OS_TOKEN      aTokDlxFile,
+    void *          apBuffer,
+    UINT32          aStartSector,
+    UINT32          aSectorCount,
+    void const **   appRetData
+)
+{
+    K2STAT              stat;
+    K2STAT              stat2;
+    FSPROV_OBJ_FILE *   pFileObj;
+
+    *appRetData = NULL;
+
+    stat = K2OSKERN_TranslateTokensToAddRefObjs(1, &aTokDlxFile, (K2OSKERN_OBJ_HEADER **)&pFileObj);
+    if (K2STAT_IS_ERROR(stat))
+        return stat;
+
+    if (pFileObj->Hdr.mObjType != K2OS_Obj_File)
+    {
+        stat = K2STAT_ERROR_BAD_ARGUMENT;
+    }
+    else if ((pFileObj->mpProvDirect->mVersion >= K2OSEXEC_FSPROV_MAP_VERSION) &&
+             (pFileObj->mpProvDirect->Map != NULL))
+    {
+        //
+        // file is resident - hand back where the data is so the loader
+        // can copy it while it does the crc instead of us copying it here
+        //
+        stat = pFileObj->mpProvDirect->Map(pFileObj->mOpaque, aStartSector, aSectorCount, appRetData);
+    }
+    else
+    {
+        stat = pFileObj->mpProvDirect->Read(pFileObj->mOpaque, apBuffer, aStartSector, aSectorCount);
+    }
+
+    stat2 = K2OSKERN_ReleaseObject(&pFileObj->Hdr);
+    K2_ASSERT(!K2STAT_IS_ERROR(stat2));
+
+    return stat;
+}
+
 static
 K2STAT
 sDoneDlx(
@@ -263,4 +307,5 @@ void FsProv_Init(K2OSEXEC_INIT_INFO * apInitInfo)
     apInitInfo->OpenDlx = sOpenDlx;
     apInitInfo->ReadDlx = sReadDlx;
     apInitInfo->DoneDlx = sDoneDlx;
+    apInitInfo->StartReadDlx = sStartReadDlx;
 }
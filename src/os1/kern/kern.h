@@ -197,6 +197,27 @@ struct _K2OSKERN_SCHED_CPUCORE
     UINT32                  mExecFlags;
 };
 
+typedef struct _K2OSKERN_PTPOOL_STATS K2OSKERN_PTPOOL_STATS;
+struct _K2OSKERN_PTPOOL_STATS
+{
+    UINT32  mAllocs;        // pagetable pages handed out to threads on this core
+    UINT32  mPoolHits;      // of those, how many came straight off the core's pool
+    UINT32  mRefills;       // times the pool was topped up from the free clean list
+    UINT32  mRecycled;      // emptied or unused pagetable pages kept in the pool
+    UINT32  mReleased;      // pagetable pages given back because the pool was full
+};
+
+//
+// small virtual ranges freed on a core stay allocated in the virtual heap and are parked
+// on that core so the next allocation of the same size does not go to the heap.  buckets
+// are by power of two page count, and each entry is (base address | page count)
+//
+#define K2OSKERN_VIRTCACHE_MAX_PAGES    16
+#define K2OSKERN_VIRTCACHE_BUCKETS      5
+#define K2OSKERN_VIRTCACHE_SLOTS        4
+
+K2_STATIC_ASSERT(K2OSKERN_VIRTCACHE_MAX_PAGES < K2_VA32_MEMPAGE_BYTES);
+
 struct _K2OSKERN_CPUCORE
 {
 #if K2_TARGET_ARCH_IS_INTEL
@@ -218,6 +239,15 @@ struct _K2OSKERN_CPUCORE
     K2OSKERN_CPUCORE_EVENT * volatile   mpPendingEventListHead;
 
     K2OSKERN_CPUCORE_EVENT volatile     IciFromOtherCore[K2OS_MAX_CPU_COUNT];
+
+    K2OSKERN_SEQLOCK                    PhysCacheSeqLock;   // covers PhysCache_* and PtPool. owner core takes it uncontended
+    K2LIST_ANCHOR                       PhysCache_Clean;
+    K2LIST_ANCHOR                       PhysCache_Dirty;
+
+    K2LIST_ANCHOR                       PtPool;
+    K2OSKERN_PTPOOL_STATS               PtPoolStats;
+
+    UINT32                              mVirtCache[K2OSKERN_VIRTCACHE_BUCKETS][K2OSKERN_VIRTCACHE_SLOTS];
 };
 
 #define K2OSKERN_COREPAGE_STACKS_BYTES  (K2_VA32_MEMPAGE_BYTES - sizeof(K2OSKERN_CPUCORE))
@@ -303,7 +333,7 @@ struct _K2OSKERN_SCHED_TIMERITEM
 struct _K2OSKERN_SCHED_WAITENTRY
 {
     UINT8                   mMacroIndex;        /* my index inside my MACROWAIT - allows calc of MACROWAIT address */
-    UINT8                   mUnused1;
+    UINT8                   mWaitPrio;          /* active prio of waiting thread when entry was put on the object's list */
     UINT16                  mStickyPulseStatus;
     K2LIST_LINK             WaitPrioListLink;
     K2OSKERN_OBJ_WAITABLE   mWaitObj;
@@ -603,7 +633,10 @@ struct _K2OSKERN_CRITSEC
     UINT32                  mRecursionCount;
 
     K2OSKERN_OBJ_EVENT      Event;
+
+    K2OSKERN_CRITSEC_STATS  Stats;
 };
+K2_STATIC_ASSERT(sizeof(K2OSKERN_CRITSEC) <= K2OS_CRITSEC_BYTES);
 
 /* --------------------------------------------------------------------------------- */
 
@@ -619,9 +652,24 @@ struct _K2OSKERN_CRITSEC
 #define K2OSKERN_SEG_ATTR_TYPE_CONTIG_PHYS  0x00070000
 #define K2OSKERN_SEG_ATTR_TYPE_DLX_PAGE     0x00080000
 #define K2OSKERN_SEG_ATTR_TYPE_SEG_SLAB     0x00090000
-#define K2OSKERN_SEG_ATTR_TYPE_COUNT        0x000A0000
+#define K2OSKERN_SEG_ATTR_TYPE_LENT         0x000A0000
+#define K2OSKERN_SEG_ATTR_TYPE_COUNT        0x000B0000
 #define K2OSKERN_SEG_ATTR_TYPE_MASK         0x000F0000
 
+//
+// sparse segment whose pages are all committed but only get physical
+// memory when they are first touched.  untouched pages are NP_COMMITTED
+//
+#define K2OSKERN_SEG_ATTR_DEMAND_ZERO       0x00100000
+
+#define K2OSKERN_DEMAND_FAULT_AHEAD         3
+
+//
+// contiguous physical segment whose 4MB-aligned chunks are mapped with
+// a single large directory entry instead of a pagetable where possible
+//
+#define K2OSKERN_SEG_ATTR_LARGE_PAGES       0x00400000
+
 typedef struct _K2OSKERN_SEGMENT_INFO_THREAD K2OSKERN_SEGMENT_INFO_THREAD;
 struct _K2OSKERN_SEGMENT_INFO_THREAD
 {
@@ -666,6 +714,13 @@ struct _K2OSKERN_SEGMENT_INFO_DLX_PAGE
     K2OSKERN_OBJ_DLX *      mpDlxObj;
 };
 
+typedef struct _K2OSKERN_SEGMENT_INFO_LENT K2OSKERN_SEGMENT_INFO_LENT;
+struct _K2OSKERN_SEGMENT_INFO_LENT
+{
+    K2OSKERN_OBJ_SEGMENT *  mpSrcSeg;       // segment that owns the lent pages. referenced while lent
+    UINT32                  mSrcVirtAddr;   // address of first lent page inside mpSrcSeg
+};
+
 typedef union _K2OSKERN_SEGMENT_INFO K2OSKERN_SEGMENT_INFO;
 union _K2OSKERN_SEGMENT_INFO
 {
@@ -676,6 +731,7 @@ union _K2OSKERN_SEGMENT_INFO
     K2OSKERN_SEGMENT_INFO_DEVICEMAP     DeviceMap;
     K2OSKERN_SEGMENT_INFO_CONTIG_PHYS   ContigPhys;
     K2OSKERN_SEGMENT_INFO_USER          User;
+    K2OSKERN_SEGMENT_INFO_LENT          Lent;
 };
 
 struct _K2OSKERN_OBJ_SEGMENT
@@ -816,6 +872,8 @@ struct _K2OSKERN_OBJ_PROCESS
     UINT32                  mTokSalt;
     UINT32                  mTokCount;
 
+    K2OS_PROC_MEMSTATS      MemStats;   // resident and pagetable counts under PhysMemSeqLock
+
     K2LIST_LINK             ProcListLink;
 };
 
@@ -879,6 +937,12 @@ struct _K2OSKERN_OBJ_MSG
     K2OS_MSGIO              Io;
 
     K2OSKERN_OBJ_EVENT      CompletionEvent;
+
+    //
+    // service call buffers lent to the receiver. released when the message goes away
+    //
+    K2OSKERN_OBJ_SEGMENT *  mpInLent;
+    K2OSKERN_OBJ_SEGMENT *  mpOutLent;
 };
 
 /* --------------------------------------------------------------------------------- */
@@ -1186,6 +1250,11 @@ enum _KernPhysPageList
 
     KernPhysPageList_Count,         //  17
 
+    KernPhysPageList_Core_PtPool = 23,        // on a cpu core's zeroed pagetable page pool
+
+    KernPhysPageList_Core_Dirty = 24,         // on a cpu core's free page cache, dirty
+    KernPhysPageList_Core_Clean = 25,         // on a cpu core's free page cache, clean
+
     KernPhysPageList_Thread_Working = 26,     // temporarily set as thread working page
     KernPhysPageList_Thread_PtWorking = 27,   // temporarily set as thread pt working page
     KernPhysPageList_Thread_Dirty  = 28,      // temporarily on thread dirty list
@@ -1324,6 +1393,41 @@ enum _KernInitStage
 
 /* --------------------------------------------------------------------------------- */
 
+//
+// background zeroing keeps the free clean page list between the watermarks
+// by cleaning pages off the free dirty list at low priority
+//
+#define K2OSKERN_PHYSZERO_DEFAULT_LOW_WATER     64
+#define K2OSKERN_PHYSZERO_DEFAULT_HIGH_WATER    1024
+
+typedef struct _K2OSKERN_PHYSZERO K2OSKERN_PHYSZERO;
+struct _K2OSKERN_PHYSZERO
+{
+    UINT32          mLowWater;          // poke the zeroing thread when clean list drops below this
+    UINT32          mHighWater;         // zeroing thread stops when clean list reaches this
+    K2OS_TOKEN      mTokWakeEvent;
+    UINT32 volatile mWakePending;       // nonzero from the poke until the zeroing thread catches up
+    INT32 volatile  mBackgroundCount;   // pages cleaned by the zeroing thread
+    INT32 volatile  mInlineCount;       // pages cleaned on an allocating path
+};
+
+//
+// memory statistics kept up to date as pages move so they can be read without
+// walking anything.  page list counts come straight from the list anchors
+//
+typedef struct _K2OSKERN_MEMSTATS K2OSKERN_MEMSTATS;
+struct _K2OSKERN_MEMSTATS
+{
+    UINT32          mPhysPagesTotal;        // set once when memory is started
+    UINT32          mPhysFreeTreePages;     // pages in PhysFreeTree, under PhysMemSeqLock
+    UINT32          mPhysPagesInUseHigh;    // under PhysMemSeqLock
+    UINT32          mPageTablePages;        // under PhysMemSeqLock
+    UINT32          mPageTablePagesHigh;    // under PhysMemSeqLock
+    UINT32          mHeapTotalAllocHigh;    // under the ramheap lock
+};
+
+K2_STATIC_ASSERT(K2OS_MEMSTATS_PAGELIST_COUNT >= KernPhysPageList_Count);
+
 typedef struct _KERN_DATA KERN_DATA;
 struct _KERN_DATA
 {
@@ -1344,6 +1448,8 @@ struct _KERN_DATA
     K2OSKERN_SEQLOCK                    PhysMemSeqLock;
     K2TREE_ANCHOR                       PhysFreeTree;
     K2LIST_ANCHOR                       PhysPageList[KernPhysPageList_Count];
+    K2OSKERN_PHYSZERO                   PhysZero;
+    K2OSKERN_MEMSTATS                   MemStats;
 
     //
     // virtual memory (allocation, not mapping)
@@ -1401,6 +1507,7 @@ struct _KERN_DATA
     K2OSEXEC_pf_OpenDlx                 mfExecOpenDlx;
     K2OSEXEC_pf_ReadDlx                 mfExecReadDlx;
     K2OSEXEC_pf_DoneDlx                 mfExecDoneDlx;
+    K2OSEXEC_pf_StartReadDlx            mfExecStartReadDlx;
     K2OSKERN_OBJ_SEGMENT *              mpSeg_Builtin_K2ROFS;
 
     // service
@@ -1461,6 +1568,8 @@ K2STAT KernDlxSupp_CritSec(BOOL aEnter);
 K2STAT KernDlxSupp_AcqAlreadyLoaded(void *apAcqContext, K2DLXSUPP_HOST_FILE aHostFile);
 K2STAT KernDlxSupp_Open(void *apAcqContext, char const * apFileSpec, char const *apNamePart, UINT32 aNamePartLen, K2DLXSUPP_OPENRESULT *apRetResult);
 K2STAT KernDlxSupp_ReadSectors(void *apAcqContext, K2DLXSUPP_HOST_FILE aHostFile, void *apBuffer, UINT32 aSectorCount);
+K2STAT KernDlxSupp_ReadSectorsAsync(void *apAcqContext, K2DLXSUPP_HOST_FILE aHostFile, K2DLXSUPP_READ *apRead);
+K2STAT KernDlxSupp_ReadComplete(void *apAcqContext, K2DLXSUPP_HOST_FILE aHostFile, K2DLXSUPP_READ *apRead);
 K2STAT KernDlxSupp_Prepare(void *apAcqContext, K2DLXSUPP_HOST_FILE aHostFile, DLX_INFO *apInfo, UINT32 aInfoSize, BOOL aKeepSymbols, K2DLXSUPP_SEGALLOC *apRetAlloc);
 BOOL   KernDlxSupp_PreCallback(void *apAcqContext, K2DLXSUPP_HOST_FILE aHostFile, BOOL aIsLoad, DLX *apDlx);
 K2STAT KernDlxSupp_PostCallback(void *apAcqContext, K2DLXSUPP_HOST_FILE aHostFile, K2STAT aUserStatus, DLX *apDlx);
@@ -1468,6 +1577,10 @@ K2STAT KernDlxSupp_Finalize(void *apAcqContext, K2DLXSUPP_HOST_FILE aHostFile, K
 K2STAT KernDlxSupp_RefChange(K2DLXSUPP_HOST_FILE aHostFile, DLX *apDlx, INT32 aRefChange);
 K2STAT KernDlxSupp_Purge(K2DLXSUPP_HOST_FILE aHostFile);
 K2STAT KernDlxSupp_ErrorPoint(char const *apFile, int aLine, K2STAT aStatus);
+void * KernDlxSupp_AllocScratch(void *apAcqContext, UINT32 aBytes);
+void   KernDlxSupp_FreeScratch(void *apAcqContext, void *apMem);
+void   KernDlxSupp_RunParallel(void *apAcqContext, pfK2DLXSUPP_ParallelWork afWork, void *apArg, UINT32 aCount);
+UINT64 KernDlxSupp_GetTime(void);
 
 /* --------------------------------------------------------------------------------- */
 
@@ -1487,6 +1600,11 @@ K2STAT KernMem_SegAllocToThread(K2OSKERN_OBJ_THREAD *apCurThread);
 K2STAT KernMem_SegFreeFromThread(K2OSKERN_OBJ_THREAD *apCurThread);
 void   KernMem_SegDispose(K2OSKERN_OBJ_HEADER *apObjHdr);
 
+void   KernMem_StartZeroThread(void);
+
+void   KernMem_StatsPageTable(K2OSKERN_OBJ_PROCESS *apUserProc, BOOL aAdded);
+void   KernMem_GetStats(K2OS_MEMSTATS *apRetStats);
+
 K2STAT KernMem_CreateSegmentFromThread(K2OSKERN_OBJ_THREAD *apCurThread, K2OSKERN_OBJ_SEGMENT *apSrc, K2OSKERN_OBJ_SEGMENT *apDst);
 
 K2STAT KernMem_MapSegPagesFromThread(K2OSKERN_OBJ_THREAD *apCurThread, K2OSKERN_OBJ_SEGMENT *apSrc, UINT32 aSegOffset, UINT32 aPageCount, UINT32 aPageAttrFlags);
@@ -1494,7 +1612,14 @@ void   KernMem_UnmapSegPagesToThread(K2OSKERN_OBJ_THREAD *apCurThread, K2OSKERN_
 
 K2STAT KernMem_MapContigPhys(UINT32 aContigPhysAddr, UINT32 aPageCount, UINT32 aSegAndMemPageAttr, K2OSKERN_OBJ_SEGMENT ** appRetSeg);
 
+K2STAT KernMem_LendPages(UINT32 aSrcVirtAddr, UINT32 aPageCount, BOOL aWriteable, K2OSKERN_OBJ_SEGMENT ** appRetSeg);
+
+K2OSKERN_OBJ_SEGMENT * KernMem_SegTreeFindAndRef(K2OSKERN_OBJ_PROCESS *apProc, UINT32 aVirtAddr);
+
+BOOL   KernMem_ServiceDemandFault(UINT32 aFaultAddr);
+
 K2STAT KernMem_AllocMapAndCreateSegment(K2OSKERN_OBJ_SEGMENT *apSeg);
+K2STAT KernMem_AllocMapAndCreateSegmentAt(K2OSKERN_OBJ_SEGMENT *apSeg, UINT32 aPreferAddr);
 
 void   KernMem_DumpVM(void);
 
@@ -1513,10 +1638,24 @@ BOOL   KernMap_SegRangeMapped(K2OSKERN_OBJ_THREAD *apCurThread, K2OSKERN_OBJ_SEG
 
 void   KernMap_FindMapped(K2OSKERN_OBJ_THREAD *apCurThread, UINT32 aVirtAddr, UINT32 aPageCount, UINT32 *apScanIx, UINT32 *apFoundCount);
 
+// range versions walk the pagetables once and do cache maintenance once per pagetable touched
+void   KernMap_MapRange(UINT32 aVirtMapBase, UINT32 aVirtAddr, UINT32 aPageCount, UINT32 aPhysAddr, UINT32 const *apPhysList, UINT32 aPageMapAttr);
+void   KernMap_UnmapRange(K2OSKERN_OBJ_THREAD *apCurThread, UINT32 aVirtAddr, UINT32 aPageCount, UINT32 aNpFlags, UINT32 *apRetPhysList);
+
+BOOL   KernMap_MakeLargePage(UINT32 aVirtAddr, UINT32 aPhysAddr, UINT32 aPageMapAttr);
+UINT32 KernMap_UnmapLargePage(UINT32 aVirtAddr);
+void   KernMap_BreakLargePage(K2OSKERN_OBJ_THREAD *apCurThread, UINT32 aVirtAddr);
+BOOL   KernMap_IsLargePage(UINT32 aVirtAddr);
+
 /* --------------------------------------------------------------------------------- */
 
 UINT32  KernArch_MakePTE(UINT32 aPhysAddr, UINT32 aPageMapAttr);
 void    KernArch_WritePTE(BOOL aIsMake, UINT32 aVirtAddr, UINT32* pPTE, UINT32 aPTE);
+void    KernArch_FlushPTERange(UINT32 aVirtAddr, UINT32 *apFirstPTE, UINT32 aPteCount);
+UINT32  KernArch_MakeLargePDE(UINT32 aPhysAddr, UINT32 aPageMapAttr);
+void    KernArch_WriteLargePDE(UINT32 *apPDE, UINT32 aPDE);
+BOOL    KernArch_IsLargePDE(UINT32 aPDE);
+UINT32  KernArch_LargePDEToPTE(UINT32 aPDE, UINT32 aVirtAddr);
 void    KernArch_BreakMapTransitionPageTable(UINT32 *apRetVirtAddrPT, UINT32 *apRetPhysAddrPT);
 void    KernArch_InvalidateTlbPageOnThisCore(UINT32 aVirtAddr);
 BOOL    KernArch_VerifyPteKernHasAccessAttr(UINT32 aPTE, UINT32 aMustHaveAttr);
@@ -78,6 +78,16 @@ K2STAT
     UINT32      aSectorCount
     );
 
+typedef
+K2STAT
+(*K2OSEXEC_pf_StartReadDlx)(
+    K2OS_TOKEN      aTokDlxFile,
+    void *          apBuffer,
+    UINT32          aStartSector,
+    UINT32          aSectorCount,
+    void const **   appRetData
+    );
+
 typedef
 K2STAT
 (*K2OSEXEC_pf_DoneDlx)(
@@ -102,6 +112,7 @@ struct _K2OSEXEC_INIT_INFO
     K2OSEXEC_pf_OpenDlx     OpenDlx;
     K2OSEXEC_pf_ReadDlx     ReadDlx;
     K2OSEXEC_pf_DoneDlx     DoneDlx;
+    K2OSEXEC_pf_StartReadDlx StartReadDlx;
 };
 
 typedef
@@ -34,6 +34,15 @@
 
 #define DIAG_MAPPING    1
 
+static UINT32 * sGetKernPDE(UINT32 *apTransTab, UINT32 aVirtAddr)
+{
+#if K2_TARGET_ARCH_IS_ARM
+    return apTransTab + ((aVirtAddr / K2_VA32_PAGETABLE_MAP_BYTES) * 4);
+#else
+    return apTransTab + (aVirtAddr / K2_VA32_PAGETABLE_MAP_BYTES);
+#endif
+}
+
 UINT32 * sGetPTE(UINT32 aVirtMapBase, UINT32 aVirtAddr)
 {
     UINT32* pPTE;
@@ -41,6 +50,10 @@ UINT32 * sGetPTE(UINT32 aVirtMapBase, UINT32 aVirtAddr)
     if (aVirtAddr >= K2OS_KVA_KERN_BASE)
     {
         K2_ASSERT(aVirtMapBase == K2OS_KVA_KERNVAMAP_BASE);
+        //
+        // there is no pagetable under a large page. it has to be broken first
+        //
+        K2_ASSERT(!KernArch_IsLargePDE(*sGetKernPDE((UINT32 *)K2OS_KVA_TRANSTAB_BASE, aVirtAddr)));
         pPTE = (UINT32*)K2OS_KVA_TO_PTE_ADDR(aVirtAddr);
     }
     else
@@ -52,6 +65,23 @@ UINT32 * sGetPTE(UINT32 aVirtMapBase, UINT32 aVirtAddr)
     return pPTE;
 }
 
+static UINT32 sReadPTE(UINT32 aVirtMapBase, UINT32 aVirtAddr)
+{
+    UINT32 pde;
+
+    //
+    // large pages have no pagetable to read so give back what the pte would be
+    //
+    if (aVirtAddr >= K2OS_KVA_KERN_BASE)
+    {
+        pde = *sGetKernPDE((UINT32 *)K2OS_KVA_TRANSTAB_BASE, aVirtAddr);
+        if (KernArch_IsLargePDE(pde))
+            return KernArch_LargePDEToPTE(pde, aVirtAddr);
+    }
+
+    return *((UINT32 *)K2_VA32_TO_PTE_ADDR(aVirtMapBase, aVirtAddr));
+}
+
 void KernMap_MakeOnePresentPage(UINT32 aVirtMapBase, UINT32 aVirtAddr, UINT32 aPhysAddr, UINT32 aPageMapAttr)
 {
     UINT32 *    pPTE;
@@ -323,8 +353,10 @@ void KernMap_MakeOneKernPageFromThread(K2OSKERN_OBJ_THREAD *apCurThread, void *a
 
         // move phys pt page onto system tracking list
         apCurThread->mpWorkPtPage->mpOwnerObject = NULL;
+        apCurThread->mpWorkPtPage->mFlags = (apCurThread->mpWorkPtPage->mFlags & ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK) | (KernPhysPageList_Paging << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
         K2LIST_AddAtTail(&gData.PhysPageList[KernPhysPageList_Paging], &apCurThread->mpWorkPtPage->ListLink);
         apCurThread->mpWorkPtPage = NULL;
+        KernMem_StatsPageTable((ptIndex < K2_VA32_PAGEFRAMES_FOR_2G) ? apCurThread->mpProc : NULL, TRUE);
     }
 
     if (apCurThread->mpWorkPage != NULL)
@@ -378,6 +410,29 @@ void KernMap_MakeOnePageFromThread(K2OSKERN_OBJ_THREAD *apCurThread, void *apPhy
     }
 }
 
+#if K2_TARGET_ARCH_IS_INTEL
+static K2OSKERN_PHYSTRACK_PAGE * sTakePurgedPt(K2OSKERN_OBJ_THREAD *apCurThread, UINT32 aPtIndex)
+{
+    BOOL                        disp;
+    K2OSKERN_PHYSTRACK_PAGE *   pPhysPage;
+
+    //
+    // pagetable page is no longer mapped. take it off the paging list
+    //
+    pPhysPage = (K2OSKERN_PHYSTRACK_PAGE *)K2OS_PHYS32_TO_PHYSTRACK(apCurThread->Sched.Item.Args.PurgePt.mPtPhysOut);
+
+    disp = K2OSKERN_SeqIntrLock(&gData.PhysMemSeqLock);
+    K2_ASSERT(K2OSKERN_PHYSTRACK_PAGE_FLAGS_GET_LIST(pPhysPage->mFlags) == KernPhysPageList_Paging);
+    K2LIST_Remove(&gData.PhysPageList[KernPhysPageList_Paging], &pPhysPage->ListLink);
+    pPhysPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
+    pPhysPage->mFlags |= (KernPhysPageList_Thread_PtWorking << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+    KernMem_StatsPageTable((aPtIndex < K2_VA32_PAGEFRAMES_FOR_2G) ? apCurThread->mpProc : NULL, FALSE);
+    K2OSKERN_SeqIntrUnlock(&gData.PhysMemSeqLock, disp);
+
+    return pPhysPage;
+}
+#endif
+
 UINT32 KernMap_BreakOneKernPageToThread(K2OSKERN_OBJ_THREAD *apCurThread, void *apMatchPhysPageOwner, KernPhysPageList aMatchList, UINT32 aNpFlags)
 {
     UINT32 *                    pPtPageCount;
@@ -456,7 +511,7 @@ UINT32 KernMap_BreakOneKernPageToThread(K2OSKERN_OBJ_THREAD *apCurThread, void *
         apCurThread->Sched.Item.mSchedItemType = KernSchedItem_PurgePT;
         apCurThread->Sched.Item.Args.PurgePt.mPtIndex = ptIndex;
         KernArch_ThreadCallSched();
-        apCurThread->mpWorkPtPage = (K2OSKERN_PHYSTRACK_PAGE *)K2OS_PHYS32_TO_PHYSTRACK(apCurThread->Sched.Item.Args.PurgePt.mPtPhysOut);
+        apCurThread->mpWorkPtPage = sTakePurgedPt(apCurThread, ptIndex);
         apCurThread->mTlbFlushNeeded = FALSE;
         apCurThread->mTlbFlushBase = 0;
         apCurThread->mTlbFlushPages = 0;
@@ -501,7 +556,6 @@ UINT32 KernMap_BreakOnePageToThread(K2OSKERN_OBJ_THREAD *apCurThread, void *apMa
 BOOL KernMap_SegRangeNotMapped(K2OSKERN_OBJ_THREAD *apCurThread, K2OSKERN_OBJ_SEGMENT *apSeg, UINT32 aPageOffset, UINT32 aPageCount)
 {
     BOOL    disp;
-    UINT32 *pPTE;
     UINT32  pte;
     UINT32  segPageCount;
     UINT32  virtAddr;
@@ -518,19 +572,16 @@ BOOL KernMap_SegRangeNotMapped(K2OSKERN_OBJ_THREAD *apCurThread, K2OSKERN_OBJ_SE
     else
         mapBase = apCurThread->mpProc->mVirtMapKVA;
 
-    pPTE = (UINT32 *)K2_VA32_TO_PTE_ADDR(mapBase, virtAddr);
-
     disp = K2OSKERN_SeqIntrLock(&gData.KernVirtMapLock);
 
     do {
-        pte = *pPTE;
+        pte = sReadPTE(mapBase, virtAddr);
         if ((0 == (pte & K2OSKERN_PTE_NP_BIT)) ||
             (0 != (pte & K2OSKERN_PTE_PRESENT_BIT)))
         {
             K2OSKERN_Debug("Check SegRangeNotMapped - ERROR %08X pte %08X\n", virtAddr, pte);
             break;
         }
-        pPTE++;
         virtAddr += K2_VA32_MEMPAGE_BYTES;
     } while (--aPageCount);
 
@@ -542,7 +593,6 @@ BOOL KernMap_SegRangeNotMapped(K2OSKERN_OBJ_THREAD *apCurThread, K2OSKERN_OBJ_SE
 BOOL KernMap_SegRangeMapped(K2OSKERN_OBJ_THREAD *apCurThread, K2OSKERN_OBJ_SEGMENT *apSeg, UINT32 aPageOffset, UINT32 aPageCount)
 {
     BOOL    disp;
-    UINT32 *pPTE;
     UINT32  pte;
     UINT32  segPageCount;
     UINT32  virtAddr;
@@ -559,18 +609,15 @@ BOOL KernMap_SegRangeMapped(K2OSKERN_OBJ_THREAD *apCurThread, K2OSKERN_OBJ_SEGME
     else
         mapBase = apCurThread->mpProc->mVirtMapKVA;
 
-    pPTE = (UINT32 *)K2_VA32_TO_PTE_ADDR(mapBase, virtAddr);
-
     disp = K2OSKERN_SeqIntrLock(&gData.KernVirtMapLock);
 
     do {
-        pte = *pPTE;
+        pte = sReadPTE(mapBase, virtAddr);
         if (0 == (pte & K2OSKERN_PTE_PRESENT_BIT))
         {
             K2OSKERN_Debug("Check SegRangeMapped - ERROR %08X pte %08X\n", virtAddr, pte);
             break;
         }
-        pPTE++;
         virtAddr += K2_VA32_MEMPAGE_BYTES;
     } while (--aPageCount);
 
@@ -582,7 +629,6 @@ BOOL KernMap_SegRangeMapped(K2OSKERN_OBJ_THREAD *apCurThread, K2OSKERN_OBJ_SEGME
 void KernMap_FindMapped(K2OSKERN_OBJ_THREAD *apCurThread, UINT32 aVirtAddr, UINT32 aPageCount, UINT32 *apScanIx, UINT32 *apFoundCount)
 {
     BOOL        disp;
-    UINT32 *    pPTE;
     UINT32      pte;
     UINT32      mapBase;
 
@@ -597,19 +643,16 @@ void KernMap_FindMapped(K2OSKERN_OBJ_THREAD *apCurThread, UINT32 aVirtAddr, UINT
     aVirtAddr += (*apScanIx) * K2_VA32_MEMPAGE_BYTES;
     aPageCount -= (*apScanIx);
 
-    pPTE = (UINT32 *)K2_VA32_TO_PTE_ADDR(mapBase, aVirtAddr);
-
     disp = K2OSKERN_SeqIntrLock(&gData.KernVirtMapLock);
 
     //
     // look for starting mapped entry 
     //
     do {
-        pte = *pPTE;
+        pte = sReadPTE(mapBase, aVirtAddr);
         if (0 != (pte & K2OSKERN_PTE_PRESENT_BIT))
             break;
         (*apScanIx)++;
-        pPTE++;
         aVirtAddr += K2_VA32_MEMPAGE_BYTES;
     } while (--aPageCount);
 
@@ -619,16 +662,14 @@ void KernMap_FindMapped(K2OSKERN_OBJ_THREAD *apCurThread, UINT32 aVirtAddr, UINT
         // found something before we hit the end of the range
         //
         (*apFoundCount)++;
-        pPTE++;
         aVirtAddr += K2_VA32_MEMPAGE_BYTES;
         if (--aPageCount > 0)
         {
             do {
-                pte = *pPTE;
+                pte = sReadPTE(mapBase, aVirtAddr);
                 if (0 == (pte & K2OSKERN_PTE_PRESENT_BIT))
                     break;
                 (*apFoundCount)++;
-                pPTE++;
                 aVirtAddr += K2_VA32_MEMPAGE_BYTES;
             } while (--aPageCount);
         }
@@ -636,3 +677,431 @@ void KernMap_FindMapped(K2OSKERN_OBJ_THREAD *apCurThread, UINT32 aVirtAddr, UINT
 
     K2OSKERN_SeqIntrUnlock(&gData.KernVirtMapLock, disp);
 }
+
+void KernMap_MapRange(UINT32 aVirtMapBase, UINT32 aVirtAddr, UINT32 aPageCount, UINT32 aPhysAddr, UINT32 const *apPhysList, UINT32 aPageMapAttr)
+{
+    UINT32 *    pPTE;
+    UINT32 *    pPageCount;
+    UINT32      runLeft;
+    UINT32      run;
+    UINT32      added;
+    UINT32      pteOld;
+    UINT32      ix;
+
+    //
+    // caller holds the virtual map lock and pagetables for the range exist.
+    // if apPhysList is NULL the physical range is contiguous from aPhysAddr
+    //
+    K2_ASSERT(aPageCount > 0);
+    K2_ASSERT(aVirtAddr >= K2OS_KVA_KERN_BASE);
+
+    aPageMapAttr &= K2OS_MEMPAGE_ATTR_MASK;
+
+#if DIAG_MAPPING
+    K2OSKERN_Debug("MAKE_R %08X, %d pages, ATTR %08X\n", aVirtAddr, aPageCount, aPageMapAttr);
+#endif
+
+    do {
+        pPageCount = ((UINT32 *)K2OS_KVA_PTPAGECOUNT_BASE) + (aVirtAddr / K2_VA32_PAGETABLE_MAP_BYTES);
+        K2_ASSERT((*pPageCount) != 0);
+
+        runLeft = (K2_VA32_PAGETABLE_MAP_BYTES - (aVirtAddr & (K2_VA32_PAGETABLE_MAP_BYTES - 1))) / K2_VA32_MEMPAGE_BYTES;
+        run = (aPageCount < runLeft) ? aPageCount : runLeft;
+
+        pPTE = sGetPTE(aVirtMapBase, aVirtAddr);
+        added = 0;
+
+        for (ix = 0; ix < run; ix++)
+        {
+            pteOld = pPTE[ix];
+            K2_ASSERT((pteOld & K2OSKERN_PTE_PRESENT_BIT) == 0);
+            if (0 == (pteOld & K2OSKERN_PTE_NP_BIT))
+                added++;
+            if (apPhysList != NULL)
+            {
+                pPTE[ix] = KernArch_MakePTE(*apPhysList, aPageMapAttr);
+                apPhysList++;
+            }
+            else
+            {
+                pPTE[ix] = KernArch_MakePTE(aPhysAddr, aPageMapAttr);
+                aPhysAddr += K2_VA32_MEMPAGE_BYTES;
+            }
+        }
+
+        KernArch_FlushPTERange(aVirtAddr, pPTE, run);
+
+        (*pPageCount) += added;
+        K2_ASSERT((*pPageCount) <= 1024);
+
+        aVirtAddr += run * K2_VA32_MEMPAGE_BYTES;
+        aPageCount -= run;
+
+    } while (aPageCount > 0);
+
+    K2_CpuWriteBarrier();
+}
+
+void KernMap_UnmapRange(K2OSKERN_OBJ_THREAD *apCurThread, UINT32 aVirtAddr, UINT32 aPageCount, UINT32 aNpFlags, UINT32 *apRetPhysList)
+{
+    UINT32 *                    pPTE;
+    UINT32 *                    pPageCount;
+    UINT32                      runLeft;
+    UINT32                      run;
+    UINT32                      removed;
+    UINT32                      pteOld;
+    UINT32                      ix;
+    UINT32                      ptIndex;
+    BOOL                        disp;
+    BOOL                        emptyPt;
+    K2OSKERN_PHYSTRACK_PAGE *   pPhysPage;
+
+    //
+    // kernel space only. the range is added to the thread's pending tlb flush
+    // and any pagetable that empties is purged onto the thread's clean pt list.
+    // apRetPhysList receives the physical address for each page or zero if
+    // the entry was not present
+    //
+    K2_ASSERT(aPageCount > 0);
+    K2_ASSERT(aVirtAddr >= K2OS_KVA_KERN_BASE);
+    K2_ASSERT((aNpFlags & K2OSKERN_PTE_PRESENT_BIT) == 0);
+
+#if DIAG_MAPPING
+    K2OSKERN_Debug("BRAK_R %08X, %d pages, NPFLAGS %08X\n", aVirtAddr, aPageCount, aNpFlags);
+#endif
+
+    do {
+        ptIndex = aVirtAddr / K2_VA32_PAGETABLE_MAP_BYTES;
+        pPageCount = ((UINT32 *)K2OS_KVA_PTPAGECOUNT_BASE) + ptIndex;
+
+        runLeft = (K2_VA32_PAGETABLE_MAP_BYTES - (aVirtAddr & (K2_VA32_PAGETABLE_MAP_BYTES - 1))) / K2_VA32_MEMPAGE_BYTES;
+        run = (aPageCount < runLeft) ? aPageCount : runLeft;
+
+        K2_ASSERT(!KernArch_IsLargePDE(*sGetKernPDE((UINT32 *)K2OS_KVA_TRANSTAB_BASE, aVirtAddr)));
+        pPTE = (UINT32 *)K2OS_KVA_TO_PTE_ADDR(aVirtAddr);
+        removed = 0;
+
+        disp = K2OSKERN_SeqIntrLock(&gData.KernVirtMapLock);
+
+        for (ix = 0; ix < run; ix++)
+        {
+            pteOld = pPTE[ix];
+            K2_ASSERT((pteOld & (K2OSKERN_PTE_PRESENT_BIT | K2OSKERN_PTE_NP_BIT)) != 0);
+            if (apRetPhysList != NULL)
+            {
+                *apRetPhysList = (pteOld & K2OSKERN_PTE_PRESENT_BIT) ? (pteOld & K2_VA32_PAGEFRAME_MASK) : 0;
+                apRetPhysList++;
+            }
+            if (aNpFlags & K2OSKERN_PTE_NP_BIT)
+            {
+                pPTE[ix] = aNpFlags;
+            }
+            else
+            {
+                pPTE[ix] = 0;
+                removed++;
+            }
+        }
+
+        KernArch_FlushPTERange(aVirtAddr, pPTE, run);
+
+        K2_ASSERT((*pPageCount) >= removed);
+        (*pPageCount) -= removed;
+
+        emptyPt = ((*pPageCount) == 0) ? TRUE : FALSE;
+        if (emptyPt)
+        {
+            K2_ASSERT(0 != K2MEM_VerifyZero((void *)K2OS_KVA_TO_PT_ADDR(aVirtAddr), K2_VA32_MEMPAGE_BYTES));
+        }
+
+        K2OSKERN_SeqIntrUnlock(&gData.KernVirtMapLock, disp);
+
+        if (!apCurThread->mTlbFlushNeeded)
+        {
+            apCurThread->mTlbFlushNeeded = TRUE;
+            apCurThread->mTlbFlushBase = aVirtAddr;
+            apCurThread->mTlbFlushPages = run;
+        }
+        else
+        {
+            K2_ASSERT(aVirtAddr >= apCurThread->mTlbFlushBase);
+            apCurThread->mTlbFlushPages = ((aVirtAddr - apCurThread->mTlbFlushBase) / K2_VA32_MEMPAGE_BYTES) + run;
+        }
+
+        if (emptyPt)
+        {
+#if K2_TARGET_ARCH_IS_INTEL
+            //
+            // unmap the pagetable via the scheduler. pending flush range is
+            // kept as the purge only invalidates one page inside the range
+            //
+            apCurThread->Sched.Item.mSchedItemType = KernSchedItem_PurgePT;
+            apCurThread->Sched.Item.Args.PurgePt.mPtIndex = ptIndex;
+            KernArch_ThreadCallSched();
+            pPhysPage = sTakePurgedPt(apCurThread, ptIndex);
+
+            disp = K2OSKERN_SetIntr(FALSE);
+            pPhysPage->mpOwnerObject = NULL;
+            pPhysPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
+            pPhysPage->mFlags |= (KernPhysPageList_Thread_PtClean << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+            K2LIST_AddAtTail(&apCurThread->WorkPtPages_Clean, &pPhysPage->ListLink);
+            K2OSKERN_SetIntr(disp);
+#else
+            K2_ASSERT(0);
+#endif
+        }
+
+        aVirtAddr += run * K2_VA32_MEMPAGE_BYTES;
+        aPageCount -= run;
+
+    } while (aPageCount > 0);
+}
+
+BOOL KernMap_MakeLargePage(UINT32 aVirtAddr, UINT32 aPhysAddr, UINT32 aPageMapAttr)
+{
+    UINT32 *                pPDE;
+    UINT32                  pde;
+    UINT32 *                pPtPageCount;
+    BOOL                    disp;
+    BOOL                    result;
+#if !K2_TARGET_ARCH_IS_ARM
+    K2LIST_LINK *           pListLink;
+    K2OSKERN_OBJ_PROCESS *  pProc;
+#endif
+
+    K2_ASSERT(aVirtAddr >= K2OS_KVA_KERN_BASE);
+    K2_ASSERT(0 == (aVirtAddr & (K2_VA32_PAGETABLE_MAP_BYTES - 1)));
+    K2_ASSERT(0 == (aPhysAddr & (K2_VA32_PAGETABLE_MAP_BYTES - 1)));
+
+    pde = KernArch_MakeLargePDE(aPhysAddr, aPageMapAttr & K2OS_MEMPAGE_ATTR_MASK);
+    if (pde == 0)
+        return FALSE;
+
+    pPDE = sGetKernPDE((UINT32 *)K2OS_KVA_TRANSTAB_BASE, aVirtAddr);
+    pPtPageCount = ((UINT32 *)K2OS_KVA_PTPAGECOUNT_BASE) + (aVirtAddr / K2_VA32_PAGETABLE_MAP_BYTES);
+
+#if !K2_TARGET_ARCH_IS_ARM
+    disp = K2OSKERN_SeqIntrLock(&gData.ProcListSeqLock);
+    K2OSKERN_SeqIntrLock(&gData.KernVirtMapLock);
+#else
+    disp = K2OSKERN_SeqIntrLock(&gData.KernVirtMapLock);
+#endif
+
+    //
+    // can only use a large page if nothing in the 4MB range has ever been
+    // given a pagetable.  if it has then caller maps small pages
+    //
+    if (((*pPDE) != 0) || ((*pPtPageCount) != 0))
+    {
+        result = FALSE;
+    }
+    else
+    {
+#if DIAG_MAPPING
+        K2OSKERN_Debug("MAKE_L %08X->%08X, ATTR %08X (%08X)\n", aVirtAddr, aPhysAddr, aPageMapAttr, pde);
+#endif
+
+#if K2_TARGET_ARCH_IS_ARM
+        KernArch_WriteLargePDE(pPDE, pde);
+#else
+        //
+        // x32 - install it into the page directories of all processes
+        //
+        pListLink = gData.ProcList.mpHead;
+        K2_ASSERT(pListLink != NULL);
+        do {
+            pProc = K2_GET_CONTAINER(K2OSKERN_OBJ_PROCESS, pListLink, ProcListLink);
+            pPDE = sGetKernPDE((UINT32 *)pProc->mTransTableKVA, aVirtAddr);
+            K2_ASSERT(((*pPDE) & K2OSKERN_PDE_PRESENT_BIT) == 0);
+            KernArch_WriteLargePDE(pPDE, pde);
+            pListLink = pListLink->mpNext;
+        } while (pListLink != NULL);
+#endif
+        K2_CpuWriteBarrier();
+        result = TRUE;
+    }
+
+#if !K2_TARGET_ARCH_IS_ARM
+    K2OSKERN_SeqIntrUnlock(&gData.KernVirtMapLock, FALSE);
+    K2OSKERN_SeqIntrUnlock(&gData.ProcListSeqLock, disp);
+#else
+    K2OSKERN_SeqIntrUnlock(&gData.KernVirtMapLock, disp);
+#endif
+
+    return result;
+}
+
+UINT32 KernMap_UnmapLargePage(UINT32 aVirtAddr)
+{
+    UINT32 *                pPDE;
+    UINT32                  result;
+    BOOL                    disp;
+#if !K2_TARGET_ARCH_IS_ARM
+    K2LIST_LINK *           pListLink;
+    K2OSKERN_OBJ_PROCESS *  pProc;
+#endif
+
+    K2_ASSERT(aVirtAddr >= K2OS_KVA_KERN_BASE);
+    K2_ASSERT(0 == (aVirtAddr & (K2_VA32_PAGETABLE_MAP_BYTES - 1)));
+
+    pPDE = sGetKernPDE((UINT32 *)K2OS_KVA_TRANSTAB_BASE, aVirtAddr);
+
+#if !K2_TARGET_ARCH_IS_ARM
+    disp = K2OSKERN_SeqIntrLock(&gData.ProcListSeqLock);
+    K2OSKERN_SeqIntrLock(&gData.KernVirtMapLock);
+#else
+    disp = K2OSKERN_SeqIntrLock(&gData.KernVirtMapLock);
+#endif
+
+    K2_ASSERT(KernArch_IsLargePDE(*pPDE));
+
+#if DIAG_MAPPING
+    K2OSKERN_Debug("BRAK_L %08X (%08X)\n", aVirtAddr, *pPDE);
+#endif
+
+#if K2_TARGET_ARCH_IS_ARM
+    result = (*pPDE) & A32_TTBE_SECTION_PHYSADDR_MASK;
+    KernArch_WriteLargePDE(pPDE, 0);
+#else
+    result = (*pPDE) & X32_PDE_LARGEPHYS_MASK;
+    pListLink = gData.ProcList.mpHead;
+    K2_ASSERT(pListLink != NULL);
+    do {
+        pProc = K2_GET_CONTAINER(K2OSKERN_OBJ_PROCESS, pListLink, ProcListLink);
+        pPDE = sGetKernPDE((UINT32 *)pProc->mTransTableKVA, aVirtAddr);
+        KernArch_WriteLargePDE(pPDE, 0);
+        pListLink = pListLink->mpNext;
+    } while (pListLink != NULL);
+#endif
+
+    K2_CpuWriteBarrier();
+
+#if !K2_TARGET_ARCH_IS_ARM
+    K2OSKERN_SeqIntrUnlock(&gData.KernVirtMapLock, FALSE);
+    K2OSKERN_SeqIntrUnlock(&gData.ProcListSeqLock, disp);
+#else
+    K2OSKERN_SeqIntrUnlock(&gData.KernVirtMapLock, disp);
+#endif
+
+    //
+    // caller is responsible for flushing the TLB for the whole 4MB range
+    //
+    return result;
+}
+
+void KernMap_BreakLargePage(K2OSKERN_OBJ_THREAD *apCurThread, UINT32 aVirtAddr)
+{
+    UINT32 *                pPDE;
+    UINT32                  pde;
+    UINT32                  largePde;
+    UINT32                  ptIndex;
+    UINT32                  virtPT;
+    UINT32                  physPageAddr;
+    UINT32 *                pPTE;
+    UINT32                  ix;
+    BOOL                    disp;
+#if !K2_TARGET_ARCH_IS_ARM
+    K2LIST_LINK *           pListLink;
+    K2OSKERN_OBJ_PROCESS *  pProc;
+#endif
+
+    //
+    // replace a large page with a clean pagetable from the thread that maps exactly
+    // the same pages with the same attributes, so that part of the chunk can be
+    // unmapped or changed a page at a time
+    //
+    K2_ASSERT(aVirtAddr >= K2OS_KVA_KERN_BASE);
+    K2_ASSERT(0 == (aVirtAddr & (K2_VA32_PAGETABLE_MAP_BYTES - 1)));
+    K2_ASSERT(apCurThread->mpWorkPtPage != NULL);
+
+    ptIndex = aVirtAddr / K2_VA32_PAGETABLE_MAP_BYTES;
+    virtPT = K2OS_KVA_TO_PT_ADDR(aVirtAddr);
+    physPageAddr = K2OS_PHYSTRACK_TO_PHYS32(((UINT32)apCurThread->mpWorkPtPage));
+
+    pPDE = sGetKernPDE((UINT32 *)K2OS_KVA_TRANSTAB_BASE, aVirtAddr);
+
+#if !K2_TARGET_ARCH_IS_ARM
+    disp = K2OSKERN_SeqIntrLock(&gData.ProcListSeqLock);
+    K2OSKERN_SeqIntrLock(&gData.KernVirtMapLock);
+#else
+    disp = K2OSKERN_SeqIntrLock(&gData.KernVirtMapLock);
+#endif
+
+    largePde = *pPDE;
+    K2_ASSERT(KernArch_IsLargePDE(largePde));
+    K2_ASSERT(((UINT32 *)K2OS_KVA_PTPAGECOUNT_BASE)[ptIndex] == 0);
+
+#if DIAG_MAPPING
+    K2OSKERN_Debug("SPLT_L %08X (%08X) PT at %08X->%08X\n", aVirtAddr, largePde, virtPT, physPageAddr);
+#endif
+
+    //
+    // fill the pagetable before it is live
+    //
+    K2_ASSERT(((*((UINT32 *)K2OS_KVA_TO_PTE_ADDR(virtPT))) & K2OSKERN_PTE_PRESENT_BIT) == 0);
+    KernMap_MakeOnePresentPage(K2OS_KVA_KERNVAMAP_BASE, virtPT, physPageAddr, K2OS_MAPTYPE_KERN_PAGETABLE);
+
+    pPTE = (UINT32 *)virtPT;
+    for (ix = 0; ix < K2_VA32_ENTRIES_PER_PAGETABLE; ix++)
+    {
+        pPTE[ix] = KernArch_LargePDEToPTE(largePde, aVirtAddr + (ix * K2_VA32_MEMPAGE_BYTES));
+    }
+    KernArch_FlushPTERange(aVirtAddr, pPTE, K2_VA32_ENTRIES_PER_PAGETABLE);
+
+    ((UINT32 *)K2OS_KVA_PTPAGECOUNT_BASE)[ptIndex] = K2_VA32_ENTRIES_PER_PAGETABLE;
+
+    //
+    // swap the large entry for the pagetable.  translations do not change so a stale
+    // large tlb entry is harmless until the pages under it are unmapped and flushed
+    //
+#if K2_TARGET_ARCH_IS_ARM
+    pde = (physPageAddr & K2_VA32_PAGEFRAME_MASK) | A32_TTBE_PAGETABLE_PROTO;
+    pPDE[0] = pde;
+    pPDE[1] = (pde + 0x400);
+    pPDE[2] = (pde + 0x800);
+    pPDE[3] = (pde + 0xC00);
+#else
+    pde = (physPageAddr & K2_VA32_PAGEFRAME_MASK) | X32_KERN_PAGETABLE_PROTO;
+    if (K2OS_MAPTYPE_KERN_PAGEDIR & K2OS_MEMPAGE_ATTR_UNCACHED)
+        pde |= X32_PDE_CACHEDISABLE;
+    if (K2OS_MAPTYPE_KERN_PAGEDIR & K2OS_MEMPAGE_ATTR_WRITE_THRU)
+        pde |= X32_PDE_WRITETHROUGH;
+
+    pListLink = gData.ProcList.mpHead;
+    K2_ASSERT(pListLink != NULL);
+    do {
+        pProc = K2_GET_CONTAINER(K2OSKERN_OBJ_PROCESS, pListLink, ProcListLink);
+        pPDE = sGetKernPDE((UINT32 *)pProc->mTransTableKVA, aVirtAddr);
+        K2_ASSERT(KernArch_IsLargePDE(*pPDE));
+        *pPDE = pde;
+        pListLink = pListLink->mpNext;
+    } while (pListLink != NULL);
+#endif
+
+    K2_CpuWriteBarrier();
+
+#if !K2_TARGET_ARCH_IS_ARM
+    K2OSKERN_SeqIntrUnlock(&gData.KernVirtMapLock, FALSE);
+    K2OSKERN_SeqIntrUnlock(&gData.ProcListSeqLock, disp);
+#else
+    K2OSKERN_SeqIntrUnlock(&gData.KernVirtMapLock, disp);
+#endif
+
+    //
+    // move phys pt page onto system tracking list
+    //
+    disp = K2OSKERN_SeqIntrLock(&gData.PhysMemSeqLock);
+    apCurThread->mpWorkPtPage->mpOwnerObject = NULL;
+    apCurThread->mpWorkPtPage->mFlags = (apCurThread->mpWorkPtPage->mFlags & ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK) | (KernPhysPageList_Paging << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+    K2LIST_AddAtTail(&gData.PhysPageList[KernPhysPageList_Paging], &apCurThread->mpWorkPtPage->ListLink);
+    apCurThread->mpWorkPtPage = NULL;
+    KernMem_StatsPageTable(NULL, TRUE);
+    K2OSKERN_SeqIntrUnlock(&gData.PhysMemSeqLock, disp);
+}
+
+BOOL KernMap_IsLargePage(UINT32 aVirtAddr)
+{
+    if (aVirtAddr < K2OS_KVA_KERN_BASE)
+        return FALSE;
+    return KernArch_IsLargePDE(*sGetKernPDE((UINT32 *)K2OS_KVA_TRANSTAB_BASE, aVirtAddr));
+}
@@ -215,6 +215,9 @@ sDumpHeapNode(
                 case K2OSKERN_SEG_ATTR_TYPE_CONTIG_PHYS:
                     pStr = "CONTIG_PHYS";
                     break;
+                case K2OSKERN_SEG_ATTR_TYPE_LENT:
+                    pStr = "LENT";
+                    break;
                 default:
                     pStr = "UNKNOWN!";
                 }
@@ -236,6 +239,9 @@ void sDumpPhys(void)
     BOOL                        intrDisp;
     K2OSKERN_PHYSTRACK_PAGE *   pPhysPage;
     UINT32                      left;
+    UINT32                      coreIx;
+    UINT32                      coreCached;
+    K2OSKERN_CPUCORE volatile * pCore;
 
     K2OSKERN_Debug("\n\nPhysical Memory:\n");
 
@@ -291,9 +297,56 @@ void sDumpPhys(void)
         }
     } while (left > 0);
 
+    coreCached = 0;
+    for (coreIx = 0; coreIx < gData.mCpuCount; coreIx++)
+    {
+        pCore = K2OSKERN_COREIX_TO_CPUCORE(coreIx);
+        coreCached += pCore->PhysCache_Clean.mNodeCount + pCore->PhysCache_Dirty.mNodeCount + pCore->PtPool.mNodeCount;
+        K2OSKERN_Debug("  Core %d PT pool %d: alloc %d, pool hit %d, refill %d, recycled %d, released %d\n",
+            coreIx,
+            pCore->PtPool.mNodeCount,
+            pCore->PtPoolStats.mAllocs,
+            pCore->PtPoolStats.mPoolHits,
+            pCore->PtPoolStats.mRefills,
+            pCore->PtPoolStats.mRecycled,
+            pCore->PtPoolStats.mReleased);
+    }
+
+    K2OSKERN_Debug("  Free clean %d, Free dirty %d, Core cached %d, Zeroed background %d, Zeroed inline %d\n",
+        gData.PhysPageList[KernPhysPageList_Free_Clean].mNodeCount,
+        gData.PhysPageList[KernPhysPageList_Free_Dirty].mNodeCount,
+        coreCached,
+        gData.PhysZero.mBackgroundCount,
+        gData.PhysZero.mInlineCount);
+
     K2OSKERN_SeqIntrUnlock(&gData.PhysMemSeqLock, intrDisp);
 }
 
+void sDumpVirtCache(void)
+{
+    UINT32                      coreIx;
+    UINT32                      bucket;
+    UINT32                      slot;
+    UINT32                      entry;
+    K2OSKERN_CPUCORE volatile * pCore;
+
+    for (coreIx = 0; coreIx < gData.mCpuCount; coreIx++)
+    {
+        pCore = K2OSKERN_COREIX_TO_CPUCORE(coreIx);
+        for (bucket = 0; bucket < K2OSKERN_VIRTCACHE_BUCKETS; bucket++)
+        {
+            for (slot = 0; slot < K2OSKERN_VIRTCACHE_SLOTS; slot++)
+            {
+                entry = pCore->mVirtCache[bucket][slot];
+                if (entry != 0)
+                {
+                    K2OSKERN_Debug("  Core %d cached %08X %d pages\n", coreIx, entry & K2_VA32_PAGEFRAME_MASK, entry & K2_VA32_MEMPAGE_OFFSET_MASK);
+                }
+            }
+        }
+    }
+}
+
 void sDumpVirt(void)
 {
     BOOL intrDisp;
@@ -307,6 +360,8 @@ void sDumpVirt(void)
 
     intrDisp = K2OS_CritSecLeave(&gData.KernVirtHeapSec);
     K2_ASSERT(intrDisp);
+
+    sDumpVirtCache();
 }
 
 void sDumpSeg(void)
@@ -348,6 +403,8 @@ UINT32 sRamHeapLock(K2OS_RAMHEAP *apRamHeap)
 void sRamHeapUnlock(K2OS_RAMHEAP *apRamHeap, UINT32 aDisp)
 {
     BOOL ok;
+    if (apRamHeap->HeapState.mTotalAlloc > gData.MemStats.mHeapTotalAllocHigh)
+        gData.MemStats.mHeapTotalAllocHigh = apRamHeap->HeapState.mTotalAlloc;
     ok = K2OS_CritSecLeave(&gData.KernVirtHeapSec);
     K2_ASSERT(ok);
 }
@@ -376,6 +433,104 @@ void sKernVirtHeapReleaseNode(K2HEAP_ANCHOR *apHeap, K2HEAP_NODE *apNode)
     K2LIST_AddAtTail(&gData.HeapTrackFreeList, (K2LIST_LINK *)apNode);
 }
 
+static void sMemStatsNotePhysTaken(void)
+{
+    UINT32 inUse;
+
+    //
+    // called with PhysMemSeqLock held after pages come off the free lists or free tree
+    //
+    inUse = gData.MemStats.mPhysPagesTotal -
+        (gData.PhysPageList[KernPhysPageList_Free_Clean].mNodeCount +
+         gData.PhysPageList[KernPhysPageList_Free_Dirty].mNodeCount +
+         gData.MemStats.mPhysFreeTreePages);
+
+    if (inUse > gData.MemStats.mPhysPagesInUseHigh)
+        gData.MemStats.mPhysPagesInUseHigh = inUse;
+}
+
+static void sMemStatsResident(K2OSKERN_OBJ_PROCESS *apProc, INT32 aPageDelta)
+{
+    //
+    // called with PhysMemSeqLock held when pages are mapped into or unmapped from a segment
+    //
+    apProc->MemStats.mResidentPages += aPageDelta;
+    if (apProc->MemStats.mResidentPages > apProc->MemStats.mResidentPagesHigh)
+        apProc->MemStats.mResidentPagesHigh = apProc->MemStats.mResidentPages;
+}
+
+void KernMem_StatsPageTable(K2OSKERN_OBJ_PROCESS *apUserProc, BOOL aAdded)
+{
+    //
+    // called with PhysMemSeqLock held when a pagetable is installed or purged
+    //
+    if (aAdded)
+    {
+        gData.MemStats.mPageTablePages++;
+        if (gData.MemStats.mPageTablePages > gData.MemStats.mPageTablePagesHigh)
+            gData.MemStats.mPageTablePagesHigh = gData.MemStats.mPageTablePages;
+        if (apUserProc != NULL)
+            apUserProc->MemStats.mPageTablePages++;
+    }
+    else
+    {
+        K2_ASSERT(gData.MemStats.mPageTablePages > 0);
+        gData.MemStats.mPageTablePages--;
+        if (apUserProc != NULL)
+        {
+            K2_ASSERT(apUserProc->MemStats.mPageTablePages > 0);
+            apUserProc->MemStats.mPageTablePages--;
+        }
+    }
+}
+
+void KernMem_GetStats(K2OS_MEMSTATS *apRetStats)
+{
+    BOOL                        disp;
+    UINT32                      ix;
+    K2OSKERN_CPUCORE volatile * pCore;
+    K2OS_RAMHEAP_STATE          heapState;
+
+    disp = K2OSKERN_SeqIntrLock(&gData.PhysMemSeqLock);
+
+    apRetStats->mPhysPagesTotal = gData.MemStats.mPhysPagesTotal;
+    apRetStats->mPhysPagesInUse = gData.MemStats.mPhysPagesTotal -
+        (gData.PhysPageList[KernPhysPageList_Free_Clean].mNodeCount +
+         gData.PhysPageList[KernPhysPageList_Free_Dirty].mNodeCount +
+         gData.MemStats.mPhysFreeTreePages);
+    apRetStats->mPhysPagesInUseHigh = gData.MemStats.mPhysPagesInUseHigh;
+    apRetStats->mPageTablePages = gData.MemStats.mPageTablePages;
+    apRetStats->mPageTablePagesHigh = gData.MemStats.mPageTablePagesHigh;
+
+    for (ix = 0; ix < KernPhysPageList_Count; ix++)
+    {
+        apRetStats->mListPages[ix] = gData.PhysPageList[ix].mNodeCount;
+    }
+    for (; ix < K2OS_MEMSTATS_PAGELIST_COUNT; ix++)
+    {
+        apRetStats->mListPages[ix] = 0;
+    }
+
+    K2OSKERN_SeqIntrUnlock(&gData.PhysMemSeqLock, disp);
+
+    //
+    // core caches are only ever touched by their own core, so this is a snapshot
+    //
+    apRetStats->mCoreCachedPages = 0;
+    for (ix = 0; ix < gData.mCpuCount; ix++)
+    {
+        pCore = K2OSKERN_COREIX_TO_CPUCORE(ix);
+        apRetStats->mCoreCachedPages += pCore->PhysCache_Clean.mNodeCount + pCore->PhysCache_Dirty.mNodeCount + pCore->PtPool.mNodeCount;
+    }
+
+    K2OS_RAMHEAP_GetState(&gData.RamHeap, &heapState, NULL);
+    apRetStats->mHeapAllocCount = heapState.mAllocCount;
+    apRetStats->mHeapTotalAlloc = heapState.mTotalAlloc;
+    apRetStats->mHeapTotalAllocHigh = gData.MemStats.mHeapTotalAllocHigh;
+    apRetStats->mHeapTotalFree = heapState.mTotalFree;
+    apRetStats->mHeapTotalOverhead = heapState.mTotalOverhead;
+}
+
 void KernMem_Start(void)
 {
     K2STAT                      stat;
@@ -385,12 +540,35 @@ void KernMem_Start(void)
     BOOL                        ok;
     K2OSKERN_OBJ_SEGMENT *      pSeg;
     K2TREE_NODE *               pTreeNode;
+    BOOL                        disp;
+    UINT32                      ix;
 
     //
     // should be threaded
     //
     K2_ASSERT(gData.mKernInitStage >= KernInitStage_Threaded);
 
+    //
+    // count what is being tracked once. after this the counts are
+    // kept up to date as pages move
+    //
+    disp = K2OSKERN_SeqIntrLock(&gData.PhysMemSeqLock);
+    gData.MemStats.mPhysFreeTreePages = 0;
+    pTreeNode = K2TREE_FirstNode(&gData.PhysFreeTree);
+    while (pTreeNode != NULL)
+    {
+        gData.MemStats.mPhysFreeTreePages += pTreeNode->mUserVal >> K2OSKERN_PHYSTRACK_PAGE_COUNT_SHL;
+        pTreeNode = K2TREE_NextNode(&gData.PhysFreeTree, pTreeNode);
+    }
+    gData.MemStats.mPhysPagesTotal = gData.MemStats.mPhysFreeTreePages;
+    for (ix = 0; ix < KernPhysPageList_Count; ix++)
+    {
+        gData.MemStats.mPhysPagesTotal += gData.PhysPageList[ix].mNodeCount;
+    }
+    gData.MemStats.mPageTablePages = gData.MemStats.mPageTablePagesHigh = gData.PhysPageList[KernPhysPageList_Paging].mNodeCount;
+    sMemStatsNotePhysTaken();
+    K2OSKERN_SeqIntrUnlock(&gData.PhysMemSeqLock, disp);
+
     //
     // ramheap and tracking
     //
@@ -399,6 +577,14 @@ void KernMem_Start(void)
     gData.mpTrackPages = NULL;
     gData.mpNextTrackPage = NULL;
 
+    //
+    // background zeroing
+    //
+    gData.PhysZero.mLowWater = K2OSKERN_PHYSZERO_DEFAULT_LOW_WATER;
+    gData.PhysZero.mHighWater = K2OSKERN_PHYSZERO_DEFAULT_HIGH_WATER;
+    gData.PhysZero.mTokWakeEvent = NULL;
+    gData.PhysZero.mWakePending = 0;
+
     //
     // Segment Slabs
     //
@@ -502,6 +688,139 @@ UINT32 KernMem_CountPT(UINT32 aVirtAddr, UINT32 aPageCount)
     return needPT;
 }
 
+static UINT32 sVirtCacheBucket(UINT32 aPageCount)
+{
+    UINT32 bucket;
+
+    K2_ASSERT((aPageCount > 0) && (aPageCount <= K2OSKERN_VIRTCACHE_MAX_PAGES));
+
+    bucket = 0;
+    while (aPageCount > 1)
+    {
+        aPageCount >>= 1;
+        bucket++;
+    }
+
+    return bucket;
+}
+
+static UINT32 sVirtCacheTake(UINT32 aPageCount)
+{
+    BOOL                        disp;
+    K2OSKERN_CPUCORE volatile * pThisCore;
+    UINT32 volatile *           pSlot;
+    UINT32                      left;
+    UINT32                      entry;
+    UINT32                      result;
+
+    result = 0;
+
+    disp = K2OSKERN_SetIntr(FALSE);
+
+    pThisCore = K2OSKERN_GET_CURRENT_CPUCORE;
+
+    //
+    // another core may be draining this core's slots, so an entry is only ours
+    // if we are the one that swaps it out
+    //
+    pSlot = pThisCore->mVirtCache[sVirtCacheBucket(aPageCount)];
+    left = K2OSKERN_VIRTCACHE_SLOTS;
+    do {
+        entry = *pSlot;
+        if ((entry != 0) && 
+            ((entry & K2_VA32_MEMPAGE_OFFSET_MASK) == aPageCount) &&
+            (K2ATOMIC_CompareExchange(pSlot, 0, entry) == entry))
+        {
+            result = entry & K2_VA32_PAGEFRAME_MASK;
+            break;
+        }
+        pSlot++;
+    } while (--left);
+
+    K2OSKERN_SetIntr(disp);
+
+    return result;
+}
+
+static BOOL sVirtCachePut(UINT32 aVirtAddr, UINT32 aPageCount)
+{
+    BOOL                        disp;
+    K2OSKERN_CPUCORE volatile * pThisCore;
+    UINT32 volatile *           pSlot;
+    UINT32                      left;
+    BOOL                        result;
+
+    K2_ASSERT((aVirtAddr & K2_VA32_MEMPAGE_OFFSET_MASK) == 0);
+
+    result = FALSE;
+
+    disp = K2OSKERN_SetIntr(FALSE);
+
+    pThisCore = K2OSKERN_GET_CURRENT_CPUCORE;
+
+    pSlot = pThisCore->mVirtCache[sVirtCacheBucket(aPageCount)];
+    left = K2OSKERN_VIRTCACHE_SLOTS;
+    do {
+        if ((*pSlot) == 0)
+        {
+            *pSlot = aVirtAddr | aPageCount;
+            result = TRUE;
+            break;
+        }
+        pSlot++;
+    } while (--left);
+
+    K2OSKERN_SetIntr(disp);
+
+    return result;
+}
+
+static BOOL sVirtCacheDrainAllLocked(void)
+{
+    K2OSKERN_CPUCORE volatile * pCore;
+    UINT32                      coreIx;
+    UINT32                      bucket;
+    UINT32                      slot;
+    UINT32                      entry;
+    BOOL                        result;
+    K2HEAP_NODE *               pHeapNode;
+    K2STAT                      stat;
+
+    //
+    // called with KernVirtHeapSec held.  gives the ranges parked on every core back to the 
+    // heap so they can coalesce with their neighbours.  owners may be taking from their
+    // slots at the same time, so each entry is claimed with an atomic swap
+    //
+    result = FALSE;
+
+    for (coreIx = 0; coreIx < gData.mCpuCount; coreIx++)
+    {
+        pCore = K2OSKERN_COREIX_TO_CPUCORE(coreIx);
+        for (bucket = 0; bucket < K2OSKERN_VIRTCACHE_BUCKETS; bucket++)
+        {
+            for (slot = 0; slot < K2OSKERN_VIRTCACHE_SLOTS; slot++)
+            {
+                if (pCore->mVirtCache[bucket][slot] == 0)
+                    continue;
+
+                entry = K2ATOMIC_Exchange(&pCore->mVirtCache[bucket][slot], 0);
+                if (entry == 0)
+                    continue;
+
+                pHeapNode = K2HEAP_FindNodeContainingAddr(&gData.KernVirtHeap, entry & K2_VA32_PAGEFRAME_MASK);
+                K2_ASSERT(pHeapNode != NULL);
+                K2_ASSERT(K2HEAP_NodeSize(pHeapNode) == (entry & K2_VA32_MEMPAGE_OFFSET_MASK) * K2_VA32_MEMPAGE_BYTES);
+                stat = K2HEAP_FreeNode(&gData.KernVirtHeap, pHeapNode);
+                K2_ASSERT(!K2STAT_IS_ERROR(stat));
+
+                result = TRUE;
+            }
+        }
+    }
+
+    return result;
+}
+
 K2STAT KernMem_VirtAllocToThread(K2OSKERN_OBJ_THREAD *apCurThread, UINT32 aUseAddr, UINT32 aPageCount, BOOL aTopDown)
 {
     BOOL                    ok;
@@ -520,6 +839,20 @@ K2STAT KernMem_VirtAllocToThread(K2OSKERN_OBJ_THREAD *apCurThread, UINT32 aUseAd
     {
         K2_ASSERT((aUseAddr & K2_VA32_MEMPAGE_OFFSET_MASK) == 0);
     }
+    else if (aPageCount <= K2OSKERN_VIRTCACHE_MAX_PAGES)
+    {
+        //
+        // thread stacks, token pages and the like are usually the same size
+        // as something recently freed on this core
+        //
+        aUseAddr = sVirtCacheTake(aPageCount);
+        if (aUseAddr != 0)
+        {
+            apCurThread->mWorkVirt_Range = aUseAddr;
+            apCurThread->mWorkVirt_PageCount = aPageCount;
+            return K2STAT_NO_ERROR;
+        }
+    }
 
     ok = K2OS_CritSecEnter(&gData.KernVirtHeapSec);
     K2_ASSERT(ok);
@@ -597,17 +930,26 @@ K2STAT KernMem_VirtAllocToThread(K2OSKERN_OBJ_THREAD *apCurThread, UINT32 aUseAd
     if (aUseAddr != 0)
     {
         stat = K2HEAP_AllocAt(&gData.KernVirtHeap, aUseAddr, aPageCount * K2_VA32_MEMPAGE_BYTES);
+        if ((K2STAT_IS_ERROR(stat)) && (sVirtCacheDrainAllLocked()))
+        {
+            //
+            // the range may have been parked on this core
+            //
+            stat = K2HEAP_AllocAt(&gData.KernVirtHeap, aUseAddr, aPageCount * K2_VA32_MEMPAGE_BYTES);
+        }
     }
     else
     {
-        if (aTopDown)
-        {
-            aUseAddr = K2HEAP_AllocAlignedHighest(&gData.KernVirtHeap, aPageCount * K2_VA32_MEMPAGE_BYTES, K2_VA32_MEMPAGE_BYTES);
-        }
-        else
-        {
-            aUseAddr = K2HEAP_AllocAligned(&gData.KernVirtHeap, aPageCount * K2_VA32_MEMPAGE_BYTES, K2_VA32_MEMPAGE_BYTES);
-        }
+        do {
+            if (aTopDown)
+            {
+                aUseAddr = K2HEAP_AllocAlignedHighest(&gData.KernVirtHeap, aPageCount * K2_VA32_MEMPAGE_BYTES, K2_VA32_MEMPAGE_BYTES);
+            }
+            else
+            {
+                aUseAddr = K2HEAP_AllocAligned(&gData.KernVirtHeap, aPageCount * K2_VA32_MEMPAGE_BYTES, K2_VA32_MEMPAGE_BYTES);
+            }
+        } while ((aUseAddr == 0) && (sVirtCacheDrainAllLocked()));
         if (aUseAddr == 0)
             stat = K2STAT_ERROR_OUT_OF_MEMORY;
     }
@@ -633,6 +975,17 @@ void KernMem_VirtFreeFromThread(K2OSKERN_OBJ_THREAD *apCurThread)
     K2_ASSERT(apCurThread->mWorkVirt_Range != 0);
     K2_ASSERT(apCurThread->mWorkVirt_PageCount != 0);
 
+    if ((apCurThread->mWorkVirt_PageCount <= K2OSKERN_VIRTCACHE_MAX_PAGES) &&
+        (sVirtCachePut(apCurThread->mWorkVirt_Range, apCurThread->mWorkVirt_PageCount)))
+    {
+        //
+        // range stays allocated in the heap, parked on this core
+        //
+        apCurThread->mWorkVirt_Range = 0;
+        apCurThread->mWorkVirt_PageCount = 0;
+        return;
+    }
+
     ok = K2OS_CritSecEnter(&gData.KernVirtHeapSec);
     K2_ASSERT(ok);
 
@@ -654,84 +1007,473 @@ void KernMem_VirtFreeFromThread(K2OSKERN_OBJ_THREAD *apCurThread)
 
 #define PHYSPAGES_CHUNK 16
 
-K2STAT KernMem_PhysAllocToThread(K2OSKERN_OBJ_THREAD *apCurThread, UINT32 aPageCount, KernPhys_Disp aDisp, BOOL aForPageTables)
+static void sPhysZeroPoke(void);
+
+//
+// small cached allocations (page tables and single pages) are served from a per-core
+// cache of free pages so that the common case does not touch the physical memory lock.
+// only pages that can be mapped cached are kept on a core cache.  interrupts are off 
+// while a core works with its own cache so the thread cannot migrate off of the core
+//
+#define PHYSPAGES_CORECACHE_FASTMAX     4
+#define PHYSPAGES_CORECACHE_MAX         32
+#define PHYSPAGES_CORECACHE_SCANMAX     (PHYSPAGES_CHUNK * 4)
+
+static void sCoreCacheRefill(K2OSKERN_CPUCORE volatile *apThisCore)
 {
-    BOOL                        intrDisp;
+    K2LIST_ANCHOR *             pList;
+    K2LIST_ANCHOR *             pCache;
     K2LIST_LINK *               pListLink;
     K2OSKERN_PHYSTRACK_PAGE *   pPhysPage;
-    K2LIST_ANCHOR *             pList;
-    UINT32                      chunkLeft;
-    UINT32                      tookDirty;
-    UINT32                      tookClean;
-    UINT32                      flags;
-    K2TREE_NODE *               pTreeNode;
-    K2TREE_NODE *               pNextNode;
-    K2TREE_NODE *               pLeftOver;
-    UINT32                      nodeCount;
-    UINT32                      takePages;
-
-    K2_ASSERT(aPageCount > 0);
-    K2_ASSERT(aDisp < KernPhys_Disp_Count);
-
-    if (aForPageTables)
-    {
-        K2_ASSERT(apCurThread->WorkPtPages_Dirty.mNodeCount + apCurThread->WorkPtPages_Clean.mNodeCount == 0);
-    }
-    else
-    {
-        K2_ASSERT(apCurThread->WorkPages_Dirty.mNodeCount + apCurThread->WorkPages_Clean.mNodeCount == 0);
-    }
+    UINT32                      left;
+    UINT32                      scanLeft;
+    UINT32                      listIx;
+    KernPhysPageList            cacheListId;
 
     //
-    // first try to pull pages off clean page list
+    // core cache lock held. the scan is bounded so that free lists full of pages 
+    // that cannot be cached do not get walked end to end with the lock held
     //
-    tookClean = 0;
-    do {
-        intrDisp = K2OSKERN_SeqIntrLock(&gData.PhysMemSeqLock);
+    left = PHYSPAGES_CHUNK;
+    scanLeft = PHYSPAGES_CORECACHE_SCANMAX;
 
-        pList = &gData.PhysPageList[KernPhysPageList_Free_Clean];
+    K2OSKERN_SeqIntrLock(&gData.PhysMemSeqLock);
 
-        if (pList->mNodeCount == 0)
+    for (listIx = 0; listIx < 2; listIx++)
+    {
+        if (listIx == 0)
         {
-            //
-            // system clean pages list is empty
-            //
-            break;
+            pList = &gData.PhysPageList[KernPhysPageList_Free_Clean];
+            pCache = (K2LIST_ANCHOR *)&apThisCore->PhysCache_Clean;
+            cacheListId = KernPhysPageList_Core_Clean;
+        }
+        else
+        {
+            pList = &gData.PhysPageList[KernPhysPageList_Free_Dirty];
+            pCache = (K2LIST_ANCHOR *)&apThisCore->PhysCache_Dirty;
+            cacheListId = KernPhysPageList_Core_Dirty;
         }
-
-        chunkLeft = PHYSPAGES_CHUNK;
 
         pListLink = pList->mpHead;
-        do {
+        while ((left > 0) && (scanLeft > 0) && (pListLink != NULL))
+        {
             pPhysPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, pListLink, ListLink);
             pListLink = pListLink->mpNext;
+            scanLeft--;
 
-            switch (aDisp)
+            if (pPhysPage->mFlags & K2OSKERN_PHYSTRACK_PROP_WB_CAP)
             {
-            case KernPhys_Disp_Uncached:
-                //
-                // if region cannot be uncached then set pPhysPage = NULL;
-                //
-                if ((pPhysPage->mFlags & K2OSKERN_PHYSTRACK_PROPMASK_UNCACHEABLE) == 0)
-                    pPhysPage = NULL;
-                break;
+                K2LIST_Remove(pList, &pPhysPage->ListLink);
+                pPhysPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
+                pPhysPage->mFlags |= (cacheListId << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+                K2LIST_AddAtTail(pCache, &pPhysPage->ListLink);
+                left--;
+            }
+        }
+    }
 
-            case KernPhys_Disp_Cached_WriteThrough:
-                if ((pPhysPage->mFlags & K2OSKERN_PHYSTRACK_PROP_WT_CAP) == 0)
-                    pPhysPage = NULL;
-                break;
+    sMemStatsNotePhysTaken();
 
-            case KernPhys_Disp_Cached:
-                if ((pPhysPage->mFlags & K2OSKERN_PHYSTRACK_PROP_WB_CAP) == 0)
-                    pPhysPage = NULL;
-                break;
+    K2OSKERN_SeqIntrUnlock(&gData.PhysMemSeqLock, FALSE);
+}
 
-            default:
-                K2_ASSERT(0);
-                break;
-            }
+static BOOL sCoreCacheAllocToThread(K2OSKERN_OBJ_THREAD *apCurThread, UINT32 aPageCount, BOOL aForPageTables)
+{
+    BOOL                        disp;
+    K2OSKERN_CPUCORE volatile * pThisCore;
+    K2LIST_ANCHOR *             pCache;
+    K2OSKERN_PHYSTRACK_PAGE *   pPhysPage;
 
-            if (pPhysPage != NULL)
+    disp = K2OSKERN_SetIntr(FALSE);
+
+    pThisCore = K2OSKERN_GET_CURRENT_CPUCORE;
+
+    K2OSKERN_SeqIntrLock((K2OSKERN_SEQLOCK *)&pThisCore->PhysCacheSeqLock);
+
+    if ((pThisCore->PhysCache_Clean.mNodeCount + pThisCore->PhysCache_Dirty.mNodeCount) < aPageCount)
+    {
+        sCoreCacheRefill(pThisCore);
+        if ((pThisCore->PhysCache_Clean.mNodeCount + pThisCore->PhysCache_Dirty.mNodeCount) < aPageCount)
+        {
+            //
+            // let the slow path sort it out
+            //
+            K2OSKERN_SeqIntrUnlock((K2OSKERN_SEQLOCK *)&pThisCore->PhysCacheSeqLock, FALSE);
+            K2OSKERN_SetIntr(disp);
+            return FALSE;
+        }
+    }
+
+    do {
+        pCache = (K2LIST_ANCHOR *)&pThisCore->PhysCache_Clean;
+        if (pCache->mNodeCount > 0)
+        {
+            pPhysPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, pCache->mpHead, ListLink);
+            K2LIST_Remove(pCache, &pPhysPage->ListLink);
+            pPhysPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
+            if (aForPageTables)
+            {
+                pPhysPage->mFlags |= (KernPhysPageList_Thread_PtClean << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+                K2LIST_AddAtTail(&apCurThread->WorkPtPages_Clean, &pPhysPage->ListLink);
+            }
+            else
+            {
+                pPhysPage->mFlags |= (KernPhysPageList_Thread_Clean << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+                K2LIST_AddAtTail(&apCurThread->WorkPages_Clean, &pPhysPage->ListLink);
+            }
+        }
+        else
+        {
+            pCache = (K2LIST_ANCHOR *)&pThisCore->PhysCache_Dirty;
+            pPhysPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, pCache->mpHead, ListLink);
+            K2LIST_Remove(pCache, &pPhysPage->ListLink);
+            pPhysPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
+            if (aForPageTables)
+            {
+                pPhysPage->mFlags |= (KernPhysPageList_Thread_PtDirty << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+                K2LIST_AddAtTail(&apCurThread->WorkPtPages_Dirty, &pPhysPage->ListLink);
+            }
+            else
+            {
+                pPhysPage->mFlags |= (KernPhysPageList_Thread_Dirty << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+                K2LIST_AddAtTail(&apCurThread->WorkPages_Dirty, &pPhysPage->ListLink);
+            }
+        }
+    } while (--aPageCount);
+
+    K2OSKERN_SeqIntrUnlock((K2OSKERN_SEQLOCK *)&pThisCore->PhysCacheSeqLock, FALSE);
+
+    K2OSKERN_SetIntr(disp);
+
+    return TRUE;
+}
+
+static void sCoreCacheTakeList(K2OSKERN_CPUCORE volatile *apThisCore, K2LIST_ANCHOR *apThreadList, BOOL aClean)
+{
+    K2LIST_ANCHOR *             pCache;
+    K2LIST_LINK *               pListLink;
+    K2OSKERN_PHYSTRACK_PAGE *   pPhysPage;
+
+    pCache = aClean ? (K2LIST_ANCHOR *)&apThisCore->PhysCache_Clean : (K2LIST_ANCHOR *)&apThisCore->PhysCache_Dirty;
+
+    pListLink = apThreadList->mpHead;
+    while (pListLink != NULL)
+    {
+        if ((apThisCore->PhysCache_Clean.mNodeCount + apThisCore->PhysCache_Dirty.mNodeCount) >= PHYSPAGES_CORECACHE_MAX)
+            break;
+
+        pPhysPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, pListLink, ListLink);
+        pListLink = pListLink->mpNext;
+
+        if (pPhysPage->mFlags & K2OSKERN_PHYSTRACK_PROP_WB_CAP)
+        {
+            K2LIST_Remove(apThreadList, &pPhysPage->ListLink);
+            pPhysPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
+            pPhysPage->mFlags |= ((aClean ? KernPhysPageList_Core_Clean : KernPhysPageList_Core_Dirty) << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+            K2LIST_AddAtTail(pCache, &pPhysPage->ListLink);
+        }
+    }
+}
+
+static void sCoreCacheFreeFromThread(K2OSKERN_OBJ_THREAD *apCurThread)
+{
+    BOOL                        disp;
+    K2OSKERN_CPUCORE volatile * pThisCore;
+
+    disp = K2OSKERN_SetIntr(FALSE);
+
+    pThisCore = K2OSKERN_GET_CURRENT_CPUCORE;
+
+    K2OSKERN_SeqIntrLock((K2OSKERN_SEQLOCK *)&pThisCore->PhysCacheSeqLock);
+
+    sCoreCacheTakeList(pThisCore, &apCurThread->WorkPtPages_Clean, TRUE);
+    sCoreCacheTakeList(pThisCore, &apCurThread->WorkPages_Clean, TRUE);
+    sCoreCacheTakeList(pThisCore, &apCurThread->WorkPtPages_Dirty, FALSE);
+    sCoreCacheTakeList(pThisCore, &apCurThread->WorkPages_Dirty, FALSE);
+
+    K2OSKERN_SeqIntrUnlock((K2OSKERN_SEQLOCK *)&pThisCore->PhysCacheSeqLock, FALSE);
+
+    K2OSKERN_SetIntr(disp);
+}
+
+static void sCoreCacheDrainList(K2LIST_ANCHOR *apCache, KernPhysPageList aFreeList)
+{
+    K2OSKERN_PHYSTRACK_PAGE *   pPhysPage;
+
+    while (apCache->mNodeCount > 0)
+    {
+        pPhysPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, apCache->mpHead, ListLink);
+        K2LIST_Remove(apCache, &pPhysPage->ListLink);
+        pPhysPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
+        pPhysPage->mFlags |= (aFreeList << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+        K2LIST_AddAtTail(&gData.PhysPageList[aFreeList], &pPhysPage->ListLink);
+    }
+}
+
+static UINT32 sCoreCacheDrainAll(void)
+{
+    K2OSKERN_CPUCORE volatile * pCore;
+    UINT32                      coreIx;
+    UINT32                      drained;
+    BOOL                        disp;
+
+    //
+    // put every core's cached pages and pagetable pool back on the global free lists.
+    // done before an allocation is failed so that pages parked on other cores are
+    // not left out.  pool pages are zeroed so they go back on the clean list
+    //
+    drained = 0;
+
+    for (coreIx = 0; coreIx < gData.mCpuCount; coreIx++)
+    {
+        pCore = K2OSKERN_COREIX_TO_CPUCORE(coreIx);
+
+        disp = K2OSKERN_SeqIntrLock((K2OSKERN_SEQLOCK *)&pCore->PhysCacheSeqLock);
+
+        if ((pCore->PhysCache_Clean.mNodeCount + pCore->PhysCache_Dirty.mNodeCount + pCore->PtPool.mNodeCount) > 0)
+        {
+            drained += pCore->PhysCache_Clean.mNodeCount + pCore->PhysCache_Dirty.mNodeCount + pCore->PtPool.mNodeCount;
+
+            K2OSKERN_SeqIntrLock(&gData.PhysMemSeqLock);
+            sCoreCacheDrainList((K2LIST_ANCHOR *)&pCore->PhysCache_Clean, KernPhysPageList_Free_Clean);
+            sCoreCacheDrainList((K2LIST_ANCHOR *)&pCore->PhysCache_Dirty, KernPhysPageList_Free_Dirty);
+            sCoreCacheDrainList((K2LIST_ANCHOR *)&pCore->PtPool, KernPhysPageList_Free_Clean);
+            K2OSKERN_SeqIntrUnlock(&gData.PhysMemSeqLock, FALSE);
+        }
+
+        K2OSKERN_SeqIntrUnlock((K2OSKERN_SEQLOCK *)&pCore->PhysCacheSeqLock, disp);
+    }
+
+    return drained;
+}
+
+//
+// pagetable pages are handed out from a per-core pool of pages that are known to be zero.
+// the pool is topped up to the high water mark from the free clean list (which the zeroing
+// thread keeps stocked in the background) whenever it falls below the low water mark, and
+// pagetables that empty out are kept in the pool up to the high water mark for reuse rather
+// than going back to the global lists.  the gap between the marks keeps a core that is
+// mapping and unmapping around a pagetable boundary from bouncing pages through the lock.
+// the pool is covered by the core's page cache lock.  the zeroing thread tops up every
+// core's pool in the background so that the refill is rarely done on the allocating path
+//
+#define PHYSPAGES_PTPOOL_LOW    2
+#define PHYSPAGES_PTPOOL_HIGH   8
+
+static void sPtPoolRefill(K2OSKERN_CPUCORE volatile *apCore)
+{
+    K2LIST_ANCHOR *             pList;
+    K2LIST_LINK *               pListLink;
+    K2OSKERN_PHYSTRACK_PAGE *   pPhysPage;
+    UINT32                      scanLeft;
+
+    //
+    // interrupts are off and the core's page cache lock is held
+    //
+    pList = &gData.PhysPageList[KernPhysPageList_Free_Clean];
+    scanLeft = PHYSPAGES_CORECACHE_SCANMAX;
+
+    K2OSKERN_SeqIntrLock(&gData.PhysMemSeqLock);
+
+    pListLink = pList->mpHead;
+    while ((apCore->PtPool.mNodeCount < PHYSPAGES_PTPOOL_HIGH) && (pListLink != NULL) && (scanLeft > 0))
+    {
+        pPhysPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, pListLink, ListLink);
+        pListLink = pListLink->mpNext;
+        scanLeft--;
+
+        if (pPhysPage->mFlags & K2OSKERN_PHYSTRACK_PROP_WB_CAP)
+        {
+            K2LIST_Remove(pList, &pPhysPage->ListLink);
+            pPhysPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
+            pPhysPage->mFlags |= (KernPhysPageList_Core_PtPool << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+            K2LIST_AddAtTail((K2LIST_ANCHOR *)&apCore->PtPool, &pPhysPage->ListLink);
+        }
+    }
+
+    sMemStatsNotePhysTaken();
+
+    K2OSKERN_SeqIntrUnlock(&gData.PhysMemSeqLock, FALSE);
+
+    apCore->PtPoolStats.mRefills++;
+}
+
+static void sPtPoolTopUpAll(void)
+{
+    K2OSKERN_CPUCORE volatile * pCore;
+    UINT32                      coreIx;
+    BOOL                        disp;
+
+    for (coreIx = 0; coreIx < gData.mCpuCount; coreIx++)
+    {
+        pCore = K2OSKERN_COREIX_TO_CPUCORE(coreIx);
+
+        disp = K2OSKERN_SeqIntrLock((K2OSKERN_SEQLOCK *)&pCore->PhysCacheSeqLock);
+
+        if ((pCore->PtPool.mNodeCount < PHYSPAGES_PTPOOL_HIGH) &&
+            (gData.PhysPageList[KernPhysPageList_Free_Clean].mNodeCount > 0))
+        {
+            sPtPoolRefill(pCore);
+        }
+
+        K2OSKERN_SeqIntrUnlock((K2OSKERN_SEQLOCK *)&pCore->PhysCacheSeqLock, disp);
+    }
+}
+
+static BOOL sPtPoolAllocToThread(K2OSKERN_OBJ_THREAD *apCurThread, UINT32 aPageCount)
+{
+    BOOL                        disp;
+    K2OSKERN_CPUCORE volatile * pThisCore;
+    K2OSKERN_PHYSTRACK_PAGE *   pPhysPage;
+
+    disp = K2OSKERN_SetIntr(FALSE);
+
+    pThisCore = K2OSKERN_GET_CURRENT_CPUCORE;
+
+    K2OSKERN_SeqIntrLock((K2OSKERN_SEQLOCK *)&pThisCore->PhysCacheSeqLock);
+
+    if ((pThisCore->PtPool.mNodeCount < aPageCount) ||
+        (pThisCore->PtPool.mNodeCount < PHYSPAGES_PTPOOL_LOW))
+    {
+        sPtPoolRefill(pThisCore);
+        if (pThisCore->PtPool.mNodeCount < aPageCount)
+        {
+            //
+            // let the core cache or slow path sort it out
+            //
+            K2OSKERN_SeqIntrUnlock((K2OSKERN_SEQLOCK *)&pThisCore->PhysCacheSeqLock, FALSE);
+            K2OSKERN_SetIntr(disp);
+            return FALSE;
+        }
+    }
+
+    pThisCore->PtPoolStats.mAllocs += aPageCount;
+    pThisCore->PtPoolStats.mPoolHits += aPageCount;
+
+    do {
+        pPhysPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, pThisCore->PtPool.mpHead, ListLink);
+        K2LIST_Remove((K2LIST_ANCHOR *)&pThisCore->PtPool, &pPhysPage->ListLink);
+        pPhysPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
+        pPhysPage->mFlags |= (KernPhysPageList_Thread_PtClean << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+        K2LIST_AddAtTail(&apCurThread->WorkPtPages_Clean, &pPhysPage->ListLink);
+    } while (--aPageCount);
+
+    K2OSKERN_SeqIntrUnlock((K2OSKERN_SEQLOCK *)&pThisCore->PhysCacheSeqLock, FALSE);
+
+    K2OSKERN_SetIntr(disp);
+
+    return TRUE;
+}
+
+static void sPtPoolFreeFromThread(K2OSKERN_OBJ_THREAD *apCurThread)
+{
+    BOOL                        disp;
+    K2OSKERN_CPUCORE volatile * pThisCore;
+    K2LIST_LINK *               pListLink;
+    K2OSKERN_PHYSTRACK_PAGE *   pPhysPage;
+
+    if (apCurThread->WorkPtPages_Clean.mNodeCount == 0)
+        return;
+
+    disp = K2OSKERN_SetIntr(FALSE);
+
+    pThisCore = K2OSKERN_GET_CURRENT_CPUCORE;
+
+    K2OSKERN_SeqIntrLock((K2OSKERN_SEQLOCK *)&pThisCore->PhysCacheSeqLock);
+
+    pListLink = apCurThread->WorkPtPages_Clean.mpHead;
+    while (pListLink != NULL)
+    {
+        pPhysPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, pListLink, ListLink);
+        pListLink = pListLink->mpNext;
+
+        if (pThisCore->PtPool.mNodeCount >= PHYSPAGES_PTPOOL_HIGH)
+        {
+            pThisCore->PtPoolStats.mReleased++;
+            continue;
+        }
+
+        if (pPhysPage->mFlags & K2OSKERN_PHYSTRACK_PROP_WB_CAP)
+        {
+            K2LIST_Remove(&apCurThread->WorkPtPages_Clean, &pPhysPage->ListLink);
+            pPhysPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
+            pPhysPage->mFlags |= (KernPhysPageList_Core_PtPool << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+            K2LIST_AddAtHead((K2LIST_ANCHOR *)&pThisCore->PtPool, &pPhysPage->ListLink);
+            pThisCore->PtPoolStats.mRecycled++;
+        }
+    }
+
+    K2OSKERN_SeqIntrUnlock((K2OSKERN_SEQLOCK *)&pThisCore->PhysCacheSeqLock, FALSE);
+
+    K2OSKERN_SetIntr(disp);
+}
+
+static K2STAT sPhysAllocFromGlobalToThread(K2OSKERN_OBJ_THREAD *apCurThread, UINT32 aPageCount, KernPhys_Disp aDisp, BOOL aForPageTables)
+{
+    BOOL                        intrDisp;
+    K2LIST_LINK *               pListLink;
+    K2OSKERN_PHYSTRACK_PAGE *   pPhysPage;
+    K2LIST_ANCHOR *             pList;
+    UINT32                      chunkLeft;
+    UINT32                      tookDirty;
+    UINT32                      tookClean;
+    UINT32                      flags;
+    K2TREE_NODE *               pTreeNode;
+    K2TREE_NODE *               pNextNode;
+    K2TREE_NODE *               pLeftOver;
+    UINT32                      nodeCount;
+    UINT32                      takePages;
+
+    //
+    // first try to pull pages off clean page list
+    //
+    tookClean = 0;
+    do {
+        intrDisp = K2OSKERN_SeqIntrLock(&gData.PhysMemSeqLock);
+
+        pList = &gData.PhysPageList[KernPhysPageList_Free_Clean];
+
+        if (pList->mNodeCount == 0)
+        {
+            //
+            // system clean pages list is empty
+            //
+            break;
+        }
+
+        chunkLeft = PHYSPAGES_CHUNK;
+
+        pListLink = pList->mpHead;
+        do {
+            pPhysPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, pListLink, ListLink);
+            pListLink = pListLink->mpNext;
+
+            switch (aDisp)
+            {
+            case KernPhys_Disp_Uncached:
+                //
+                // if region cannot be uncached then set pPhysPage = NULL;
+                //
+                if ((pPhysPage->mFlags & K2OSKERN_PHYSTRACK_PROPMASK_UNCACHEABLE) == 0)
+                    pPhysPage = NULL;
+                break;
+
+            case KernPhys_Disp_Cached_WriteThrough:
+                if ((pPhysPage->mFlags & K2OSKERN_PHYSTRACK_PROP_WT_CAP) == 0)
+                    pPhysPage = NULL;
+                break;
+
+            case KernPhys_Disp_Cached:
+                if ((pPhysPage->mFlags & K2OSKERN_PHYSTRACK_PROP_WB_CAP) == 0)
+                    pPhysPage = NULL;
+                break;
+
+            default:
+                K2_ASSERT(0);
+                break;
+            }
+
+            if (pPhysPage != NULL)
             {
                 K2LIST_Remove(pList, &pPhysPage->ListLink);
                 pPhysPage->mFlags &= ~(K2OSKERN_PHYSTRACK_PAGE_LIST_MASK | K2OSKERN_PHYSTRACK_UNALLOC_FLAG);
@@ -780,6 +1522,7 @@ K2STAT KernMem_PhysAllocToThread(K2OSKERN_OBJ_THREAD *apCurThread, UINT32 aPageC
 
     if (aPageCount == 0)
     {
+        sMemStatsNotePhysTaken();
         K2OSKERN_SeqIntrUnlock(&gData.PhysMemSeqLock, intrDisp);
         return K2STAT_NO_ERROR;
     }
@@ -880,6 +1623,7 @@ K2STAT KernMem_PhysAllocToThread(K2OSKERN_OBJ_THREAD *apCurThread, UINT32 aPageC
 
     if (aPageCount == 0)
     {
+        sMemStatsNotePhysTaken();
         K2OSKERN_SeqIntrUnlock(&gData.PhysMemSeqLock, intrDisp);
         return K2STAT_NO_ERROR;
     }
@@ -1057,6 +1801,8 @@ K2STAT KernMem_PhysAllocToThread(K2OSKERN_OBJ_THREAD *apCurThread, UINT32 aPageC
 
             pPhysPage = (K2OSKERN_PHYSTRACK_PAGE *)pTreeNode;
 
+            gData.MemStats.mPhysFreeTreePages -= takePages;
+
             if (aForPageTables)
             {
                 do {
@@ -1088,11 +1834,69 @@ K2STAT KernMem_PhysAllocToThread(K2OSKERN_OBJ_THREAD *apCurThread, UINT32 aPageC
 
     } while (pTreeNode != NULL);
 
+    sMemStatsNotePhysTaken();
+
     K2OSKERN_SeqIntrUnlock(&gData.PhysMemSeqLock, intrDisp);
 
     return K2STAT_NO_ERROR;
 }
 
+K2STAT KernMem_PhysAllocToThread(K2OSKERN_OBJ_THREAD *apCurThread, UINT32 aPageCount, KernPhys_Disp aDisp, BOOL aForPageTables)
+{
+    K2STAT  stat;
+    BOOL    disp;
+
+    K2_ASSERT(aPageCount > 0);
+    K2_ASSERT(aDisp < KernPhys_Disp_Count);
+
+    sPhysZeroPoke();
+
+    if (aForPageTables)
+    {
+        K2_ASSERT(apCurThread->WorkPtPages_Dirty.mNodeCount + apCurThread->WorkPtPages_Clean.mNodeCount == 0);
+    }
+    else
+    {
+        K2_ASSERT(apCurThread->WorkPages_Dirty.mNodeCount + apCurThread->WorkPages_Clean.mNodeCount == 0);
+    }
+
+    if ((aForPageTables) &&
+        (aDisp == KernPhys_Disp_Cached) &&
+        (aPageCount <= PHYSPAGES_PTPOOL_HIGH))
+    {
+        if (sPtPoolAllocToThread(apCurThread, aPageCount))
+            return K2STAT_NO_ERROR;
+    }
+
+    if ((aDisp == KernPhys_Disp_Cached) &&
+        (aPageCount <= PHYSPAGES_CORECACHE_FASTMAX) &&
+        (sCoreCacheAllocToThread(apCurThread, aPageCount, aForPageTables)))
+    {
+        stat = K2STAT_NO_ERROR;
+    }
+    else
+    {
+        stat = sPhysAllocFromGlobalToThread(apCurThread, aPageCount, aDisp, aForPageTables);
+        if ((stat == K2STAT_ERROR_OUT_OF_MEMORY) &&
+            (0 != sCoreCacheDrainAll()))
+        {
+            //
+            // pages were parked on core caches or pools. try once more now that they are back
+            //
+            stat = sPhysAllocFromGlobalToThread(apCurThread, aPageCount, aDisp, aForPageTables);
+        }
+    }
+
+    if ((!K2STAT_IS_ERROR(stat)) && (aForPageTables))
+    {
+        disp = K2OSKERN_SetIntr(FALSE);
+        K2OSKERN_GET_CURRENT_CPUCORE->PtPoolStats.mAllocs += aPageCount;
+        K2OSKERN_SetIntr(disp);
+    }
+
+    return stat;
+}
+
 void KernMem_PhysFreeFromThread(K2OSKERN_OBJ_THREAD *apCurThread)
 {
     BOOL                        disp;
@@ -1100,6 +1904,20 @@ void KernMem_PhysFreeFromThread(K2OSKERN_OBJ_THREAD *apCurThread)
     K2OSKERN_PHYSTRACK_PAGE *   pPhysPage;
     UINT32                      pagesMoved;
 
+    sPtPoolFreeFromThread(apCurThread);
+    sCoreCacheFreeFromThread(apCurThread);
+
+    if ((apCurThread->WorkPages_Dirty.mNodeCount +
+         apCurThread->WorkPages_Clean.mNodeCount +
+         apCurThread->WorkPtPages_Dirty.mNodeCount +
+         apCurThread->WorkPtPages_Clean.mNodeCount) == 0)
+    {
+        //
+        // everything fit in this core's page cache
+        //
+        return;
+    }
+
     pagesMoved = 0;
 
     disp = K2OSKERN_SeqIntrLock(&gData.PhysMemSeqLock);
@@ -1179,7 +1997,7 @@ void KernMem_PhysFreeFromThread(K2OSKERN_OBJ_THREAD *apCurThread)
     K2OSKERN_SeqIntrUnlock(&gData.PhysMemSeqLock, disp);
 }
 
-static void sCleanPageOnThisCore(UINT32 aPhysPage)
+static void sZeroPageOnThisCore(UINT32 aPhysPage)
 {
     BOOL                        disp;
     K2OSKERN_CPUCORE volatile * pThisCore;
@@ -1206,6 +2024,157 @@ static void sCleanPageOnThisCore(UINT32 aPhysPage)
     K2OSKERN_SetIntr(disp);
 }
 
+static void sCleanPageOnThisCore(UINT32 aPhysPage)
+{
+    K2ATOMIC_Inc(&gData.PhysZero.mInlineCount);
+    sZeroPageOnThisCore(aPhysPage);
+}
+
+#define PHYSZERO_BATCH      16
+#define PHYSZERO_POLL_MS    250
+
+static void sPhysZeroPoke(void)
+{
+    //
+    // unsynchronized peek is fine. worst case the zeroing thread
+    // finds its poll interval expires and does the work then.  only the
+    // allocation that takes the clean list below the low water mark
+    // sets the event. the rest see the wake is already pending
+    //
+    if ((gData.PhysZero.mTokWakeEvent == NULL) ||
+        (!K2OSKERN_GetIntr()))
+        return;
+
+    if ((gData.PhysPageList[KernPhysPageList_Free_Clean].mNodeCount < gData.PhysZero.mLowWater) &&
+        (gData.PhysPageList[KernPhysPageList_Free_Dirty].mNodeCount > 0) &&
+        (0 == gData.PhysZero.mWakePending) &&
+        (0 == K2ATOMIC_CompareExchange32(&gData.PhysZero.mWakePending, 1, 0)))
+    {
+        K2OS_EventSet(gData.PhysZero.mTokWakeEvent);
+    }
+}
+
+static UINT32 sPhysZeroBatch(K2OSKERN_OBJ_THREAD *apThisThread)
+{
+    BOOL                        intrDisp;
+    K2LIST_ANCHOR *             pDirtyList;
+    K2LIST_ANCHOR *             pCleanList;
+    K2OSKERN_PHYSTRACK_PAGE *   pPhysPage;
+    K2LIST_LINK *               pListLink;
+    UINT32                      count;
+
+    K2_ASSERT(apThisThread->WorkPages_Dirty.mNodeCount == 0);
+
+    pDirtyList = &gData.PhysPageList[KernPhysPageList_Free_Dirty];
+    pCleanList = &gData.PhysPageList[KernPhysPageList_Free_Clean];
+
+    //
+    // pull a batch of dirty pages onto this thread's dirty work list
+    //
+    count = 0;
+    intrDisp = K2OSKERN_SeqIntrLock(&gData.PhysMemSeqLock);
+    while ((count < PHYSZERO_BATCH) &&
+           (pDirtyList->mNodeCount > 0) &&
+           ((pCleanList->mNodeCount + count) < gData.PhysZero.mHighWater))
+    {
+        pPhysPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, pDirtyList->mpHead, ListLink);
+        K2LIST_Remove(pDirtyList, &pPhysPage->ListLink);
+        pPhysPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
+        pPhysPage->mFlags |= (KernPhysPageList_Thread_Dirty << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+        K2LIST_AddAtTail(&apThisThread->WorkPages_Dirty, &pPhysPage->ListLink);
+        count++;
+    }
+    K2OSKERN_SeqIntrUnlock(&gData.PhysMemSeqLock, intrDisp);
+
+    if (count == 0)
+        return 0;
+
+    //
+    // clean them without holding the physical memory lock
+    //
+    pListLink = apThisThread->WorkPages_Dirty.mpHead;
+    do {
+        pPhysPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, pListLink, ListLink);
+        pListLink = pListLink->mpNext;
+        sZeroPageOnThisCore(K2OS_PHYSTRACK_TO_PHYS32((UINT32)pPhysPage));
+    } while (pListLink != NULL);
+
+    //
+    // and put them on the clean list
+    //
+    intrDisp = K2OSKERN_SeqIntrLock(&gData.PhysMemSeqLock);
+    do {
+        pPhysPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, apThisThread->WorkPages_Dirty.mpHead, ListLink);
+        K2LIST_Remove(&apThisThread->WorkPages_Dirty, &pPhysPage->ListLink);
+        pPhysPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
+        pPhysPage->mFlags |= (KernPhysPageList_Free_Clean << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+        K2LIST_AddAtTail(pCleanList, &pPhysPage->ListLink);
+    } while (apThisThread->WorkPages_Dirty.mNodeCount > 0);
+    K2OSKERN_SeqIntrUnlock(&gData.PhysMemSeqLock, intrDisp);
+
+    K2ATOMIC_Add(&gData.PhysZero.mBackgroundCount, count);
+
+    return count;
+}
+
+static UINT32 K2_CALLCONV_REGS sPhysZeroThread(void *apArg)
+{
+    K2OSKERN_OBJ_THREAD *   pThisThread;
+
+    pThisThread = K2OSKERN_CURRENT_THREAD;
+
+    //
+    // this thread runs at idle priority, so batches only get done when 
+    // cores have nothing better to do.  it is poked by allocations that 
+    // drop the clean list below the low water mark, and polls otherwise.
+    // after cleaning it tops up the pagetable pools of all the cores
+    //
+    do {
+        K2OS_ThreadWait(1, &gData.PhysZero.mTokWakeEvent, FALSE, PHYSZERO_POLL_MS);
+
+        while (0 != sPhysZeroBatch(pThisThread));
+
+        sPtPoolTopUpAll();
+
+        //
+        // clean list is back up to the high water mark or there is nothing
+        // left to clean. the next drop below low water wakes us again
+        //
+        gData.PhysZero.mWakePending = 0;
+
+    } while (1);
+
+    return 0;
+}
+
+void KernMem_StartZeroThread(void)
+{
+    K2OS_THREADCREATE   cret;
+    K2OS_TOKEN          tokThread;
+    K2OS_TOKEN          tokEvent;
+
+    K2_ASSERT(gData.mKernInitStage >= KernInitStage_MemReady);
+
+    tokEvent = K2OS_EventCreate(NULL, TRUE, FALSE);
+    K2_ASSERT(tokEvent != NULL);
+
+    K2MEM_Zero(&cret, sizeof(cret));
+    cret.mStructBytes = sizeof(cret);
+    cret.mEntrypoint = sPhysZeroThread;
+    cret.Attr.mFieldMask = K2OS_THREADATTR_PRIORITY;
+    cret.Attr.mPriority = K2OS_THREADPRIO_IDLE;
+
+    gData.PhysZero.mTokWakeEvent = tokEvent;
+
+    tokThread = K2OS_ThreadCreate(&cret);
+    K2_ASSERT(tokThread != NULL);
+
+    //
+    // thread holds its own reference
+    //
+    K2OS_TokenDestroy(tokThread);
+}
+
 static KernPhysPageList sGetSegTargetPageList(K2OSKERN_OBJ_SEGMENT *apSegSrc)
 {
     UINT32              segType;
@@ -1265,6 +2234,7 @@ static KernPhysPageList sGetSegTargetPageList(K2OSKERN_OBJ_SEGMENT *apSegSrc)
         break;
 
     case K2OSKERN_SEG_ATTR_TYPE_DEVMAP:
+    case K2OSKERN_SEG_ATTR_TYPE_LENT:
         targetPageList = KernPhysPageList_Error;
         break;
 
@@ -1297,6 +2267,8 @@ K2STAT KernMem_CreateSegmentFromThread(K2OSKERN_OBJ_THREAD *apCurThread, K2OSKER
     K2OSKERN_PHYSTRACK_PAGE *   pPhysPage;
     K2OSKERN_OBJ_PROCESS *      pTargetProc;
     void *                      pPhysPageOwner;
+    UINT32                      largePhys;
+    UINT32                      mappedPages;
 
     //
     // virtual space for segment must have been allocated to thread
@@ -1415,18 +2387,48 @@ K2STAT KernMem_CreateSegmentFromThread(K2OSKERN_OBJ_THREAD *apCurThread, K2OSKER
         cleanAfter = (apCurThread->mWorkMapAttr & K2OS_MEMPAGE_ATTR_WRITEABLE) ? TRUE : FALSE;
         targetPageList = sGetSegTargetPageList(apSegSrc);
         pPhysPageOwner = (apDst == NULL) ? apSegSrc : apDst;
+        mappedPages = apCurThread->WorkPages_Clean.mNodeCount + apCurThread->WorkPages_Dirty.mNodeCount;
     }
     else
     {
-        apCurThread->mWorkMapAttr = K2OSKERN_PTE_NP_TYPE_NOT_COMMITTED | K2OSKERN_PTE_NP_BIT;
+        if (apSegSrc->mSegAndMemPageAttr & K2OSKERN_SEG_ATTR_DEMAND_ZERO)
+        {
+            //
+            // pages get physical memory when they are first touched
+            //
+            apCurThread->mWorkMapAttr = K2OSKERN_PTE_NP_COMMITTED;
+        }
+        else
+        {
+            apCurThread->mWorkMapAttr = K2OSKERN_PTE_NP_TYPE_NOT_COMMITTED | K2OSKERN_PTE_NP_BIT;
+        }
         cleanAfter = FALSE;
         targetPageList = KernPhysPageList_Error;
         pPhysPageOwner = NULL;
+        mappedPages = 0;
     }
 
     lockStatus = FALSE;
 
     do {
+        if ((segType == K2OSKERN_SEG_ATTR_TYPE_CONTIG_PHYS) &&
+            (0 != (apSegSrc->mSegAndMemPageAttr & K2OSKERN_SEG_ATTR_LARGE_PAGES)) &&
+            (0 == (virtAddr & (K2_VA32_PAGETABLE_MAP_BYTES - 1))) &&
+            (pageCount >= K2_VA32_ENTRIES_PER_PAGETABLE))
+        {
+            //
+            // whole 4MB chunk with matching physical alignment does not need a pagetable
+            //
+            largePhys = apSegSrc->Info.ContigPhys.mPhysAddr + (virtAddr - apCurThread->mWorkVirt_Range);
+            if ((0 == (largePhys & (K2_VA32_PAGETABLE_MAP_BYTES - 1))) &&
+                (KernMap_MakeLargePage(virtAddr, largePhys, apSegSrc->mSegAndMemPageAttr)))
+            {
+                virtAddr += K2_VA32_PAGETABLE_MAP_BYTES;
+                pageCount -= (K2_VA32_ENTRIES_PER_PAGETABLE - 1);
+                continue;
+            }
+        }
+
         apCurThread->mWorkMapAddr = virtAddr;
 
         //
@@ -1501,6 +2503,7 @@ K2STAT KernMem_CreateSegmentFromThread(K2OSKERN_OBJ_THREAD *apCurThread, K2OSKER
 
         if (cleanAfter)
         {
+            K2ATOMIC_Inc(&gData.PhysZero.mInlineCount);
             K2MEM_Zero((void *)virtAddr, K2_VA32_MEMPAGE_BYTES);
         }
 
@@ -1520,32 +2523,21 @@ K2STAT KernMem_CreateSegmentFromThread(K2OSKERN_OBJ_THREAD *apCurThread, K2OSKER
     }
 
     //
-    // free any unused pagetables pages back to system free clean list
+    // return any unused pagetables pages.  they are still zero so they go back
+    // into this core's pagetable pool first
     //
     if ((apCurThread->mpWorkPtPage != NULL) || (apCurThread->WorkPtPages_Clean.mNodeCount > 0))
     {
-        disp = K2OSKERN_SetIntr(FALSE);
-
         if (apCurThread->mpWorkPtPage != NULL)
         {
             pPhysPage = apCurThread->mpWorkPtPage;
             pPhysPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
-            pPhysPage->mFlags |= (KernPhysPageList_Thread_PtWorking << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+            pPhysPage->mFlags |= (KernPhysPageList_Thread_PtClean << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
             K2LIST_AddAtHead(&apCurThread->WorkPtPages_Clean, &pPhysPage->ListLink);
             apCurThread->mpWorkPtPage = NULL;
         }
 
-        do {
-            pPhysPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, apCurThread->WorkPtPages_Clean.mpHead, ListLink);
-
-            K2LIST_Remove(&apCurThread->WorkPtPages_Clean, &pPhysPage->ListLink);
-            pPhysPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
-            pPhysPage->mFlags |= (KernPhysPageList_Free_Clean << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
-            K2LIST_AddAtTail(&gData.PhysPageList[KernPhysPageList_Free_Clean], &pPhysPage->ListLink);
-
-        } while (apCurThread->WorkPtPages_Clean.mNodeCount > 0);
-
-        K2OSKERN_SetIntr(disp);
+        KernMem_PhysFreeFromThread(apCurThread);
     }
 
     //
@@ -1576,6 +2568,14 @@ K2STAT KernMem_CreateSegmentFromThread(K2OSKERN_OBJ_THREAD *apCurThread, K2OSKER
 
     K2OSKERN_SeqIntrUnlock(&apCurThread->mpProc->SegTreeSeqLock, disp);
 
+    K2ATOMIC_Add((INT32 volatile *)&pTargetProc->MemStats.mCommittedPages, (INT32)(apSegSrc->mPagesBytes / K2_VA32_MEMPAGE_BYTES));
+    if (mappedPages > 0)
+    {
+        disp = K2OSKERN_SeqIntrLock(&gData.PhysMemSeqLock);
+        sMemStatsResident(pTargetProc, (INT32)mappedPages);
+        K2OSKERN_SeqIntrUnlock(&gData.PhysMemSeqLock, disp);
+    }
+
     stat = KernObj_Add(&apSegSrc->Hdr, NULL);
     K2_ASSERT(!K2STAT_IS_ERROR(stat));
 
@@ -1832,6 +2832,8 @@ K2STAT KernMem_SegFreeFromThread(K2OSKERN_OBJ_THREAD *apCurThread)
     return K2STAT_NO_ERROR;
 }
 
+#define SEGPAGES_BATCH  16
+
 K2STAT KernMem_MapSegPagesFromThread(K2OSKERN_OBJ_THREAD *apCurThread, K2OSKERN_OBJ_SEGMENT *apSrc, UINT32 aSegOffset, UINT32 aPageCount, UINT32 aPageAttrFlags)
 {
     BOOL                        disp;
@@ -1840,6 +2842,10 @@ K2STAT KernMem_MapSegPagesFromThread(K2OSKERN_OBJ_THREAD *apCurThread, K2OSKERN_
     UINT32                      segPageCount;
     K2OSKERN_PHYSTRACK_PAGE *   pPhysPage;
     KernPhysPageList            pageList;
+    UINT32                      batch;
+    UINT32                      ix;
+    UINT32                      physList[SEGPAGES_BATCH];
+    K2LIST_ANCHOR               batchList;
 
     segPageCount = apSrc->mPagesBytes / K2_VA32_MEMPAGE_BYTES;
 
@@ -1866,64 +2872,166 @@ K2STAT KernMem_MapSegPagesFromThread(K2OSKERN_OBJ_THREAD *apCurThread, K2OSKERN_
 
     pageList = sGetSegTargetPageList(apSrc);
 
+    //
+    // segment creation made the pagetables for the whole range, so pages
+    // can be mapped in runs instead of one at a time
+    //
+    K2_ASSERT(virtAddr >= K2OS_KVA_KERN_BASE);
+
     do {
-        apCurThread->mWorkMapAddr = virtAddr;
+        batch = (aPageCount < SEGPAGES_BATCH) ? aPageCount : SEGPAGES_BATCH;
 
-        //
-        // load a page
-        //
-        if (apCurThread->WorkPages_Clean.mNodeCount > 0)
-        {
-            disp = K2OSKERN_SetIntr(FALSE);
-            pPhysPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, apCurThread->WorkPages_Clean.mpHead, ListLink);
-            K2LIST_Remove(&apCurThread->WorkPages_Clean, &pPhysPage->ListLink);
-        }
-        else
+        K2LIST_Init(&batchList);
+
+        for (ix = 0; ix < batch; ix++)
         {
             //
-            // clean a dirty page if the page will not be mapped as writeable
+            // load a page
             //
-            pPhysPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, apCurThread->WorkPages_Dirty.mpHead, ListLink);
-
-            if (!cleanAfter)
+            if (apCurThread->WorkPages_Clean.mNodeCount > 0)
+            {
+                disp = K2OSKERN_SetIntr(FALSE);
+                pPhysPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, apCurThread->WorkPages_Clean.mpHead, ListLink);
+                K2LIST_Remove(&apCurThread->WorkPages_Clean, &pPhysPage->ListLink);
+            }
+            else
             {
-                sCleanPageOnThisCore(K2OS_PHYSTRACK_TO_PHYS32((UINT32)pPhysPage));
+                //
+                // clean a dirty page if the page will not be mapped as writeable
+                //
+                pPhysPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, apCurThread->WorkPages_Dirty.mpHead, ListLink);
+
+                if (!cleanAfter)
+                {
+                    sCleanPageOnThisCore(K2OS_PHYSTRACK_TO_PHYS32((UINT32)pPhysPage));
+                }
+
+                disp = K2OSKERN_SetIntr(FALSE);
+
+                K2LIST_Remove(&apCurThread->WorkPages_Dirty, &pPhysPage->ListLink);
             }
 
-            disp = K2OSKERN_SetIntr(FALSE);
+            pPhysPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
+            pPhysPage->mFlags |= (KernPhysPageList_Thread_Working << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+            K2LIST_AddAtTail(&batchList, &pPhysPage->ListLink);
+            physList[ix] = K2OS_PHYSTRACK_TO_PHYS32((UINT32)pPhysPage);
 
-            K2LIST_Remove(&apCurThread->WorkPages_Dirty, &pPhysPage->ListLink);
+            K2OSKERN_SetIntr(disp);
         }
 
-        pPhysPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
-        pPhysPage->mFlags |= (KernPhysPageList_Thread_Working << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
-        apCurThread->mpWorkPage = pPhysPage;
+        disp = K2OSKERN_SeqIntrLock(&gData.KernVirtMapLock);
+        KernMap_MapRange(K2OS_KVA_KERNVAMAP_BASE, virtAddr, batch, 0, physList, apCurThread->mWorkMapAttr);
+        K2OSKERN_SeqIntrUnlock(&gData.KernVirtMapLock, disp);
 
-        K2OSKERN_SetIntr(disp);
+        //
+        // move the pages just mapped to the segment's list
+        //
+        disp = K2OSKERN_SeqIntrLock(&gData.PhysMemSeqLock);
+        do {
+            pPhysPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, batchList.mpHead, ListLink);
+            K2LIST_Remove(&batchList, &pPhysPage->ListLink);
+            pPhysPage->mpOwnerObject = apSrc;
+            pPhysPage->mFlags = (pPhysPage->mFlags & ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK) | (pageList << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+            K2LIST_AddAtTail(&gData.PhysPageList[pageList], &pPhysPage->ListLink);
+        } while (batchList.mNodeCount > 0);
+        sMemStatsResident(apSrc->mpProc, (INT32)batch);
+        K2OSKERN_SeqIntrUnlock(&gData.PhysMemSeqLock, disp);
 
-        KernMap_MakeOnePageFromThread(apCurThread, apSrc, pageList);
         if (cleanAfter)
         {
-            K2MEM_Zero((void *)virtAddr, K2_VA32_MEMPAGE_BYTES);
+            K2MEM_Zero((void *)virtAddr, batch * K2_VA32_MEMPAGE_BYTES);
         }
 
-        virtAddr += K2_VA32_MEMPAGE_BYTES;
-    } while (--aPageCount > 0);
+        virtAddr += batch * K2_VA32_MEMPAGE_BYTES;
+        aPageCount -= batch;
+
+    } while (aPageCount > 0);
+
+    apCurThread->mWorkMapAttr = 0;
 
     return K2STAT_NO_ERROR;
 }
 
-void KernMem_UnmapSegPagesToThread(K2OSKERN_OBJ_THREAD *apCurThread, K2OSKERN_OBJ_SEGMENT *apSrc, UINT32 aSegOffset, UINT32 aPageCount, BOOL aClearNp)
+static void sReleaseUnmappedPageToThread(K2OSKERN_OBJ_THREAD *apCurThread, K2OSKERN_OBJ_SEGMENT *apSrc, KernPhysPageList aMatchList, UINT32 aPhysAddr)
+{
+    BOOL                        disp;
+    K2OSKERN_PHYSTRACK_PAGE *   pPhysPage;
+
+    K2_ASSERT(aPhysAddr != 0);
+
+    pPhysPage = (K2OSKERN_PHYSTRACK_PAGE *)K2OS_PHYS32_TO_PHYSTRACK(aPhysAddr);
+
+    disp = K2OSKERN_SeqIntrLock(&gData.PhysMemSeqLock);
+
+    sMemStatsResident(apSrc->mpProc, -1);
+
+    K2_ASSERT(pPhysPage->mpOwnerObject == apSrc);
+    K2_ASSERT(K2OSKERN_PHYSTRACK_PAGE_FLAGS_GET_LIST(pPhysPage->mFlags) == aMatchList);
+    K2LIST_Remove(&gData.PhysPageList[aMatchList], &pPhysPage->ListLink);
+
+    //
+    // assume pages are dirty when unmapped
+    //
+    pPhysPage->mpOwnerObject = NULL;
+    pPhysPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
+    pPhysPage->mFlags |= (KernPhysPageList_Thread_Dirty << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+    K2LIST_AddAtTail(&apCurThread->WorkPages_Dirty, &pPhysPage->ListLink);
+
+    K2OSKERN_SeqIntrUnlock(&gData.PhysMemSeqLock, disp);
+}
+
+static void sBreakLargePageToThread(K2OSKERN_OBJ_THREAD *apCurThread, UINT32 aVirtAddr)
 {
+    K2STAT                      stat;
     BOOL                        disp;
+    K2OSKERN_PHYSTRACK_PAGE *   pPhysPage;
+
+    K2_ASSERT(apCurThread->mpWorkPtPage == NULL);
+
+    //
+    // reuse a pagetable purged earlier in this unmap if there is one. unmap cannot
+    // fail so otherwise one page for the pagetable has to be found
+    //
+    if ((apCurThread->WorkPtPages_Clean.mNodeCount + apCurThread->WorkPtPages_Dirty.mNodeCount) == 0)
+    {
+        stat = KernMem_PhysAllocToThread(apCurThread, 1, KernPhys_Disp_Cached, TRUE);
+        K2_ASSERT(!K2STAT_IS_ERROR(stat));
+    }
+
+    if (apCurThread->WorkPtPages_Clean.mNodeCount > 0)
+    {
+        pPhysPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, apCurThread->WorkPtPages_Clean.mpHead, ListLink);
+        disp = K2OSKERN_SetIntr(FALSE);
+        K2LIST_Remove(&apCurThread->WorkPtPages_Clean, &pPhysPage->ListLink);
+    }
+    else
+    {
+        pPhysPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, apCurThread->WorkPtPages_Dirty.mpHead, ListLink);
+        sCleanPageOnThisCore(K2OS_PHYSTRACK_TO_PHYS32((UINT32)pPhysPage));
+        disp = K2OSKERN_SetIntr(FALSE);
+        K2LIST_Remove(&apCurThread->WorkPtPages_Dirty, &pPhysPage->ListLink);
+    }
+    pPhysPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
+    pPhysPage->mFlags |= (KernPhysPageList_Thread_PtWorking << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+    apCurThread->mpWorkPtPage = pPhysPage;
+
+    K2OSKERN_SetIntr(disp);
+
+    KernMap_BreakLargePage(apCurThread, aVirtAddr);
+}
+
+void KernMem_UnmapSegPagesToThread(K2OSKERN_OBJ_THREAD *apCurThread, K2OSKERN_OBJ_SEGMENT *apSrc, UINT32 aSegOffset, UINT32 aPageCount, BOOL aClearNp)
+{
     UINT32                      virtAddr;
     UINT32                      segPageCount;
-    K2OSKERN_PHYSTRACK_PAGE *   pPhysPage;
     KernPhysPageList            pageList;
     UINT32                      segType;
     UINT32                      devPhysPage;
     UINT32                      unmapPhys;
     UINT32                      npFlags;
+    UINT32                      batch;
+    UINT32                      ix;
+    UINT32                      physList[SEGPAGES_BATCH];
 
     segType = apSrc->mSegAndMemPageAttr & K2OSKERN_SEG_ATTR_TYPE_MASK;
 
@@ -1952,6 +3060,17 @@ void KernMem_UnmapSegPagesToThread(K2OSKERN_OBJ_THREAD *apCurThread, K2OSKERN_OB
             devPhysPage = apSrc->Info.ContigPhys.mPhysAddr;
         pageList = KernPhysPageList_Error;
     }
+    else if (segType == K2OSKERN_SEG_ATTR_TYPE_LENT)
+    {
+        //
+        // lent pages still belong to the source segment and are
+        // not released back to the physical free lists
+        //
+        K2_ASSERT(aSegOffset == 0);
+        K2_ASSERT(segPageCount == aPageCount);
+        devPhysPage = 0;
+        pageList = KernPhysPageList_Error;
+    }
     else
     {
         pageList = sGetSegTargetPageList(apSrc);
@@ -1964,70 +3083,91 @@ void KernMem_UnmapSegPagesToThread(K2OSKERN_OBJ_THREAD *apCurThread, K2OSKERN_OB
 
     if (aClearNp)
         npFlags = 0;
+    else if (apSrc->mSegAndMemPageAttr & K2OSKERN_SEG_ATTR_DEMAND_ZERO)
+        npFlags = K2OSKERN_PTE_NP_COMMITTED;
     else
         npFlags = K2OSKERN_PTE_NP_BIT;
 
-    do {
-        apCurThread->mWorkMapAddr = virtAddr;
+    K2_ASSERT(virtAddr >= K2OS_KVA_KERN_BASE);
 
-        if (!apCurThread->mTlbFlushNeeded)
-        {
-            apCurThread->mTlbFlushNeeded = TRUE;
-            apCurThread->mTlbFlushBase = virtAddr;
-            apCurThread->mTlbFlushPages = 1;
-        }
-        else
-            apCurThread->mTlbFlushPages++;
-        
-        if ((segType == K2OSKERN_SEG_ATTR_TYPE_THREAD) && (aSegOffset == 0))
-        {
-            unmapPhys = KernMap_BreakOnePageToThread(apCurThread, NULL, KernPhysPageList_Error, npFlags);
-            K2_ASSERT(unmapPhys == 0);
-            aSegOffset++;
-        }
-        else if ((segType == K2OSKERN_SEG_ATTR_TYPE_DEVMAP) ||
-                 (segType == K2OSKERN_SEG_ATTR_TYPE_CONTIG_PHYS))
-        {
-            unmapPhys = KernMap_BreakOnePageToThread(apCurThread, apSrc, KernPhysPageList_Error, npFlags);
-            K2_ASSERT(unmapPhys == devPhysPage);
-            devPhysPage += K2_VA32_MEMPAGE_BYTES;
-        }
-        else
+    do {
+        if ((segType == K2OSKERN_SEG_ATTR_TYPE_CONTIG_PHYS) &&
+            (0 != (apSrc->mSegAndMemPageAttr & K2OSKERN_SEG_ATTR_LARGE_PAGES)) &&
+            (0 == (virtAddr & (K2_VA32_PAGETABLE_MAP_BYTES - 1))) &&
+            (KernMap_IsLargePage(virtAddr)))
         {
-            unmapPhys = KernMap_BreakOnePageToThread(apCurThread, apSrc, pageList, npFlags);
-            pPhysPage = apCurThread->mpWorkPage;
-            K2_ASSERT(pPhysPage != NULL);
-
-            disp = K2OSKERN_SetIntr(FALSE);
+            if (aPageCount < K2_VA32_ENTRIES_PER_PAGETABLE)
+            {
+                //
+                // only part of the chunk is going away. break the large page into a
+                // pagetable and take the pages out through the small page path
+                //
+                sBreakLargePageToThread(apCurThread, virtAddr);
+                continue;
+            }
 
             //
-            // assume pages are dirty when unmapped
+            // whole 4MB chunk goes at once. there is no pagetable to purge
             //
-            pPhysPage->mpOwnerObject = NULL;
-            pPhysPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
-            pPhysPage->mFlags |= (KernPhysPageList_Thread_Dirty << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
-            K2LIST_AddAtTail(&apCurThread->WorkPages_Dirty, &pPhysPage->ListLink);
-            apCurThread->mpWorkPage = NULL;
-
-            pPhysPage = apCurThread->mpWorkPtPage;
-            if (pPhysPage != NULL)
+            unmapPhys = KernMap_UnmapLargePage(virtAddr);
+            K2_ASSERT(unmapPhys == devPhysPage);
+            devPhysPage += K2_VA32_PAGETABLE_MAP_BYTES;
+            if (!apCurThread->mTlbFlushNeeded)
             {
-                //
-                // pagetable was unmapped too. pagetables are always clean when unmapped
-                //
-                pPhysPage->mpOwnerObject = NULL;
-                pPhysPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
-                pPhysPage->mFlags |= (KernPhysPageList_Thread_PtClean << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
-                K2LIST_AddAtTail(&apCurThread->WorkPtPages_Clean, &pPhysPage->ListLink);
-                apCurThread->mpWorkPtPage = NULL;
+                apCurThread->mTlbFlushNeeded = TRUE;
+                apCurThread->mTlbFlushBase = virtAddr;
+                apCurThread->mTlbFlushPages = K2_VA32_ENTRIES_PER_PAGETABLE;
             }
+            else
+            {
+                apCurThread->mTlbFlushPages += K2_VA32_ENTRIES_PER_PAGETABLE;
+            }
+            virtAddr += K2_VA32_PAGETABLE_MAP_BYTES;
+            aPageCount -= K2_VA32_ENTRIES_PER_PAGETABLE;
+            continue;
+        }
 
-            K2OSKERN_SetIntr(disp);
+        //
+        // unmap a run that does not cross a pagetable boundary
+        //
+        batch = (K2_VA32_PAGETABLE_MAP_BYTES - (virtAddr & (K2_VA32_PAGETABLE_MAP_BYTES - 1))) / K2_VA32_MEMPAGE_BYTES;
+        if (batch > SEGPAGES_BATCH)
+            batch = SEGPAGES_BATCH;
+        if (batch > aPageCount)
+            batch = aPageCount;
+
+        KernMap_UnmapRange(apCurThread, virtAddr, batch, npFlags, physList);
+
+        for (ix = 0; ix < batch; ix++)
+        {
+            unmapPhys = physList[ix];
+
+            if ((segType == K2OSKERN_SEG_ATTR_TYPE_THREAD) && (aSegOffset == 0))
+            {
+                // guard page
+                K2_ASSERT(unmapPhys == 0);
+                aSegOffset++;
+            }
+            else if ((segType == K2OSKERN_SEG_ATTR_TYPE_DEVMAP) ||
+                     (segType == K2OSKERN_SEG_ATTR_TYPE_CONTIG_PHYS))
+            {
+                K2_ASSERT(unmapPhys == devPhysPage);
+                devPhysPage += K2_VA32_MEMPAGE_BYTES;
+            }
+            else if (segType == K2OSKERN_SEG_ATTR_TYPE_LENT)
+            {
+                K2_ASSERT(unmapPhys != 0);
+            }
+            else
+            {
+                sReleaseUnmappedPageToThread(apCurThread, apSrc, pageList, unmapPhys);
+            }
         }
 
-        virtAddr += K2_VA32_MEMPAGE_BYTES;
+        virtAddr += batch * K2_VA32_MEMPAGE_BYTES;
+        aPageCount -= batch;
 
-    } while (--aPageCount > 0);
+    } while (aPageCount > 0);
 
     KernMem_PhysFreeFromThread(apCurThread);
 
@@ -2048,6 +3188,47 @@ void KernMem_UnmapSegPagesToThread(K2OSKERN_OBJ_THREAD *apCurThread, K2OSKERN_OB
     }
 }
 
+static void sClearDemandEntriesToThread(K2OSKERN_OBJ_THREAD *apCurThread, UINT32 aVirtAddr, UINT32 aPageCount)
+{
+    UINT32 *                    pPtPageCount;
+    UINT32                      pte;
+    UINT32                      unmapPhys;
+    BOOL                        disp;
+    K2OSKERN_PHYSTRACK_PAGE *   pPhysPage;
+
+    K2_ASSERT(aVirtAddr >= K2OS_KVA_KERN_BASE);
+
+    pPtPageCount = (UINT32 *)K2OS_KVA_PTPAGECOUNT_BASE;
+
+    do {
+        if (pPtPageCount[aVirtAddr / K2_VA32_PAGETABLE_MAP_BYTES] != 0)
+        {
+            pte = *((UINT32 *)K2OS_KVA_TO_PTE_ADDR(aVirtAddr));
+            if ((pte & (K2OSKERN_PTE_PRESENT_BIT | K2OSKERN_PTE_NP_MASK)) == K2OSKERN_PTE_NP_COMMITTED)
+            {
+                apCurThread->mWorkMapAddr = aVirtAddr;
+                unmapPhys = KernMap_BreakOnePageToThread(apCurThread, NULL, KernPhysPageList_Error, 0);
+                K2_ASSERT(unmapPhys == 0);
+
+                pPhysPage = apCurThread->mpWorkPtPage;
+                if (pPhysPage != NULL)
+                {
+                    disp = K2OSKERN_SetIntr(FALSE);
+                    pPhysPage->mpOwnerObject = NULL;
+                    pPhysPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
+                    pPhysPage->mFlags |= (KernPhysPageList_Thread_PtClean << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+                    K2LIST_AddAtTail(&apCurThread->WorkPtPages_Clean, &pPhysPage->ListLink);
+                    apCurThread->mpWorkPtPage = NULL;
+                    K2OSKERN_SetIntr(disp);
+                }
+            }
+        }
+        aVirtAddr += K2_VA32_MEMPAGE_BYTES;
+    } while (--aPageCount > 0);
+
+    apCurThread->mWorkMapAddr = 0;
+}
+
 void KernMem_SegDispose(K2OSKERN_OBJ_HEADER *apObjHdr)
 {
     BOOL                    disp;
@@ -2082,6 +3263,8 @@ void KernMem_SegDispose(K2OSKERN_OBJ_HEADER *apObjHdr)
 
     K2OSKERN_SeqIntrUnlock(&apSeg->mpProc->SegTreeSeqLock, disp);
 
+    K2ATOMIC_Add((INT32 volatile *)&apSeg->mpProc->MemStats.mCommittedPages, -((INT32)segPageCount));
+
     //
     // unmap anything that is mapped
     //
@@ -2104,6 +3287,14 @@ void KernMem_SegDispose(K2OSKERN_OBJ_HEADER *apObjHdr)
             KernMem_UnmapSegPagesToThread(pCurThread, apSeg, scanIx, foundCount, TRUE);
             scanIx += foundCount;
         } while (scanIx < segPageCount);
+
+        if (apSeg->mSegAndMemPageAttr & K2OSKERN_SEG_ATTR_DEMAND_ZERO)
+        {
+            //
+            // pages that were never touched are still NP_COMMITTED
+            //
+            sClearDemandEntriesToThread(pCurThread, segVirtAddr, segPageCount);
+        }
     }
     else
     {
@@ -2117,6 +3308,16 @@ void KernMem_SegDispose(K2OSKERN_OBJ_HEADER *apObjHdr)
 
     KernMem_VirtFreeFromThread(pCurThread);
 
+    if (segType == K2OSKERN_SEG_ATTR_TYPE_LENT)
+    {
+        //
+        // pages are no longer visible through the lent range, so the
+        // owner of the pages can go away now
+        //
+        K2OSKERN_ReleaseObject(&apSeg->Info.Lent.mpSrcSeg->Hdr);
+        apSeg->Info.Lent.mpSrcSeg = NULL;
+    }
+
     if (0 == (apSeg->Hdr.mObjFlags & K2OSKERN_OBJ_FLAG_EMBEDDED))
     {
         //
@@ -2133,6 +3334,38 @@ void KernMem_SegDispose(K2OSKERN_OBJ_HEADER *apObjHdr)
     }
 }
 
+static K2STAT sVirtAllocForLargeToThread(K2OSKERN_OBJ_THREAD *apCurThread, UINT32 aPhysAddr, UINT32 aPageCount)
+{
+    K2STAT  stat;
+    BOOL    ok;
+    UINT32  useAddr;
+
+    //
+    // find a virtual range that has the same offset inside a 4MB chunk as
+    // the physical range so that whole chunks can be mapped with large pages.
+    // virt heap critsec is recursive so the range cannot be taken out from
+    // under us between the probe and the real allocation
+    //
+    ok = K2OS_CritSecEnter(&gData.KernVirtHeapSec);
+    K2_ASSERT(ok);
+
+    stat = KernMem_VirtAllocToThread(apCurThread, 0, aPageCount + K2_VA32_ENTRIES_PER_PAGETABLE, FALSE);
+    if (!K2STAT_IS_ERROR(stat))
+    {
+        useAddr = apCurThread->mWorkVirt_Range;
+        useAddr += (aPhysAddr - useAddr) & (K2_VA32_PAGETABLE_MAP_BYTES - 1);
+
+        KernMem_VirtFreeFromThread(apCurThread);
+
+        stat = KernMem_VirtAllocToThread(apCurThread, useAddr, aPageCount, FALSE);
+    }
+
+    ok = K2OS_CritSecLeave(&gData.KernVirtHeapSec);
+    K2_ASSERT(ok);
+
+    return stat;
+}
+
 K2STAT 
 KernMem_MapContigPhys(
     UINT32                  aContigPhysAddr,
@@ -2147,6 +3380,7 @@ KernMem_MapContigPhys(
     K2OSKERN_OBJ_SEGMENT *  pSeg;
     K2OSKERN_OBJ_THREAD *   pCurThread;
     UINT32                  chunkLeft;
+    UINT32                  largeAttr;
 
     if (gData.mKernInitStage < KernInitStage_MemReady)
         return K2STAT_ERROR_API_ORDER;
@@ -2167,16 +3401,32 @@ KernMem_MapContigPhys(
 
     do {
 
-        stat = KernMem_VirtAllocToThread(pCurThread, 0, aPageCount, FALSE);
-        if (K2STAT_IS_ERROR(stat))
-            break;
+        //
+        // try for large page mappings if the range covers at least one whole 4MB physical chunk
+        //
+        largeAttr = 0;
+        virtAddr = (aContigPhysAddr + (K2_VA32_PAGETABLE_MAP_BYTES - 1)) & ~(K2_VA32_PAGETABLE_MAP_BYTES - 1);
+        if ((virtAddr >= aContigPhysAddr) &&
+            ((virtAddr - aContigPhysAddr) / K2_VA32_MEMPAGE_BYTES) + K2_VA32_ENTRIES_PER_PAGETABLE <= aPageCount)
+        {
+            stat = sVirtAllocForLargeToThread(pCurThread, aContigPhysAddr, aPageCount);
+            if (!K2STAT_IS_ERROR(stat))
+                largeAttr = K2OSKERN_SEG_ATTR_LARGE_PAGES;
+        }
+
+        if (largeAttr == 0)
+        {
+            stat = KernMem_VirtAllocToThread(pCurThread, 0, aPageCount, FALSE);
+            if (K2STAT_IS_ERROR(stat))
+                break;
+        }
 
         K2MEM_Zero(pSeg, sizeof(K2OSKERN_OBJ_SEGMENT));
         pSeg->Hdr.mObjType = K2OS_Obj_Segment;
         pSeg->Hdr.mRefCount = 1;
         pSeg->Hdr.Dispose = KernMem_SegDispose;
         K2LIST_Init(&pSeg->Hdr.WaitEntryPrioList);
-        pSeg->mSegAndMemPageAttr = K2OSKERN_SEG_ATTR_TYPE_CONTIG_PHYS | aSegAndMemPageAttr;
+        pSeg->mSegAndMemPageAttr = K2OSKERN_SEG_ATTR_TYPE_CONTIG_PHYS | largeAttr | aSegAndMemPageAttr;
         pSeg->Info.ContigPhys.mPhysAddr = aContigPhysAddr;
 
         K2_ASSERT(pCurThread->WorkPages_Dirty.mNodeCount == 0);
@@ -2194,36 +3444,41 @@ KernMem_MapContigPhys(
             //
             // map the device pages to the virtual range just created
             //
-            chunkLeft = KERN_MEMMAP_CHUNK;
             virtAddr = pSeg->ProcSegTreeNode.mUserVal;
 
-            disp = K2OSKERN_SeqIntrLock(&gData.KernVirtMapLock);
-
             do {
-                KernMap_MakeOnePresentPage(
-                    K2OS_KVA_KERNVAMAP_BASE,
-                    virtAddr,
-                    aContigPhysAddr,
-                    aSegAndMemPageAttr & K2OS_MEMPAGE_ATTR_MASK);
-                virtAddr += K2_VA32_MEMPAGE_BYTES;
-                aContigPhysAddr += K2_VA32_MEMPAGE_BYTES;
-
-                if (--aPageCount == 0)
-                    break;
-
-                if (--chunkLeft == 0)
+                if ((largeAttr != 0) &&
+                    (0 == (virtAddr & (K2_VA32_PAGETABLE_MAP_BYTES - 1))) &&
+                    (KernMap_IsLargePage(virtAddr)))
                 {
-                    if (aPageCount > 1)
-                    {
-                        K2OSKERN_SeqIntrUnlock(&gData.KernVirtMapLock, disp);
-                        disp = K2OSKERN_SeqIntrLock(&gData.KernVirtMapLock);
-                        chunkLeft = KERN_MEMMAP_CHUNK;
-                    }
+                    //
+                    // chunk was mapped with a large page when the segment was created
+                    //
+                    virtAddr += K2_VA32_PAGETABLE_MAP_BYTES;
+                    aContigPhysAddr += K2_VA32_PAGETABLE_MAP_BYTES;
+                    aPageCount -= K2_VA32_ENTRIES_PER_PAGETABLE;
+                    continue;
                 }
 
-            } while (1);
+                //
+                // map in chunks so the lock is not held too long, and stop
+                // at the next 4MB boundary in case the next chunk is large
+                //
+                chunkLeft = (K2_VA32_PAGETABLE_MAP_BYTES - (virtAddr & (K2_VA32_PAGETABLE_MAP_BYTES - 1))) / K2_VA32_MEMPAGE_BYTES;
+                if (chunkLeft > KERN_MEMMAP_CHUNK)
+                    chunkLeft = KERN_MEMMAP_CHUNK;
+                if (chunkLeft > aPageCount)
+                    chunkLeft = aPageCount;
+
+                disp = K2OSKERN_SeqIntrLock(&gData.KernVirtMapLock);
+                KernMap_MapRange(K2OS_KVA_KERNVAMAP_BASE, virtAddr, chunkLeft, aContigPhysAddr, NULL, aSegAndMemPageAttr);
+                K2OSKERN_SeqIntrUnlock(&gData.KernVirtMapLock, disp);
+
+                virtAddr += chunkLeft * K2_VA32_MEMPAGE_BYTES;
+                aContigPhysAddr += chunkLeft * K2_VA32_MEMPAGE_BYTES;
+                aPageCount -= chunkLeft;
 
-            K2OSKERN_SeqIntrUnlock(&gData.KernVirtMapLock, disp);
+            } while (aPageCount > 0);
         }
         else
         {
@@ -2241,7 +3496,471 @@ KernMem_MapContigPhys(
     return stat;
 }
 
+K2OSKERN_OBJ_SEGMENT * KernMem_SegTreeFindAndRef(K2OSKERN_OBJ_PROCESS *apProc, UINT32 aVirtAddr)
+{
+    K2OSKERN_OBJ_SEGMENT *  pSeg;
+    K2OSKERN_OBJ_SEGMENT *  pResult;
+    K2TREE_NODE *           pTreeNode;
+    K2STAT                  stat;
+    BOOL                    disp;
+
+    //
+    // returns a referenced segment with the highest base address that is at or 
+    // below aVirtAddr. caller checks if the address is actually inside it.
+    // segments are embedded in objects that can be freed as soon as they leave
+    // the tree, so the walk and the addref both happen under SegTreeSeqLock
+    //
+    pResult = NULL;
+
+    disp = K2OSKERN_SeqIntrLock(&apProc->SegTreeSeqLock);
+
+    pTreeNode = K2TREE_FindOrAfter(&apProc->SegTree, aVirtAddr);
+    if (pTreeNode == NULL)
+        pTreeNode = K2TREE_LastNode(&apProc->SegTree);
+    else if (pTreeNode->mUserVal != aVirtAddr)
+        pTreeNode = K2TREE_PrevNode(&apProc->SegTree, pTreeNode);
+
+    if (pTreeNode != NULL)
+    {
+        pSeg = K2_GET_CONTAINER(K2OSKERN_OBJ_SEGMENT, pTreeNode, ProcSegTreeNode);
+        stat = K2OSKERN_AddRefObject(&pSeg->Hdr);
+        if (!K2STAT_IS_ERROR(stat))
+            pResult = pSeg;
+    }
+
+    K2OSKERN_SeqIntrUnlock(&apProc->SegTreeSeqLock, disp);
+
+    return pResult;
+}
+
+static UINT32 sDemandReadPte(UINT32 aVirtAddr)
+{
+    //
+    // KernVirtMapLock held. pagetable count is checked first so we never 
+    // touch the PTE of a pagetable that is not there
+    //
+    if (0 == ((UINT32 *)K2OS_KVA_PTPAGECOUNT_BASE)[aVirtAddr / K2_VA32_PAGETABLE_MAP_BYTES])
+        return 0;
+
+    return *((UINT32 *)K2OS_KVA_TO_PTE_ADDR(aVirtAddr));
+}
+
+#define DEMAND_PTE_IS_COMMITTED(x)  (((x) & (K2OSKERN_PTE_PRESENT_BIT | K2OSKERN_PTE_NP_MASK)) == K2OSKERN_PTE_NP_COMMITTED)
+
+static K2OSKERN_OBJ_SEGMENT * sDemandFindSegLocked(UINT32 aVirtAddr)
+{
+    K2TREE_NODE *           pTreeNode;
+    K2OSKERN_OBJ_SEGMENT *  pSeg;
+
+    //
+    // proc0 SegTreeSeqLock held. returns the demand-zero segment holding the address, if any
+    //
+    pTreeNode = K2TREE_FindOrAfter(&gpProc0->SegTree, aVirtAddr);
+    if (pTreeNode == NULL)
+        pTreeNode = K2TREE_LastNode(&gpProc0->SegTree);
+    else if (pTreeNode->mUserVal != aVirtAddr)
+        pTreeNode = K2TREE_PrevNode(&gpProc0->SegTree, pTreeNode);
+    if (pTreeNode == NULL)
+        return NULL;
+
+    pSeg = K2_GET_CONTAINER(K2OSKERN_OBJ_SEGMENT, pTreeNode, ProcSegTreeNode);
+    if (0 == (pSeg->mSegAndMemPageAttr & K2OSKERN_SEG_ATTR_DEMAND_ZERO))
+        return NULL;
+
+    if ((aVirtAddr - pSeg->ProcSegTreeNode.mUserVal) >= pSeg->mPagesBytes)
+        return NULL;
+
+    return pSeg;
+}
+
+static UINT32 sDemandCheck(UINT32 aVirtAddr, K2OSKERN_OBJ_SEGMENT **appRetSeg)
+{
+    BOOL    disp;
+    UINT32  pte;
+
+    //
+    // proc0 SegTreeSeqLock held. returns the PTE if the address is in a 
+    // demand-zero segment, or zero if it is not
+    //
+    *appRetSeg = sDemandFindSegLocked(aVirtAddr);
+    if (*appRetSeg == NULL)
+        return 0;
+
+    disp = K2OSKERN_SeqIntrLock(&gData.KernVirtMapLock);
+    pte = sDemandReadPte(aVirtAddr);
+    K2OSKERN_SeqIntrUnlock(&gData.KernVirtMapLock, disp);
+
+    return pte;
+}
+
+static BOOL sDemandMapOne(UINT32 aVirtAddr, BOOL aIsFaultPage)
+{
+    BOOL                        disp;
+    BOOL                        disp2;
+    BOOL                        isDirty;
+    BOOL                        mapped;
+    UINT32                      pte;
+    K2LIST_ANCHOR *             pList;
+    K2OSKERN_PHYSTRACK_PAGE *   pPhysPage;
+    K2OSKERN_OBJ_SEGMENT *      pSeg;
+    KernPhysPageList            targetList;
+
+    disp = K2OSKERN_SeqIntrLock(&gpProc0->SegTreeSeqLock);
+    pte = sDemandCheck(aVirtAddr, &pSeg);
+    K2OSKERN_SeqIntrUnlock(&gpProc0->SegTreeSeqLock, disp);
+
+    if (!DEMAND_PTE_IS_COMMITTED(pte))
+    {
+        //
+        // if the faulting page became present on another core then the
+        // faulting instruction can just be retried
+        //
+        if ((aIsFaultPage) && (pSeg != NULL) && (0 != (pte & K2OSKERN_PTE_PRESENT_BIT)))
+            return TRUE;
+        return FALSE;
+    }
+
+    //
+    // get a page with no segment tree lock held. fault-ahead only uses
+    // pages that are already clean so that the time spent here stays bounded
+    //
+    isDirty = FALSE;
+    disp = K2OSKERN_SeqIntrLock(&gData.PhysMemSeqLock);
+
+    pList = &gData.PhysPageList[KernPhysPageList_Free_Clean];
+    if (pList->mNodeCount == 0)
+    {
+        pList = NULL;
+        if ((aIsFaultPage) &&
+            (gData.PhysPageList[KernPhysPageList_Free_Dirty].mNodeCount > 0))
+        {
+            pList = &gData.PhysPageList[KernPhysPageList_Free_Dirty];
+            isDirty = TRUE;
+        }
+    }
+
+    if (pList != NULL)
+    {
+        pPhysPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, pList->mpHead, ListLink);
+        K2LIST_Remove(pList, &pPhysPage->ListLink);
+        pPhysPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
+        pPhysPage->mFlags |= (KernPhysPageList_Thread_Working << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+        sMemStatsNotePhysTaken();
+    }
+    else
+    {
+        pPhysPage = NULL;
+    }
+
+    K2OSKERN_SeqIntrUnlock(&gData.PhysMemSeqLock, disp);
+
+    if (pPhysPage == NULL)
+        return FALSE;
+
+    if (isDirty)
+    {
+        sCleanPageOnThisCore(K2OS_PHYSTRACK_TO_PHYS32((UINT32)pPhysPage));
+    }
+
+    //
+    // the segment may have gone away or been replaced while we were getting the
+    // page. look again, and map the page if the address is still committed and 
+    // nobody beat us to it. the segment tree lock is held until the page is on
+    // the segment's list so the segment cannot be purged underneath it
+    //
+    disp = K2OSKERN_SeqIntrLock(&gpProc0->SegTreeSeqLock);
+
+    pSeg = sDemandFindSegLocked(aVirtAddr);
+    mapped = FALSE;
+    if (pSeg != NULL)
+    {
+        disp2 = K2OSKERN_SeqIntrLock(&gData.KernVirtMapLock);
+        pte = sDemandReadPte(aVirtAddr);
+        if (DEMAND_PTE_IS_COMMITTED(pte))
+        {
+            KernMap_MakeOnePresentPage(K2OS_KVA_KERNVAMAP_BASE, aVirtAddr, K2OS_PHYSTRACK_TO_PHYS32((UINT32)pPhysPage),
+                (pSeg->mSegAndMemPageAttr & K2OS_MEMPAGE_ATTR_MASK) | K2OS_MEMPAGE_ATTR_KERNEL);
+            mapped = TRUE;
+        }
+        K2OSKERN_SeqIntrUnlock(&gData.KernVirtMapLock, disp2);
+    }
+
+    disp2 = K2OSKERN_SeqIntrLock(&gData.PhysMemSeqLock);
+    if (mapped)
+    {
+        targetList = sGetSegTargetPageList(pSeg);
+        pPhysPage->mpOwnerObject = pSeg;
+        pPhysPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
+        pPhysPage->mFlags |= (targetList << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+        K2LIST_AddAtTail(&gData.PhysPageList[targetList], &pPhysPage->ListLink);
+        sMemStatsResident(pSeg->mpProc, 1);
+    }
+    else
+    {
+        //
+        // page is clean either way. a fault page that is no longer committed 
+        // was either mapped by someone else or is gone, and either way
+        // retrying the instruction gives the right answer
+        //
+        pPhysPage->mpOwnerObject = NULL;
+        pPhysPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
+        pPhysPage->mFlags |= (KernPhysPageList_Free_Clean << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+        K2LIST_AddAtHead(&gData.PhysPageList[KernPhysPageList_Free_Clean], &pPhysPage->ListLink);
+        mapped = aIsFaultPage;
+    }
+    K2OSKERN_SeqIntrUnlock(&gData.PhysMemSeqLock, disp2);
+
+    K2OSKERN_SeqIntrUnlock(&gpProc0->SegTreeSeqLock, disp);
+
+    return mapped;
+}
+
+BOOL KernMem_ServiceDemandFault(UINT32 aFaultAddr)
+{
+    UINT32  virtAddr;
+    UINT32  left;
+
+    //
+    // called from the x32 exception handler with interrupts off, for a fault that 
+    // happened in kernel mode while interrupts were on. returns TRUE if the
+    // faulting instruction should be retried.  demand-zero segments only exist
+    // in kernel space as user-mode mapping is not there yet
+    //
+    if (aFaultAddr < K2OS_KVA_KERN_BASE)
+        return FALSE;
+
+    virtAddr = aFaultAddr & K2_VA32_PAGEFRAME_MASK;
+
+    //
+    // no lock is held across page allocation. each page looks up its 
+    // segment again before it is mapped
+    //
+    if (!sDemandMapOne(virtAddr, TRUE))
+        return FALSE;
+
+    //
+    // touching one page usually means the next few are going to get touched too
+    //
+    left = K2OSKERN_DEMAND_FAULT_AHEAD;
+    while (left > 0)
+    {
+        virtAddr += K2_VA32_MEMPAGE_BYTES;
+        if (virtAddr == 0)
+            break;
+        if (!sDemandMapOne(virtAddr, FALSE))
+            break;
+        left--;
+    }
+
+    return TRUE;
+}
+
+K2STAT
+KernMem_LendPages(
+    UINT32                  aSrcVirtAddr,
+    UINT32                  aPageCount,
+    BOOL                    aWriteable,
+    K2OSKERN_OBJ_SEGMENT ** appRetSeg
+)
+{
+    K2STAT                  stat;
+    BOOL                    disp;
+    UINT32                  virtAddr;
+    UINT32                  srcAddr;
+    UINT32                  pte;
+    UINT32                  pageAttr;
+    UINT32                  left;
+    UINT32                  chunkLeft;
+    K2OSKERN_OBJ_SEGMENT *  pSrcSeg;
+    K2OSKERN_OBJ_SEGMENT *  pSeg;
+    K2OSKERN_OBJ_THREAD *   pCurThread;
+
+    //
+    // map the physical pages behind an existing range of the kernel
+    // address space into a new segment, without copying them. the
+    // source segment is held referenced until the lent segment goes away
+    //
+    if (gData.mKernInitStage < KernInitStage_MemReady)
+        return K2STAT_ERROR_API_ORDER;
+
+    if ((aPageCount == 0) ||
+        (0 != (aSrcVirtAddr & K2_VA32_MEMPAGE_OFFSET_MASK)))
+        return K2STAT_ERROR_BAD_ARGUMENT;
+
+    if (aSrcVirtAddr < K2OS_KVA_KERN_BASE)
+    {
+        //
+        // user space mapping is not supported yet
+        //
+        return K2STAT_ERROR_NOT_IMPL;
+    }
+
+    //
+    // find and reference the segment that contains the source range
+    //
+    pSrcSeg = KernMem_SegTreeFindAndRef(gpProc0, aSrcVirtAddr);
+    if ((pSrcSeg != NULL) &&
+        (((aSrcVirtAddr - pSrcSeg->ProcSegTreeNode.mUserVal) / K2_VA32_MEMPAGE_BYTES) + aPageCount > 
+         (pSrcSeg->mPagesBytes / K2_VA32_MEMPAGE_BYTES)))
+    {
+        K2OSKERN_ReleaseObject(&pSrcSeg->Hdr);
+        pSrcSeg = NULL;
+    }
+
+    if (pSrcSeg == NULL)
+        return K2STAT_ERROR_NOT_FOUND;
+
+    if (pSrcSeg->mSegAndMemPageAttr & K2OSKERN_SEG_ATTR_LARGE_PAGES)
+    {
+        //
+        // large page chunks have no pagetable entries to lend from
+        //
+        K2OSKERN_ReleaseObject(&pSrcSeg->Hdr);
+        return K2STAT_ERROR_NOT_SUPPORTED;
+    }
+
+    //
+    // every page in the source range must be present
+    //
+    if (!KernMap_SegRangeMapped(
+        K2OSKERN_CURRENT_THREAD, 
+        pSrcSeg, 
+        (aSrcVirtAddr - pSrcSeg->ProcSegTreeNode.mUserVal) / K2_VA32_MEMPAGE_BYTES, 
+        aPageCount))
+    {
+        K2OSKERN_ReleaseObject(&pSrcSeg->Hdr);
+        return K2STAT_ERROR_NOT_MAPPED;
+    }
+
+    if (aWriteable)
+    {
+        //
+        // never hand out a writeable mapping of a page that the source
+        // only has mapped read-only
+        //
+        srcAddr = aSrcVirtAddr;
+        left = aPageCount;
+        stat = K2STAT_NO_ERROR;
+        disp = K2OSKERN_SeqIntrLock(&gData.KernVirtMapLock);
+        do {
+            pte = *((UINT32 *)K2OS_KVA_TO_PTE_ADDR(srcAddr));
+            if (!KernArch_VerifyPteKernHasAccessAttr(pte, K2OS_MEMPAGE_ATTR_WRITEABLE))
+            {
+                stat = K2STAT_ERROR_READ_ONLY;
+                break;
+            }
+            srcAddr += K2_VA32_MEMPAGE_BYTES;
+        } while (--left);
+        K2OSKERN_SeqIntrUnlock(&gData.KernVirtMapLock, disp);
+
+        if (K2STAT_IS_ERROR(stat))
+        {
+            K2OSKERN_ReleaseObject(&pSrcSeg->Hdr);
+            return stat;
+        }
+    }
+
+    pCurThread = K2OSKERN_CURRENT_THREAD;
+
+    stat = KernMem_SegAllocToThread(pCurThread);
+    if (K2STAT_IS_ERROR(stat))
+    {
+        K2OSKERN_ReleaseObject(&pSrcSeg->Hdr);
+        return stat;
+    }
+
+    pSeg = pCurThread->mpWorkSeg;
+
+    K2_ASSERT(pSeg != NULL);
+
+    pageAttr = aWriteable ? K2OS_MAPTYPE_KERN_DATA : K2OS_MAPTYPE_KERN_READ;
+
+    do {
+        stat = KernMem_VirtAllocToThread(pCurThread, 0, aPageCount, FALSE);
+        if (K2STAT_IS_ERROR(stat))
+            break;
+
+        K2MEM_Zero(pSeg, sizeof(K2OSKERN_OBJ_SEGMENT));
+        pSeg->Hdr.mObjType = K2OS_Obj_Segment;
+        pSeg->Hdr.mRefCount = 1;
+        pSeg->Hdr.Dispose = KernMem_SegDispose;
+        K2LIST_Init(&pSeg->Hdr.WaitEntryPrioList);
+        pSeg->mSegAndMemPageAttr = K2OSKERN_SEG_ATTR_TYPE_LENT | pageAttr;
+        pSeg->Info.Lent.mpSrcSeg = pSrcSeg;
+        pSeg->Info.Lent.mSrcVirtAddr = aSrcVirtAddr;
+
+        K2_ASSERT(pCurThread->WorkPages_Dirty.mNodeCount == 0);
+        K2_ASSERT(pCurThread->WorkPages_Clean.mNodeCount == 0);
+
+        stat = KernMem_CreateSegmentFromThread(pCurThread, pSeg, NULL);
+        if (K2STAT_IS_ERROR(stat))
+        {
+            KernMem_VirtFreeFromThread(pCurThread);
+            break;
+        }
+
+        K2_ASSERT(pCurThread->mpWorkSeg == NULL);
+        K2_ASSERT(pCurThread->mWorkVirt_Range == 0);
+        K2_ASSERT(pCurThread->mWorkVirt_PageCount == 0);
+
+        //
+        // map the source physical pages to the virtual range just created
+        //
+        chunkLeft = KERN_MEMMAP_CHUNK;
+        virtAddr = pSeg->ProcSegTreeNode.mUserVal;
+        srcAddr = aSrcVirtAddr;
+        left = aPageCount;
+
+        disp = K2OSKERN_SeqIntrLock(&gData.KernVirtMapLock);
+
+        do {
+            pte = *((UINT32 *)K2OS_KVA_TO_PTE_ADDR(srcAddr));
+            K2_ASSERT(pte & K2OSKERN_PTE_PRESENT_BIT);
+
+            KernMap_MakeOnePresentPage(
+                K2OS_KVA_KERNVAMAP_BASE,
+                virtAddr,
+                pte & K2_VA32_PAGEFRAME_MASK,
+                pageAttr);
+            virtAddr += K2_VA32_MEMPAGE_BYTES;
+            srcAddr += K2_VA32_MEMPAGE_BYTES;
+
+            if (--left == 0)
+                break;
+
+            if (--chunkLeft == 0)
+            {
+                if (left > 1)
+                {
+                    K2OSKERN_SeqIntrUnlock(&gData.KernVirtMapLock, disp);
+                    disp = K2OSKERN_SeqIntrLock(&gData.KernVirtMapLock);
+                    chunkLeft = KERN_MEMMAP_CHUNK;
+                }
+            }
+
+        } while (1);
+
+        K2OSKERN_SeqIntrUnlock(&gData.KernVirtMapLock, disp);
+
+        *appRetSeg = pSeg;
+
+    } while (0);
+
+    if (K2STAT_IS_ERROR(stat))
+    {
+        KernMem_SegFreeFromThread(pCurThread);
+        K2OSKERN_ReleaseObject(&pSrcSeg->Hdr);
+    }
+
+    return stat;
+}
+
 K2STAT KernMem_AllocMapAndCreateSegment(K2OSKERN_OBJ_SEGMENT *apSeg)
+{
+    return KernMem_AllocMapAndCreateSegmentAt(apSeg, 0);
+}
+
+K2STAT KernMem_AllocMapAndCreateSegmentAt(K2OSKERN_OBJ_SEGMENT *apSeg, UINT32 aPreferAddr)
 {
     K2STAT                  stat;
     K2OSKERN_OBJ_THREAD *   pCurThread;
@@ -2254,9 +3973,21 @@ K2STAT KernMem_AllocMapAndCreateSegment(K2OSKERN_OBJ_SEGMENT *apSeg)
     K2_ASSERT(pageCount > 0);
     K2_ASSERT(pageCount * K2_VA32_MEMPAGE_BYTES == apSeg->mPagesBytes);
 
-    stat = KernMem_VirtAllocToThread(pCurThread, 0, pageCount, FALSE);
+    stat = K2STAT_ERROR_NOT_FOUND;
+    if (aPreferAddr != 0)
+    {
+        K2_ASSERT((aPreferAddr & K2_VA32_MEMPAGE_OFFSET_MASK) == 0);
+        stat = KernMem_VirtAllocToThread(pCurThread, aPreferAddr, pageCount, FALSE);
+    }
     if (K2STAT_IS_ERROR(stat))
-        return stat;
+    {
+        //
+        // preferred address not given or not available
+        //
+        stat = KernMem_VirtAllocToThread(pCurThread, 0, pageCount, FALSE);
+        if (K2STAT_IS_ERROR(stat))
+            return stat;
+    }
     do {
         if (apSeg->mSegAndMemPageAttr & K2OS_MEMPAGE_ATTR_UNCACHED)
         {
@@ -143,7 +143,11 @@ K2STAT KernMsg_Abort(K2OSKERN_OBJ_MSG *apMsg, BOOL aClear)
     }
     else
     {
-        K2_ASSERT(K2STAT_IS_ERROR(stat));
+        //
+        // an in-service message with lent buffers stays with the mailbox
+        // until the service responds to it
+        //
+        K2_ASSERT(K2STAT_IS_ERROR(stat) || (apMsg->mpInLent != NULL) || (apMsg->mpOutLent != NULL));
         K2_ASSERT(pMailbox == NULL);
     }
 
@@ -181,6 +185,12 @@ void KernMsg_Dispose(K2OSKERN_OBJ_HEADER *apObjHdr)
 
     K2OSKERN_ReleaseObject(&apMsg->CompletionEvent.Hdr);
 
+    if (apMsg->mpInLent != NULL)
+        K2OSKERN_ReleaseObject(&apMsg->mpInLent->Hdr);
+
+    if (apMsg->mpOutLent != NULL)
+        K2OSKERN_ReleaseObject(&apMsg->mpOutLent->Hdr);
+
     check = !(apMsg->Hdr.mObjFlags & K2OSKERN_OBJ_FLAG_EMBEDDED);
 
     K2MEM_Zero(apMsg, sizeof(K2OSKERN_OBJ_MSG));
@@ -32,6 +32,101 @@
 
 #include "kern.h"
 
+#define SPIN_MAX_BACKOFF_US     4
+
+static BOOL sOwnerIsRunningElsewhere(K2OSKERN_CRITSEC *apSec)
+{
+    K2OSKERN_OBJ_THREAD *           pOwner;
+    K2OSKERN_CPUCORE volatile *     pCore;
+    UINT32                          coreIx;
+    UINT32                          thisCoreIx;
+
+    //
+    // unsynchronized peek. the owner can leave the section and exit at any
+    // time, so it is only ever compared against what the other cores are
+    // running and never dereferenced. a stale answer just costs us a few
+    // spins or an early block, never correctness
+    //
+    pOwner = *((K2OSKERN_OBJ_THREAD * volatile *)&apSec->mpOwner);
+    if (pOwner == NULL)
+        return TRUE;
+
+    thisCoreIx = K2OSKERN_GetCpuIndex();
+    for (coreIx = 0; coreIx < gData.mCpuCount; coreIx++)
+    {
+        if (coreIx == thisCoreIx)
+            continue;
+        pCore = K2OSKERN_COREIX_TO_CPUCORE(coreIx);
+        if (pCore->mpActiveThread == pOwner)
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+static BOOL sSpinForSec(K2OSKERN_CRITSEC *apSec)
+{
+    UINT32  budgetUs;
+    UINT32  spentUs;
+    UINT32  backoff;
+    UINT32  iter;
+    BOOL    disp;
+    BOOL    gotIntoSec;
+
+    //
+    // spinning only makes sense if the owner can make progress
+    // while we spin, which means it has to be on another core.
+    // the spin limit is a budget in microseconds of stall time
+    //
+    budgetUs = apSec->Stats.mSpinLimit;
+    if ((budgetUs == 0) || (gData.mCpuCount < 2))
+        return FALSE;
+
+    gotIntoSec = FALSE;
+    backoff = 1;
+    spentUs = 0;
+    iter = 0;
+    do {
+        if (!sOwnerIsRunningElsewhere(apSec))
+            break;
+
+        iter++;
+
+        if ((*((volatile BOOL *)&apSec->Event.mIsSignalled)) &&
+            (0 == *((volatile UINT32 *)&apSec->mWaitingThreadsCount)))
+        {
+            disp = K2OSKERN_SeqIntrLock(&apSec->SeqLock);
+            if ((apSec->Event.mIsSignalled) &&
+                (apSec->mWaitingThreadsCount == 0))
+            {
+                K2_ASSERT(apSec->Event.Hdr.WaitEntryPrioList.mNodeCount == 0);
+                apSec->Event.mIsSignalled = FALSE;
+                gotIntoSec = TRUE;
+            }
+            K2OSKERN_SeqIntrUnlock(&apSec->SeqLock, disp);
+            if (gotIntoSec)
+                break;
+        }
+
+        if (backoff > (budgetUs - spentUs))
+            backoff = budgetUs - spentUs;
+        K2OSKERN_MicroStall(backoff);
+        spentUs += backoff;
+        if (backoff < SPIN_MAX_BACKOFF_US)
+            backoff <<= 1;
+
+    } while (spentUs < budgetUs);
+
+    //
+    // stats are hints only and are not updated atomically
+    //
+    apSec->Stats.mSpinIterCount += iter;
+    if (gotIntoSec)
+        apSec->Stats.mSpinAcquireCount++;
+
+    return gotIntoSec;
+}
+
 BOOL K2_CALLCONV_CALLERCLEANS K2OS_CritSecInit(K2OS_CRITSEC *apSec)
 {
     K2STAT              stat;
@@ -52,6 +147,8 @@ BOOL K2_CALLCONV_CALLERCLEANS K2OS_CritSecInit(K2OS_CRITSEC *apSec)
 
     K2OSKERN_SeqIntrInit(&pSec->SeqLock);
 
+    pSec->Stats.mSpinLimit = K2OSKERN_CRITSEC_DEFAULT_SPIN;
+
     stat = KernEvent_Create(&pSec->Event, NULL, TRUE, TRUE);
     if (K2STAT_IS_ERROR(stat))
         return FALSE;
@@ -158,13 +255,36 @@ BOOL K2_CALLCONV_CALLERCLEANS K2OS_CritSecEnter(K2OS_CRITSEC *apSec)
         gotIntoSec = TRUE;
     }
     else
-    {
-        K2Trace(K2TRACE_THREAD_SEC_WAIT, 2, pThisThread->Env.mId, pSec);
-        pSec->mWaitingThreadsCount++;
         gotIntoSec = FALSE;
-    }
     K2OSKERN_SeqIntrUnlock(&pSec->SeqLock, disp);
 
+    if (!gotIntoSec)
+    {
+        //
+        // owner may be about to leave on another core.  spin a bit
+        // before we pay for a full block and wake
+        //
+        gotIntoSec = sSpinForSec(pSec);
+    }
+
+    if (!gotIntoSec)
+    {
+        disp = K2OSKERN_SeqIntrLock(&pSec->SeqLock);
+        if (pSec->Event.mIsSignalled)
+        {
+            K2_ASSERT(pSec->Event.Hdr.WaitEntryPrioList.mNodeCount == 0);
+            pSec->Event.mIsSignalled = FALSE;
+            gotIntoSec = TRUE;
+        }
+        else
+        {
+            K2Trace(K2TRACE_THREAD_SEC_WAIT, 2, pThisThread->Env.mId, pSec);
+            pSec->mWaitingThreadsCount++;
+            pSec->Stats.mBlockCount++;
+        }
+        K2OSKERN_SeqIntrUnlock(&pSec->SeqLock, disp);
+    }
+
     if (!gotIntoSec)
     {
         pHdr = &pSec->Event.Hdr;
@@ -311,3 +431,45 @@ BOOL K2_CALLCONV_CALLERCLEANS K2OS_CritSecDone(K2OS_CRITSEC *apSec)
 }
 
 
+
+BOOL K2_CALLCONV_REGS K2OSKERN_CritSecSetSpin(K2OS_CRITSEC *apSec, UINT32 aSpinLimit)
+{
+    K2OSKERN_CRITSEC *  pSec;
+
+    K2_ASSERT(apSec != NULL);
+    if (((NULL == apSec) || (((UINT32)apSec)) < K2OS_KVA_KERN_BASE))
+    {
+        K2OS_ThreadSetStatus(K2STAT_ERROR_BAD_ARGUMENT);
+        return FALSE;
+    }
+
+    if (aSpinLimit > K2OSKERN_CRITSEC_MAX_SPIN)
+        aSpinLimit = K2OSKERN_CRITSEC_MAX_SPIN;
+
+    pSec = (K2OSKERN_CRITSEC *)apSec;
+    pSec->Stats.mSpinLimit = aSpinLimit;
+
+    return TRUE;
+}
+
+BOOL K2_CALLCONV_REGS K2OSKERN_CritSecGetStats(K2OS_CRITSEC *apSec, K2OSKERN_CRITSEC_STATS *apRetStats)
+{
+    K2OSKERN_CRITSEC *  pSec;
+    BOOL                disp;
+
+    K2_ASSERT(apSec != NULL);
+    K2_ASSERT(apRetStats != NULL);
+    if ((NULL == apSec) || (((UINT32)apSec) < K2OS_KVA_KERN_BASE) || (NULL == apRetStats))
+    {
+        K2OS_ThreadSetStatus(K2STAT_ERROR_BAD_ARGUMENT);
+        return FALSE;
+    }
+
+    pSec = (K2OSKERN_CRITSEC *)apSec;
+
+    disp = K2OSKERN_SeqIntrLock(&pSec->SeqLock);
+    K2MEM_Copy(apRetStats, &pSec->Stats, sizeof(K2OSKERN_CRITSEC_STATS));
+    K2OSKERN_SeqIntrUnlock(&pSec->SeqLock, disp);
+
+    return TRUE;
+}
@@ -240,10 +240,8 @@ void * K2_CALLCONV_CALLERCLEANS K2OS_DlxFindExport(K2OS_TOKEN aTokDlx, UINT32 aD
 K2OS_TOKEN K2_CALLCONV_CALLERCLEANS K2OS_DlxAcquireAddressOwner(UINT32 aAddress, UINT32 *apRetSegment)
 {
     K2OSKERN_OBJ_SEGMENT *  pSeg;
-    K2TREE_NODE *           pTreeNode;
     K2OSKERN_OBJ_PROCESS *  pUseProc;
     K2OSKERN_OBJ_THREAD *   pCurThread;
-    BOOL                    disp;
     K2STAT                  stat;
     K2STAT                  stat2;
     K2OSKERN_OBJ_DLX *      pDlxObj;
@@ -264,45 +262,9 @@ K2OS_TOKEN K2_CALLCONV_CALLERCLEANS K2OS_DlxAcquireAddressOwner(UINT32 aAddress,
         pUseProc = pCurThread->mpProc;
     }
 
-    disp = K2OSKERN_SeqIntrLock(&pUseProc->SegTreeSeqLock);
-
-    pTreeNode = K2TREE_FindOrAfter(&pUseProc->SegTree, aAddress);
-    if (pTreeNode == NULL)
-    {
-        pTreeNode = K2TREE_LastNode(&pUseProc->SegTree);
-        pTreeNode = K2TREE_PrevNode(&pUseProc->SegTree, pTreeNode);
-        if (pTreeNode != NULL)
-        {
-            pSeg = K2_GET_CONTAINER(K2OSKERN_OBJ_SEGMENT, pTreeNode, ProcSegTreeNode);
-            K2_ASSERT(pSeg->ProcSegTreeNode.mUserVal < aAddress);
-        }
-        else
-        {
-            K2_ASSERT(pUseProc->SegTree.mNodeCount == 0);
-            pSeg = NULL;
-        }
-    }
-    else
-    {
-        if (pTreeNode->mUserVal != aAddress)
-        {
-            pTreeNode = K2TREE_PrevNode(&pUseProc->SegTree, pTreeNode);
-            if (pTreeNode != NULL)
-            {
-                pSeg = K2_GET_CONTAINER(K2OSKERN_OBJ_SEGMENT, pTreeNode, ProcSegTreeNode);
-                K2_ASSERT(pSeg->ProcSegTreeNode.mUserVal < aAddress);
-            }
-            else
-            {
-                pSeg = NULL;
-            }
-        }
-        else
-        {
-            pSeg = K2_GET_CONTAINER(K2OSKERN_OBJ_SEGMENT, pTreeNode, ProcSegTreeNode);
-        }
-    }
+    pDlxObj = NULL;
 
+    pSeg = KernMem_SegTreeFindAndRef(pUseProc, aAddress);
     if (pSeg != NULL)
     {
         //
@@ -322,10 +284,9 @@ K2OS_TOKEN K2_CALLCONV_CALLERCLEANS K2OS_DlxAcquireAddressOwner(UINT32 aAddress,
                 K2OSKERN_AddRefObject(&pDlxObj->Hdr);
             }
         }
+        K2OSKERN_ReleaseObject(&pSeg->Hdr);
     }
 
-    K2OSKERN_SeqIntrUnlock(&pUseProc->SegTreeSeqLock, disp);
-
     if (pDlxObj == NULL)
     {
         K2OS_ThreadSetStatus(K2STAT_ERROR_NOT_FOUND);
@@ -74,3 +74,58 @@ BOOL K2_CALLCONV_CALLERCLEANS K2OS_SysGetProperty(UINT32 aPropertyId, void *apRe
 
     return FALSE;
 }
+
+BOOL K2_CALLCONV_CALLERCLEANS K2OS_SysGetMemStats(UINT32 aProcessId, K2OS_MEMSTATS *apRetStats)
+{
+    BOOL                    disp;
+    K2OSKERN_OBJ_PROCESS *  pProc;
+    K2LIST_LINK *           pListLink;
+
+    if ((apRetStats == NULL) ||
+        (apRetStats->mStructBytes < sizeof(K2OS_MEMSTATS)))
+    {
+        K2OS_ThreadSetStatus(K2STAT_ERROR_BAD_ARGUMENT);
+        return FALSE;
+    }
+
+    if (gData.mKernInitStage < KernInitStage_MemReady)
+    {
+        K2OS_ThreadSetStatus(K2STAT_ERROR_NOT_READY);
+        return FALSE;
+    }
+
+    if (aProcessId == 0)
+    {
+        pProc = K2OSKERN_CURRENT_THREAD->mpProc;
+        K2MEM_Copy(&apRetStats->Proc, &pProc->MemStats, sizeof(K2OS_PROC_MEMSTATS));
+    }
+    else
+    {
+        pProc = NULL;
+        disp = K2OSKERN_SeqIntrLock(&gData.ProcListSeqLock);
+        pListLink = gData.ProcList.mpHead;
+        while (pListLink != NULL)
+        {
+            pProc = K2_GET_CONTAINER(K2OSKERN_OBJ_PROCESS, pListLink, ProcListLink);
+            if (pProc->mId == aProcessId)
+            {
+                K2MEM_Copy(&apRetStats->Proc, &pProc->MemStats, sizeof(K2OS_PROC_MEMSTATS));
+                break;
+            }
+            pListLink = pListLink->mpNext;
+        }
+        K2OSKERN_SeqIntrUnlock(&gData.ProcListSeqLock, disp);
+
+        if (pListLink == NULL)
+        {
+            K2OS_ThreadSetStatus(K2STAT_ERROR_NOT_FOUND);
+            return FALSE;
+        }
+    }
+
+    KernMem_GetStats(apRetStats);
+
+    apRetStats->mStructBytes = sizeof(K2OS_MEMSTATS);
+
+    return TRUE;
+}
@@ -47,6 +47,28 @@ BOOL K2_CALLCONV_CALLERCLEANS K2OS_VirtPagesAlloc(UINT32 *apAddr, UINT32 aPageCo
 
     K2_ASSERT((useAddr & K2_VA32_MEMPAGE_OFFSET_MASK) == 0);
 
+    if (aVirtAllocFlags & K2OS_VIRTALLOCFLAG_LAZY_COMMIT)
+    {
+#if K2_TARGET_ARCH_IS_ARM
+        //
+        // the a32 data abort path does not service demand-zero faults
+        //
+        K2OS_ThreadSetStatus(K2STAT_ERROR_NOT_SUPPORTED);
+        return FALSE;
+#else
+        //
+        // lazy pages are zero-filled on first touch, so they have to be
+        // writeable and it makes no sense to commit them up front as well
+        //
+        if ((aVirtAllocFlags & K2OS_VIRTALLOCFLAG_ALSO_COMMIT) ||
+            (0 == (aPageAttrFlags & K2OS_MEMPAGE_ATTR_WRITEABLE)))
+        {
+            K2OS_ThreadSetStatus(K2STAT_ERROR_BAD_ARGUMENT);
+            return FALSE;
+        }
+#endif
+    }
+
     pCurThread = K2OSKERN_CURRENT_THREAD;
 
     pSeg = NULL;
@@ -83,7 +105,19 @@ BOOL K2_CALLCONV_CALLERCLEANS K2OS_VirtPagesAlloc(UINT32 *apAddr, UINT32 aPageCo
             }
             pSeg->mSegAndMemPageAttr = K2OSKERN_SEG_ATTR_TYPE_SPARSE | aPageAttrFlags;
 
-            if (aVirtAllocFlags & K2OS_VIRTALLOCFLAG_ALSO_COMMIT)
+            if (aVirtAllocFlags & K2OS_VIRTALLOCFLAG_LAZY_COMMIT)
+            {
+                if (pCurThread->mWorkVirt_Range < K2OS_KVA_KERN_BASE)
+                {
+                    stat = K2STAT_ERROR_NOT_SUPPORTED;
+                    break;
+                }
+
+                pSeg->mSegAndMemPageAttr |= K2OSKERN_SEG_ATTR_DEMAND_ZERO;
+
+                stat = KernMem_CreateSegmentFromThread(pCurThread, pSeg, NULL);
+            }
+            else if (aVirtAllocFlags & K2OS_VIRTALLOCFLAG_ALSO_COMMIT)
             {
                 if (aPageAttrFlags & K2OS_MEMPAGE_ATTR_UNCACHED)
                 {
@@ -151,12 +185,10 @@ BOOL K2_CALLCONV_CALLERCLEANS K2OS_VirtPagesAlloc(UINT32 *apAddr, UINT32 aPageCo
 BOOL K2_CALLCONV_CALLERCLEANS K2OS_VirtPagesCommit(UINT32 aPagesAddr, UINT32 aPageCount, UINT32 aPageAttrFlags)
 {
     K2OSKERN_OBJ_SEGMENT *  pSeg;
-    K2TREE_NODE *           pTreeNode;
     K2OSKERN_OBJ_PROCESS *  pUseProc;
     K2OSKERN_OBJ_THREAD *   pCurThread;
     UINT32                  segPageCount;
     UINT32                  segOffset;
-    BOOL                    disp;
     K2STAT                  stat;
     KernPhys_Disp           physDisp;
 
@@ -174,45 +206,7 @@ BOOL K2_CALLCONV_CALLERCLEANS K2OS_VirtPagesCommit(UINT32 aPagesAddr, UINT32 aPa
         pUseProc = pCurThread->mpProc;
     }
 
-    disp = K2OSKERN_SeqIntrLock(&pUseProc->SegTreeSeqLock);
-
-    pTreeNode = K2TREE_FindOrAfter(&pUseProc->SegTree, aPagesAddr);
-    if (pTreeNode == NULL)
-    {
-        pTreeNode = K2TREE_LastNode(&pUseProc->SegTree);
-        pTreeNode = K2TREE_PrevNode(&pUseProc->SegTree, pTreeNode);
-        if (pTreeNode != NULL)
-        {
-            pSeg = K2_GET_CONTAINER(K2OSKERN_OBJ_SEGMENT, pTreeNode, ProcSegTreeNode);
-            K2_ASSERT(pSeg->ProcSegTreeNode.mUserVal < aPagesAddr);
-        }
-        else
-        {
-            K2_ASSERT(pUseProc->SegTree.mNodeCount == 0);
-            pSeg = NULL;
-        }
-    }
-    else
-    {
-        if (pTreeNode->mUserVal != aPagesAddr)
-        {
-            pTreeNode = K2TREE_PrevNode(&pUseProc->SegTree, pTreeNode);
-            if (pTreeNode != NULL)
-            {
-                pSeg = K2_GET_CONTAINER(K2OSKERN_OBJ_SEGMENT, pTreeNode, ProcSegTreeNode);
-                K2_ASSERT(pSeg->ProcSegTreeNode.mUserVal < aPagesAddr);
-            }
-            else
-            {
-                pSeg = NULL;
-            }
-        }
-        else
-        {
-            pSeg = K2_GET_CONTAINER(K2OSKERN_OBJ_SEGMENT, pTreeNode, ProcSegTreeNode);
-        }
-    }
-
+    pSeg = KernMem_SegTreeFindAndRef(pUseProc, aPagesAddr);
     if (pSeg != NULL)
     {
         //
@@ -220,25 +214,14 @@ BOOL K2_CALLCONV_CALLERCLEANS K2OS_VirtPagesCommit(UINT32 aPagesAddr, UINT32 aPa
         //
         segPageCount = pSeg->mPagesBytes / K2_VA32_MEMPAGE_BYTES;
         segOffset = (aPagesAddr - pSeg->ProcSegTreeNode.mUserVal) / K2_VA32_MEMPAGE_BYTES;
-        if (segOffset < segPageCount)
-        {
-            if ((segPageCount - segOffset) >= aPageCount)
-            {
-                K2OSKERN_AddRefObject(&pSeg->Hdr);
-            }
-            else
-            {
-                pSeg = NULL;
-            }
-        }
-        else
+        if ((segOffset >= segPageCount) ||
+            ((segPageCount - segOffset) < aPageCount))
         {
+            K2OSKERN_ReleaseObject(&pSeg->Hdr);
             pSeg = NULL;
         }
     }
 
-    K2OSKERN_SeqIntrUnlock(&pUseProc->SegTreeSeqLock, disp);
-
     if (pSeg == NULL)
     {
         K2OS_ThreadSetStatus(K2STAT_ERROR_NOT_FOUND);
@@ -307,12 +290,10 @@ BOOL K2_CALLCONV_CALLERCLEANS K2OS_VirtPagesCommit(UINT32 aPagesAddr, UINT32 aPa
 BOOL K2_CALLCONV_CALLERCLEANS K2OS_VirtPagesDecommit(UINT32 aPagesAddr, UINT32 aPageCount)
 {
     K2OSKERN_OBJ_SEGMENT *  pSeg;
-    K2TREE_NODE *           pTreeNode;
     K2OSKERN_OBJ_PROCESS *  pUseProc;
     K2OSKERN_OBJ_THREAD *   pCurThread;
     UINT32                  segPageCount;
     UINT32                  segOffset;
-    BOOL                    disp;
     K2STAT                  stat;
 
     pCurThread = K2OSKERN_CURRENT_THREAD;
@@ -329,45 +310,7 @@ BOOL K2_CALLCONV_CALLERCLEANS K2OS_VirtPagesDecommit(UINT32 aPagesAddr, UINT32 a
         pUseProc = pCurThread->mpProc;
     }
 
-    disp = K2OSKERN_SeqIntrLock(&pUseProc->SegTreeSeqLock);
-
-    pTreeNode = K2TREE_FindOrAfter(&pUseProc->SegTree, aPagesAddr);
-    if (pTreeNode == NULL)
-    {
-        pTreeNode = K2TREE_LastNode(&pUseProc->SegTree);
-        pTreeNode = K2TREE_PrevNode(&pUseProc->SegTree, pTreeNode);
-        if (pTreeNode != NULL)
-        {
-            pSeg = K2_GET_CONTAINER(K2OSKERN_OBJ_SEGMENT, pTreeNode, ProcSegTreeNode);
-            K2_ASSERT(pSeg->ProcSegTreeNode.mUserVal < aPagesAddr);
-        }
-        else
-        {
-            K2_ASSERT(pUseProc->SegTree.mNodeCount == 0);
-            pSeg = NULL;
-        }
-    }
-    else
-    {
-        if (pTreeNode->mUserVal != aPagesAddr)
-        {
-            pTreeNode = K2TREE_PrevNode(&pUseProc->SegTree, pTreeNode);
-            if (pTreeNode != NULL)
-            {
-                pSeg = K2_GET_CONTAINER(K2OSKERN_OBJ_SEGMENT, pTreeNode, ProcSegTreeNode);
-                K2_ASSERT(pSeg->ProcSegTreeNode.mUserVal < aPagesAddr);
-            }
-            else
-            {
-                pSeg = NULL;
-            }
-        }
-        else
-        {
-            pSeg = K2_GET_CONTAINER(K2OSKERN_OBJ_SEGMENT, pTreeNode, ProcSegTreeNode);
-        }
-    }
-
+    pSeg = KernMem_SegTreeFindAndRef(pUseProc, aPagesAddr);
     if (pSeg != NULL)
     {
         //
@@ -375,25 +318,14 @@ BOOL K2_CALLCONV_CALLERCLEANS K2OS_VirtPagesDecommit(UINT32 aPagesAddr, UINT32 a
         //
         segPageCount = pSeg->mPagesBytes / K2_VA32_MEMPAGE_BYTES;
         segOffset = (aPagesAddr - pSeg->ProcSegTreeNode.mUserVal) / K2_VA32_MEMPAGE_BYTES;
-        if (segOffset < segPageCount)
-        {
-            if ((segPageCount - segOffset) >= aPageCount)
-            {
-                K2OSKERN_AddRefObject(&pSeg->Hdr);
-            }
-            else
-            {
-                pSeg = NULL;
-            }
-        }
-        else
+        if ((segOffset >= segPageCount) ||
+            ((segPageCount - segOffset) < aPageCount))
         {
+            K2OSKERN_ReleaseObject(&pSeg->Hdr);
             pSeg = NULL;
         }
     }
 
-    K2OSKERN_SeqIntrUnlock(&pUseProc->SegTreeSeqLock, disp);
-
     if (pSeg == NULL)
     {
         K2OS_ThreadSetStatus(K2STAT_ERROR_NOT_FOUND);
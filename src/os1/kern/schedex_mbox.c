@@ -146,13 +146,25 @@ BOOL KernSched_Exec_MboxRespond(void)
     }
 
     K2LIST_Remove(&pMailbox->InSvcMsgList, &pMsg->MailboxListLink);
-    K2MEM_Copy(&pMsg->Io, gData.Sched.mpActiveItem->Args.MboxRespond.mpIn_ResponseIo, sizeof(K2OS_MSGIO));
     pMsg->mpMailbox = NULL;
-    pMsg->mState = KernMsgState_Completed;
-    gData.Sched.mpActiveItem->mSchedCallResult = K2STAT_NO_ERROR;
     gData.Sched.mpActiveItem->Args.MboxRespond.mpOut_MsgToRelease = pMsg;
     gData.Sched.mpActiveItem->Args.MboxRespond.mpOut_MailboxToRelease = pMailbox;
 
+    if (pMsg->mState == KernMsgState_Completed)
+    {
+        //
+        // sender abandoned this message while it was in service with lent buffers.
+        // the response goes nowhere, but the lent buffers can go now
+        //
+        gData.Sched.mpActiveItem->mSchedCallResult = K2STAT_ERROR_ABANDONED;
+        return FALSE;
+    }
+
+    K2_ASSERT(pMsg->mState == KernMsgState_InSvc);
+    K2MEM_Copy(&pMsg->Io, gData.Sched.mpActiveItem->Args.MboxRespond.mpIn_ResponseIo, sizeof(K2OS_MSGIO));
+    pMsg->mState = KernMsgState_Completed;
+    gData.Sched.mpActiveItem->mSchedCallResult = K2STAT_NO_ERROR;
+
     return KernSchedEx_EventChange(&pMsg->CompletionEvent, TRUE);
 }
 
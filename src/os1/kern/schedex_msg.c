@@ -139,6 +139,22 @@ BOOL KernSched_Exec_MsgAbort(void)
     pMailbox = pMsg->mpMailbox;
     K2_ASSERT(pMailbox != NULL);
 
+    if ((pMsg->mState == KernMsgState_InSvc) &&
+        ((pMsg->mpInLent != NULL) || (pMsg->mpOutLent != NULL)))
+    {
+        //
+        // the service may still be using the lent buffers. complete the message
+        // for the sender but leave it in service, holding its references, until
+        // the service responds. it cannot be cleared and sent again until then
+        //
+        pMsg->Io.mStatus = K2STAT_ERROR_ABANDONED;
+        pMsg->mState = KernMsgState_Completed;
+        gData.Sched.mpActiveItem->Args.MsgAbort.mpOut_MailboxToRelease = NULL;
+        gData.Sched.mpActiveItem->Args.MsgAbort.mpOut_MsgToRelease = NULL;
+        gData.Sched.mpActiveItem->mSchedCallResult = K2STAT_NO_ERROR;
+        return KernSchedEx_EventChange(&pMsg->CompletionEvent, TRUE);
+    }
+
     changedSomething = FALSE;
 
     gData.Sched.mpActiveItem->Args.MsgAbort.mpOut_MailboxToRelease = pMailbox;
@@ -38,11 +38,21 @@ sWaitList_Insert(
     K2OSKERN_SCHED_WAITENTRY *  apEntry
 )
 {
-    K2OSKERN_OBJ_THREAD *       pOtherThread;
     K2LIST_ANCHOR *             pAnchor;
     K2LIST_LINK *               pListLink;
-    K2OSKERN_SCHED_MACROWAIT *  pOtherWait;
     K2OSKERN_SCHED_WAITENTRY *  pOtherEntry;
+    UINT32                      prio;
+
+    //
+    // list is kept in priority order, FIFO within a priority level.  each entry
+    // holds the priority it was inserted with so the list can be ordered without
+    // going through the macrowait to the thread for every entry. the usual cases
+    // (same or lower priority than everything there, or higher than everything
+    // there) hit the tail or head directly
+    //
+    prio = apWaitThread->Sched.mThreadActivePrio;
+    K2_ASSERT(prio < K2OS_THREADPRIO_LEVELS);
+    apEntry->mWaitPrio = (UINT8)prio;
 
     pAnchor = &apEntry->mWaitObj.mpHdr->WaitEntryPrioList;
     if (pAnchor->mNodeCount == 0)
@@ -51,23 +61,34 @@ sWaitList_Insert(
         return;
     }
 
-    pListLink = pAnchor->mpHead;
+    pOtherEntry = K2_GET_CONTAINER(K2OSKERN_SCHED_WAITENTRY, pAnchor->mpTail, WaitPrioListLink);
+    if (pOtherEntry->mWaitPrio <= prio)
+    {
+        K2LIST_AddAtTail(pAnchor, &apEntry->WaitPrioListLink);
+        return;
+    }
+
+    pOtherEntry = K2_GET_CONTAINER(K2OSKERN_SCHED_WAITENTRY, pAnchor->mpHead, WaitPrioListLink);
+    if (pOtherEntry->mWaitPrio > prio)
+    {
+        K2LIST_AddAtHead(pAnchor, &apEntry->WaitPrioListLink);
+        return;
+    }
+
+    //
+    // goes somewhere in the middle. walk back from the tail past the entries
+    // of lower priority. the head is known to stop the walk
+    //
+    pListLink = pAnchor->mpTail->mpPrev;
     do {
+        K2_ASSERT(pListLink != NULL);
         pOtherEntry = K2_GET_CONTAINER(K2OSKERN_SCHED_WAITENTRY, pListLink, WaitPrioListLink);
-        pOtherWait = K2_GET_CONTAINER(K2OSKERN_SCHED_MACROWAIT, pOtherEntry, SchedWaitEntry[pOtherEntry->mMacroIndex]);
-        pOtherThread = pOtherWait->mpWaitingThread;
-        if (pOtherThread->Sched.mThreadActivePrio > apWaitThread->Sched.mThreadActivePrio)
+        if (pOtherEntry->mWaitPrio <= prio)
             break;
-        pListLink = pListLink->mpNext;
-    } while (pListLink != NULL);
+        pListLink = pListLink->mpPrev;
+    } while (1);
 
-    //
-    // pOtherThread is of lower priority than apWaitThread
-    //
-    if (pListLink != NULL)
-        K2LIST_AddBefore(pAnchor, &apEntry->WaitPrioListLink, &pOtherEntry->WaitPrioListLink);
-    else
-        K2LIST_AddAtTail(pAnchor, &apEntry->WaitPrioListLink);
+    K2LIST_AddAfter(pAnchor, &apEntry->WaitPrioListLink, &pOtherEntry->WaitPrioListLink);
 }
 
 void sWaitList_Remove(
@@ -32,6 +32,13 @@
 
 #include "kern.h"
 
+//
+// every address space in os1 is the one kernel address space, so lending a
+// buffer costs a segment, a map, an unmap and a tlb shootdown and saves no
+// copy. leave it off until buffers can be lent into user address spaces
+//
+#define SVC_LEND_BUFFERS    0
+
 K2OS_TOKEN
 K2OSKERN_ServiceCreate(
     K2OS_TOKEN  aTokMailbox,
@@ -762,6 +769,42 @@ K2OSKERN_ServiceCall(
             pCall->mpServiceContext = pSvc->mpContext;
             pCall->mpPublishContext = pPublish->mpContext;
 
+#if SVC_LEND_BUFFERS
+            //
+            // lend big page aligned buffers to the service. the message holds
+            // the lent segments until it goes away, which is not until the
+            // service has responded. if lending fails the service just uses
+            // the caller's buffer address directly
+            //
+            if ((aInBufBytes >= K2OSKERN_SVC_BULK_MIN_BYTES) &&
+                (0 == (((UINT32)apInBuf) & K2_VA32_MEMPAGE_OFFSET_MASK)))
+            {
+                stat = KernMem_LendPages(
+                    (UINT32)apInBuf,
+                    K2_ROUNDUP(aInBufBytes, K2_VA32_MEMPAGE_BYTES) / K2_VA32_MEMPAGE_BYTES,
+                    FALSE,
+                    &pMsg->mpInLent);
+                if (!K2STAT_IS_ERROR(stat))
+                    pCall->mpInBuf = (void const *)pMsg->mpInLent->ProcSegTreeNode.mUserVal;
+                else
+                    pMsg->mpInLent = NULL;
+            }
+
+            if ((aOutBufBytes >= K2OSKERN_SVC_BULK_MIN_BYTES) &&
+                (0 == (((UINT32)apOutBuf) & K2_VA32_MEMPAGE_OFFSET_MASK)))
+            {
+                stat = KernMem_LendPages(
+                    (UINT32)apOutBuf,
+                    K2_ROUNDUP(aOutBufBytes, K2_VA32_MEMPAGE_BYTES) / K2_VA32_MEMPAGE_BYTES,
+                    TRUE,
+                    &pMsg->mpOutLent);
+                if (!K2STAT_IS_ERROR(stat))
+                    pCall->mpOutBuf = (void *)pMsg->mpOutLent->ProcSegTreeNode.mUserVal;
+                else
+                    pMsg->mpOutLent = NULL;
+            }
+#endif
+
             stat = KernMsg_Send(pSvc->mpMailbox, pMsg, &msgIo);
             if (!K2STAT_IS_ERROR(stat))
             {
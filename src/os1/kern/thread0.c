@@ -163,6 +163,7 @@ sExec_Init(
     gData.mfExecReadDlx = initInfo.ReadDlx;
     K2_ASSERT(initInfo.DoneDlx != NULL);
     gData.mfExecDoneDlx = initInfo.DoneDlx;
+    gData.mfExecStartReadDlx = initInfo.StartReadDlx;   // optional
 
     //
     // get hal export for system ready callback
@@ -405,6 +406,11 @@ UINT32 K2_CALLCONV_REGS K2OSKERN_Thread0(void *apArg)
     //
     KernAcpi_Init();
 
+    //
+    // start keeping the clean page list stocked
+    //
+    KernMem_StartZeroThread();
+
     //
     // dump the object tree
     //
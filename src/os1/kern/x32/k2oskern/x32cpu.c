@@ -137,6 +137,10 @@ void K2_CALLCONV_REGS X32Kern_CpuLaunch(UINT32 aCpuCoreIndex)
 
     pCorePage->CpuCore.mIsInMonitor = TRUE;
 
+    /* match core 0 large page support */
+    if (gX32Kern_CpuId01.EDX & X32_CPUID1_EDX_PSE)
+        X32_WriteCR4(X32_ReadCR4() | X32_CR4_PAGE_SIZE_EXT);
+
     /* set up TSS selector in GDT */
     pTSS = &pCorePage->CpuCore.TSS;
     pTSSEntry = &gX32Kern_GDT[X32_SEGMENT_TSS0 + aCpuCoreIndex];
@@ -177,6 +177,16 @@ sOnException(
     //
     if (pCurThread->mIsInKernelMode)
     {
+        if ((isPageFault) &&
+            (0 != (apContext->KernelMode.EFLAGS & X32_EFLAGS_INTENABLE)) &&
+            (KernMem_ServiceDemandFault(X32_ReadCR2())))
+        {
+            //
+            // touched a demand-zero page that is now there. retry the instruction
+            //
+            return FALSE;
+        }
+
         pExTrap = pCurThread->mpKernExTrapStack;
         if (pExTrap != NULL)
         {
@@ -68,6 +68,16 @@ static void sInit_AtDlxEntry(void)
     gX32Kern_CpuId01.EDX = 0xFFFFFFFF;
     X32_CallCPUID(&gX32Kern_CpuId01);
 
+    //
+    // turn on 4MB pages if the cpu has them so contiguous physical
+    // ranges can be mapped with a single directory entry.  other
+    // cores turn this on when they launch
+    //
+    if (gX32Kern_CpuId01.EDX & X32_CPUID1_EDX_PSE)
+    {
+        X32_WriteCR4(X32_ReadCR4() | X32_CR4_PAGE_SIZE_EXT);
+    }
+
     //
     // save the kernel physical page directory location
     // in a place that the assembly code can easily get to it
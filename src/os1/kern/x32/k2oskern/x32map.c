@@ -64,6 +64,62 @@ void  KernArch_WritePTE(BOOL aIsMake, UINT32 aVirtAddr, UINT32* pPTE, UINT32 aPT
     *pPTE = aPTE;
 }
 
+void KernArch_FlushPTERange(UINT32 aVirtAddr, UINT32 *apFirstPTE, UINT32 aPteCount)
+{
+    //
+    // pagetable walks are coherent with the data cache. tlb is done by the caller
+    //
+    K2_CpuWriteBarrier();
+}
+
+UINT32 KernArch_MakeLargePDE(UINT32 aPhysAddr, UINT32 aPageMapAttr)
+{
+    UINT32 pde;
+
+    if (0 == (gX32Kern_CpuId01.EDX & X32_CPUID1_EDX_PSE))
+        return 0;
+
+    K2_ASSERT(0 == (aPhysAddr & ~X32_PDE_LARGEPHYS_MASK));
+
+    pde = X32_PDE_PRESENT | X32_PDE_PAGESIZE_4MB | aPhysAddr;
+
+    if (aPageMapAttr & K2OS_MEMPAGE_ATTR_WRITEABLE)
+        pde |= X32_PDE_WRITEABLE;
+
+    if (aPageMapAttr & (K2OS_MEMPAGE_ATTR_UNCACHED | K2OS_MEMPAGE_ATTR_DEVICEIO))
+        pde |= X32_PDE_CACHEDISABLE;
+    else if (aPageMapAttr & K2OS_MEMPAGE_ATTR_WRITE_THRU)
+        pde |= X32_PDE_WRITETHROUGH;
+
+    if (!(aPageMapAttr & K2OS_MEMPAGE_ATTR_KERNEL))
+        pde |= X32_PDE_USER;
+    else
+        pde |= X32_PDE_GLOBAL;
+
+    return pde;
+}
+
+void KernArch_WriteLargePDE(UINT32 *apPDE, UINT32 aPDE)
+{
+    *apPDE = aPDE;
+}
+
+BOOL KernArch_IsLargePDE(UINT32 aPDE)
+{
+    return ((aPDE & (X32_PDE_PRESENT | X32_PDE_PAGESIZE_4MB)) == (X32_PDE_PRESENT | X32_PDE_PAGESIZE_4MB)) ? TRUE : FALSE;
+}
+
+UINT32 KernArch_LargePDEToPTE(UINT32 aPDE, UINT32 aVirtAddr)
+{
+    //
+    // pte for the 4K page at aVirtAddr inside a 4MB page. the low attribute
+    // bits are in the same place except for the page size bit
+    //
+    return (aPDE & X32_PDE_LARGEPHYS_MASK) |
+           (aVirtAddr & (K2_VA32_PAGETABLE_MAP_BYTES - 1) & X32_PTE_PAGEPHYS_MASK) |
+           (aPDE & (X32_PTE_PRESENT | X32_PTE_WRITEABLE | X32_PTE_USER | X32_PTE_WRITETHROUGH | X32_PTE_CACHEDISABLE | X32_PTE_GLOBAL));
+}
+
 void  KernArch_AuditVirt(UINT32 aVirtAddr, UINT32 aPDE, UINT32 aPTE, UINT32 aAccessAttr)
 {
     
@@ -97,7 +153,15 @@ UINT32 * KernArch_Translate(K2OSKERN_OBJ_PROCESS *apProc, UINT32 aVirtAddr, UINT
 
     *apRetPtPresent = TRUE;
 
-    if (aVirtAddr >= K2OS_KVA_KERN_BASE)
+    if (KernArch_IsLargePDE(*pPDE))
+    {
+        //
+        // no pagetable. report the pte the large page implies for this address
+        //
+        pPTE = NULL;
+        pte = KernArch_LargePDEToPTE(*pPDE, aVirtAddr);
+    }
+    else if (aVirtAddr >= K2OS_KVA_KERN_BASE)
     {
         pPTE = ((UINT32*)K2OS_KVA_TO_PTE_ADDR(aVirtAddr));
     }
@@ -113,7 +177,9 @@ UINT32 * KernArch_Translate(K2OSKERN_OBJ_PROCESS *apProc, UINT32 aVirtAddr, UINT
             pPTE = ((UINT32*)K2_VA32_TO_PTE_ADDR(apProc->mVirtMapKVA, aVirtAddr));
     }
 
-    *apRetPte = pte = *pPTE;
+    if (pPTE != NULL)
+        pte = *pPTE;
+    *apRetPte = pte;
 
     if (pte & X32_PTE_WRITEABLE)
     {
@@ -71,6 +71,18 @@ UINT32  K2_CALLCONV_REGS K2OSKERN_GetCpuIndex(void);
 //------------------------------------------------------------------------
 //
 
+//
+// physically contiguous ranges for dma.  aAlignPages is a power of two, zero
+// meaning page aligned.  a nonzero aPhysLimit is the address the whole range 
+// must end at or below.  the range is exactly aPageCount pages and is not zeroed
+//
+K2STAT  K2OSKERN_PhysAllocContig(UINT32 aPageCount, UINT32 aAlignPages, UINT32 aPhysLimit, UINT32 *apRetPhysAddr);
+K2STAT  K2OSKERN_PhysFreeContig(UINT32 aPhysAddr);
+
+//
+//------------------------------------------------------------------------
+//
+
 #if __cplusplus
 }
 #endif
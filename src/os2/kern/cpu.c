@@ -54,6 +54,10 @@ KernCpu_Init(
         K2LIST_Init((K2LIST_ANCHOR *)&pCore->RunList);
 
         K2LIST_Init((K2LIST_ANCHOR *)&pCore->IciOutList);
+
+        K2OSKERN_SeqInit((K2OSKERN_SEQLOCK *)&pCore->PhysCacheSeqLock);
+        K2LIST_Init((K2LIST_ANCHOR *)&pCore->PhysCache_Clean);
+        K2LIST_Init((K2LIST_ANCHOR *)&pCore->PhysCache_Dirty);
     }
 
     K2_CpuWriteBarrier();
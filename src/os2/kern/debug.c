@@ -90,11 +90,12 @@ KernDbg_FindClosestSymbol(
     UINT32                  aRetSymNameBufLen
 )
 {
-    UINT32          b, e, m, v;
-    K2LIST_LINK *   pDlxListLink;
-    DLX *           pDlx;
-    UINT32          segStart;
-    K2TREE_NODE *   pTreeNode;
+    UINT32              b, e, m, v;
+    K2LIST_LINK *       pDlxListLink;
+    DLX *               pDlx;
+    UINT32              segStart;
+    K2DLX_SYMINDEX *    pIndex;
+    Elf32_Sym const *   pSym;
 
     if ((NULL == apRetSymName) ||
         (0 == aRetSymNameBufLen))
@@ -159,14 +160,31 @@ KernDbg_FindClosestSymbol(
                     if ((aAddr >= segStart) &&
                         (aAddr < segStart + pDlx->mpInfo->SegInfo[DlxSeg_Text].mMemActualBytes))
                     {
-                        pTreeNode = K2TREE_FindOrAfter(&pDlx->SymTree[0], aAddr);
-                        if (NULL != pTreeNode)
+                        if (0 == (pDlx->mFlags & K2DLXSUPP_FLAG_KEEP_SYMBOLS))
+                        {
+                            *apRetSymName = 0;
+                            break;
+                        }
+                        pIndex = &pDlx->SymIndex[0];
+                        b = 0;
+                        e = pIndex->mCount;
+                        while (b < e)
+                        {
+                            m = (b + e) / 2;
+                            pSym = (Elf32_Sym const *)(pIndex->mpSymBase + (pIndex->mpIx[m] * pIndex->mSymEntBytes));
+                            if (pSym->st_value > aAddr)
+                                e = m;
+                            else
+                                b = m + 1;
+                        }
+                        if (b > 0)
                         {
                             /* found the symbol */
+                            pSym = (Elf32_Sym const *)(pIndex->mpSymBase + (pIndex->mpIx[b - 1] * pIndex->mSymEntBytes));
                             K2ASC_PrintfLen(apRetSymName, aRetSymNameBufLen,
-                                "%s+%x%X",
-                                ((K2DLX_SYMTREE_NODE *)pTreeNode)->mpSymName,
-                                aAddr - pTreeNode->mUserVal);
+                                "%s+0x%X",
+                                pIndex->mpSymStr + pSym->st_name,
+                                aAddr - pSym->st_value);
                         }
                         // stop looking
                         pDlxListLink = NULL;
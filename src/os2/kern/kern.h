@@ -223,6 +223,10 @@ struct _K2OSKERN_CPUCORE
     K2OSKERN_OBJ_THREAD             IdleThread;
     BOOL                            mThreadChanged;
     K2OSKERN_OBJ_THREAD * volatile  mpMigratedHead;
+
+    K2OSKERN_SEQLOCK                PhysCacheSeqLock;   // owner core takes it uncontended. others only to drain
+    K2LIST_ANCHOR                   PhysCache_Clean;
+    K2LIST_ANCHOR                   PhysCache_Dirty;
 };
 
 #define K2OSKERN_COREMEMORY_STACKS_BYTES  ((K2_VA32_MEMPAGE_BYTES - sizeof(K2OSKERN_CPUCORE)) + (K2_VA32_MEMPAGE_BYTES * 3))
@@ -266,6 +270,11 @@ enum _KernPhysPageList
 
     KernPhysPageList_Count,         //  17
 
+    KernPhysPageList_Contig = 21,             // allocated with K2OSKERN_PhysAllocContig
+
+    KernPhysPageList_Core_Dirty = 24,         // on a cpu core's free page cache, dirty
+    KernPhysPageList_Core_Clean = 25,         // on a cpu core's free page cache, clean
+
     KernPhysPageList_Thread_Working = 26,     // temporarily set as thread working page
     KernPhysPageList_Thread_PtWorking = 27,   // temporarily set as thread pt working page
     KernPhysPageList_Thread_Dirty  = 28,      // temporarily on thread dirty list
@@ -805,56 +805,238 @@ KernPhys_RenderPtMap(
     K2OSKERN_SeqUnlock(&gData.PhysMemSeqLock, disp);
 }
 
-UINT32  
-KernPhys_AllocOneKernelPage(
-    K2OSKERN_OBJ_HEADER *apPageOwner
+//
+// single kernel pages come from a small per-core cache of free pages so that the
+// common case never touches the physical memory lock.  the cache is refilled from
+// and drained to the global lists in batches.  interrupts are off while a core
+// works with its own cache so the thread cannot migrate off of the core.  the core
+// holds its own cache lock while it does so; other cores only take it to drain the
+// cache back to the global lists when memory runs out.  core lock is taken first
+//
+#define PHYS_CORECACHE_BATCH    16
+#define PHYS_CORECACHE_MAX      64
+
+static void
+sCoreCacheRefill(
+    K2OSKERN_CPUCORE volatile * apThisCore
 )
 {
+    K2LIST_ANCHOR *             pCache;
+    K2LIST_ANCHOR *             pList;
     K2TREE_NODE *               pTreeNode;
-    UINT32                      userVal;
     K2OSKERN_PHYSTRACK_PAGE *   pTrackPage;
-    BOOL                        disp;
+    UINT32                      userVal;
+    UINT32                      nodeCount;
+    UINT32                      left;
 
-    disp = K2OSKERN_SeqLock(&gData.PhysMemSeqLock);
+    left = PHYS_CORECACHE_BATCH;
+
+    K2OSKERN_SeqLock(&gData.PhysMemSeqLock);
 
-    if (gData.PhysPageList[KernPhysPageList_Free_Clean].mNodeCount > 0)
+    pCache = (K2LIST_ANCHOR *)&apThisCore->PhysCache_Clean;
+    pList = &gData.PhysPageList[KernPhysPageList_Free_Clean];
+    while ((left > 0) && (pList->mNodeCount > 0))
     {
-        pTrackPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, gData.PhysPageList[KernPhysPageList_Free_Clean].mpHead, ListLink);
-        K2LIST_Remove(&gData.PhysPageList[KernPhysPageList_Free_Clean], &pTrackPage->ListLink);
+        pTrackPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, pList->mpHead, ListLink);
+        K2LIST_Remove(pList, &pTrackPage->ListLink);
+        pTrackPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
+        pTrackPage->mFlags |= (KernPhysPageList_Core_Clean << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+        K2LIST_AddAtTail(pCache, &pTrackPage->ListLink);
+        left--;
     }
-    else if (gData.PhysPageList[KernPhysPageList_Free_Dirty].mNodeCount > 0)
+
+    pCache = (K2LIST_ANCHOR *)&apThisCore->PhysCache_Dirty;
+    pList = &gData.PhysPageList[KernPhysPageList_Free_Dirty];
+    while ((left > 0) && (pList->mNodeCount > 0))
     {
-        pTrackPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, gData.PhysPageList[KernPhysPageList_Free_Dirty].mpHead, ListLink);
-        K2LIST_Remove(&gData.PhysPageList[KernPhysPageList_Free_Dirty], &pTrackPage->ListLink);
+        pTrackPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, pList->mpHead, ListLink);
+        K2LIST_Remove(pList, &pTrackPage->ListLink);
+        pTrackPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
+        pTrackPage->mFlags |= (KernPhysPageList_Core_Dirty << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+        K2LIST_AddAtTail(pCache, &pTrackPage->ListLink);
+        left--;
     }
-    else
+
+    while (left > 0)
     {
+        //
+        // carve pages off the smallest node in the free tree
+        //
         pTreeNode = K2TREE_FirstNode(&gData.PhysFreeTree);
         if (NULL == pTreeNode)
-        {
-            K2OSKERN_SeqUnlock(&gData.PhysMemSeqLock, disp);
-            return 0;
-        }
+            break;
 
         userVal = pTreeNode->mUserVal;
         K2TREE_Remove(&gData.PhysFreeTree, pTreeNode);
-        pTrackPage = (K2OSKERN_PHYSTRACK_PAGE*)pTreeNode;
-        if ((userVal >> K2OSKERN_PHYSTRACK_PAGE_COUNT_SHL) > 1)
+
+        nodeCount = userVal >> K2OSKERN_PHYSTRACK_PAGE_COUNT_SHL;
+        if (nodeCount > left)
         {
-            // some space was left in the smallest node in the tree so
-            // put that space back on the physical memory tree
-            pTreeNode++;
-            pTreeNode->mUserVal = userVal - (1 << K2OSKERN_PHYSTRACK_PAGE_COUNT_SHL);
-            K2TREE_Insert(&gData.PhysFreeTree, pTreeNode->mUserVal, pTreeNode);
+            //
+            // put the space we are not taking back on the physical memory tree
+            //
+            (pTreeNode + left)->mUserVal = userVal - (left << K2OSKERN_PHYSTRACK_PAGE_COUNT_SHL);
+            K2TREE_Insert(&gData.PhysFreeTree, (pTreeNode + left)->mUserVal, pTreeNode + left);
+            nodeCount = left;
         }
+        left -= nodeCount;
+
+        pTrackPage = (K2OSKERN_PHYSTRACK_PAGE *)pTreeNode;
+        do {
+            pTrackPage->mFlags = (KernPhysPageList_Core_Dirty << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL) | (userVal & K2OSKERN_PHYSTRACK_PROP_MASK);
+            pTrackPage->mpOwnerObject = NULL;
+            K2LIST_AddAtTail(pCache, &pTrackPage->ListLink);
+            pTrackPage++;
+        } while (--nodeCount);
     }
 
-    // put the allocated page on the overhead list
-    pTrackPage->mFlags = (KernPhysPageList_KOver << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL) | (userVal & K2OSKERN_PHYSTRACK_PROP_MASK);
+    K2OSKERN_SeqUnlock(&gData.PhysMemSeqLock, FALSE);
+}
+
+static void
+sCoreCacheDrain(
+    K2OSKERN_CPUCORE volatile * apThisCore
+)
+{
+    K2LIST_ANCHOR *             pCache;
+    K2OSKERN_PHYSTRACK_PAGE *   pTrackPage;
+    UINT32                      left;
+
+    //
+    // oldest dirty pages go back to the system so the zeroer can get at them
+    //
+    pCache = (K2LIST_ANCHOR *)&apThisCore->PhysCache_Dirty;
+    left = PHYS_CORECACHE_BATCH;
+
+    K2OSKERN_SeqLock(&gData.PhysMemSeqLock);
+
+    while ((left > 0) && (pCache->mNodeCount > 0))
+    {
+        pTrackPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, pCache->mpHead, ListLink);
+        K2LIST_Remove(pCache, &pTrackPage->ListLink);
+        pTrackPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
+        pTrackPage->mFlags |= (KernPhysPageList_Free_Dirty << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+        K2LIST_AddAtTail(&gData.PhysPageList[KernPhysPageList_Free_Dirty], &pTrackPage->ListLink);
+        left--;
+    }
+
+    K2OSKERN_SeqUnlock(&gData.PhysMemSeqLock, FALSE);
+}
+
+static void
+sCoreCacheDrainList(
+    K2LIST_ANCHOR * apCache,
+    KernPhysPageList aToList
+)
+{
+    K2OSKERN_PHYSTRACK_PAGE *   pTrackPage;
+
+    while (apCache->mNodeCount > 0)
+    {
+        pTrackPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, apCache->mpHead, ListLink);
+        K2LIST_Remove(apCache, &pTrackPage->ListLink);
+        pTrackPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
+        pTrackPage->mFlags |= (aToList << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+        K2LIST_AddAtTail(&gData.PhysPageList[aToList], &pTrackPage->ListLink);
+    }
+}
+
+static UINT32
+sCoreCacheDrainAll(
+    void
+)
+{
+    K2OSKERN_CPUCORE volatile * pCore;
+    UINT32                      coreIx;
+    UINT32                      result;
+
+    //
+    // interrupts must be off. empties every core's cache back to the global lists
+    // and returns how many pages came back
+    //
+    result = 0;
+
+    for (coreIx = 0; coreIx < gData.LoadInfo.mCpuCoreCount; coreIx++)
+    {
+        pCore = K2OSKERN_COREIX_TO_CPUCORE(coreIx);
+
+        K2OSKERN_SeqLock((K2OSKERN_SEQLOCK *)&pCore->PhysCacheSeqLock);
+        K2OSKERN_SeqLock(&gData.PhysMemSeqLock);
+
+        result += pCore->PhysCache_Clean.mNodeCount + pCore->PhysCache_Dirty.mNodeCount;
+        sCoreCacheDrainList((K2LIST_ANCHOR *)&pCore->PhysCache_Clean, KernPhysPageList_Free_Clean);
+        sCoreCacheDrainList((K2LIST_ANCHOR *)&pCore->PhysCache_Dirty, KernPhysPageList_Free_Dirty);
+
+        K2OSKERN_SeqUnlock(&gData.PhysMemSeqLock, FALSE);
+        K2OSKERN_SeqUnlock((K2OSKERN_SEQLOCK *)&pCore->PhysCacheSeqLock, FALSE);
+    }
+
+    return result;
+}
+
+UINT32  
+KernPhys_AllocOneKernelPage(
+    K2OSKERN_OBJ_HEADER *apPageOwner
+)
+{
+    K2OSKERN_CPUCORE volatile * pThisCore;
+    K2LIST_ANCHOR *             pCache;
+    K2OSKERN_PHYSTRACK_PAGE *   pTrackPage;
+    BOOL                        disp;
+
+    disp = K2OSKERN_SetIntr(FALSE);
+
+    pThisCore = K2OSKERN_GET_CURRENT_CPUCORE;
+
+    K2OSKERN_SeqLock((K2OSKERN_SEQLOCK *)&pThisCore->PhysCacheSeqLock);
+
+    if ((0 == pThisCore->PhysCache_Clean.mNodeCount) &&
+        (0 == pThisCore->PhysCache_Dirty.mNodeCount))
+    {
+        sCoreCacheRefill(pThisCore);
+
+        if ((0 == pThisCore->PhysCache_Clean.mNodeCount) &&
+            (0 == pThisCore->PhysCache_Dirty.mNodeCount))
+        {
+            //
+            // global lists are empty. pages may still be sitting in other cores' caches
+            //
+            K2OSKERN_SeqUnlock((K2OSKERN_SEQLOCK *)&pThisCore->PhysCacheSeqLock, FALSE);
+            if (0 == sCoreCacheDrainAll())
+            {
+                K2OSKERN_SetIntr(disp);
+                return 0;
+            }
+            K2OSKERN_SeqLock((K2OSKERN_SEQLOCK *)&pThisCore->PhysCacheSeqLock);
+            sCoreCacheRefill(pThisCore);
+        }
+    }
+
+    pCache = (K2LIST_ANCHOR *)&pThisCore->PhysCache_Clean;
+    if (0 == pCache->mNodeCount)
+    {
+        pCache = (K2LIST_ANCHOR *)&pThisCore->PhysCache_Dirty;
+        if (0 == pCache->mNodeCount)
+        {
+            K2OSKERN_SeqUnlock((K2OSKERN_SEQLOCK *)&pThisCore->PhysCacheSeqLock, FALSE);
+            K2OSKERN_SetIntr(disp);
+            return 0;
+        }
+    }
+
+    pTrackPage = K2_GET_CONTAINER(K2OSKERN_PHYSTRACK_PAGE, pCache->mpHead, ListLink);
+    K2LIST_Remove(pCache, &pTrackPage->ListLink);
+
+    //
+    // the page is an overhead page by list id and owner.  it is not linked onto the
+    // global overhead list as that would need the physical memory lock
+    //
+    pTrackPage->mFlags = (KernPhysPageList_KOver << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL) | (pTrackPage->mFlags & K2OSKERN_PHYSTRACK_PROP_MASK);
     pTrackPage->mpOwnerObject = apPageOwner;
-    K2LIST_AddAtTail(&gData.PhysPageList[KernPhysPageList_KOver], &pTrackPage->ListLink);
 
-    K2OSKERN_SeqUnlock(&gData.PhysMemSeqLock, disp);
+    K2OSKERN_SeqUnlock((K2OSKERN_SEQLOCK *)&pThisCore->PhysCacheSeqLock, FALSE);
+
+    K2OSKERN_SetIntr(disp);
 
     return K2OS_PHYSTRACK_TO_PHYS32((UINT32)pTrackPage);
 }
@@ -864,19 +1046,203 @@ KernPhys_FreeOneKernelPage(
     UINT32 aPagePhys
 )
 {
+    K2OSKERN_CPUCORE volatile * pThisCore;
     K2OSKERN_PHYSTRACK_PAGE *   pTrackPage;
     BOOL                        disp;
 
-    disp = K2OSKERN_SeqLock(&gData.PhysMemSeqLock);
-
     pTrackPage = (K2OSKERN_PHYSTRACK_PAGE *)K2OS_PHYS32_TO_PHYSTRACK(aPagePhys);
     K2_ASSERT(KernPhysPageList_KOver == K2OSKERN_PHYSTRACK_PAGE_FLAGS_GET_LIST(pTrackPage->mFlags));
+
+    disp = K2OSKERN_SetIntr(FALSE);
+
+    pThisCore = K2OSKERN_GET_CURRENT_CPUCORE;
+
+    K2OSKERN_SeqLock((K2OSKERN_SEQLOCK *)&pThisCore->PhysCacheSeqLock);
+
     pTrackPage->mpOwnerObject = NULL;
     pTrackPage->mFlags &= ~K2OSKERN_PHYSTRACK_PAGE_LIST_MASK;
-    pTrackPage->mFlags |= (KernPhysPageList_Free_Dirty << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+    pTrackPage->mFlags |= (KernPhysPageList_Core_Dirty << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL);
+    K2LIST_AddAtTail((K2LIST_ANCHOR *)&pThisCore->PhysCache_Dirty, &pTrackPage->ListLink);
+
+    if ((pThisCore->PhysCache_Clean.mNodeCount + pThisCore->PhysCache_Dirty.mNodeCount) > PHYS_CORECACHE_MAX)
+    {
+        sCoreCacheDrain(pThisCore);
+    }
+
+    K2OSKERN_SeqUnlock((K2OSKERN_SEQLOCK *)&pThisCore->PhysCacheSeqLock, FALSE);
+
+    K2OSKERN_SetIntr(disp);
+}
+
+K2STAT
+K2OSKERN_PhysAllocContig(
+    UINT32      aPageCount,
+    UINT32      aAlignPages,
+    UINT32      aPhysLimit,
+    UINT32 *    apRetPhysAddr
+)
+{
+    K2TREE_NODE *               pTreeNode;
+    K2OSKERN_PHYSTRACK_PAGE *   pTrackPage;
+    UINT32                      userVal;
+    UINT32                      props;
+    UINT32                      runFrame;
+    UINT32                      runCount;
+    UINT32                      useFrame;
+    UINT32                      limitFrame;
+    UINT32                      lead;
+    UINT32                      tail;
+    UINT32                      left;
+    BOOL                        disp;
+
+    if ((0 == aPageCount) ||
+        (aPageCount > (K2OSKERN_PHYSTRACK_PAGE_COUNT_MASK >> K2OSKERN_PHYSTRACK_PAGE_COUNT_SHL)) ||
+        (NULL == apRetPhysAddr))
+        return K2STAT_ERROR_BAD_ARGUMENT;
+
+    if (0 == aAlignPages)
+        aAlignPages = 1;
+    else if (0 != (aAlignPages & (aAlignPages - 1)))
+        return K2STAT_ERROR_BAD_ARGUMENT;
+
+    if (0 == aPhysLimit)
+        limitFrame = K2_VA32_PAGEFRAMES_FOR_4G;
+    else
+        limitFrame = aPhysLimit >> K2_VA32_MEMPAGE_BYTES_POW2;
+
+    disp = K2OSKERN_SeqLock(&gData.PhysMemSeqLock);
+
+    //
+    // free runs are keyed by page count first, so this visits the runs that are
+    // big enough smallest first.  take the first one that can hold an aligned
+    // range below the limit
+    //
+    pTreeNode = K2TREE_FindOrAfter(&gData.PhysFreeTree, aPageCount << K2OSKERN_PHYSTRACK_PAGE_COUNT_SHL);
+    while (NULL != pTreeNode)
+    {
+        runCount = pTreeNode->mUserVal >> K2OSKERN_PHYSTRACK_PAGE_COUNT_SHL;
+        runFrame = K2OS_PHYSTRACK_TO_PHYS32((UINT32)pTreeNode) >> K2_VA32_MEMPAGE_BYTES_POW2;
+        useFrame = (runFrame + (aAlignPages - 1)) & ~(aAlignPages - 1);
+        if (((useFrame - runFrame) + aPageCount <= runCount) &&
+            (useFrame + aPageCount <= limitFrame))
+            break;
+        pTreeNode = K2TREE_NextNode(&gData.PhysFreeTree, pTreeNode);
+    }
+
+    if (NULL == pTreeNode)
+    {
+        K2OSKERN_SeqUnlock(&gData.PhysMemSeqLock, disp);
+        return K2STAT_ERROR_OUT_OF_MEMORY;
+    }
 
-    K2LIST_AddAtTail(&gData.PhysPageList[KernPhysPageList_Free_Dirty], &pTrackPage->ListLink);
+    userVal = pTreeNode->mUserVal;
+    K2TREE_Remove(&gData.PhysFreeTree, pTreeNode);
+
+    props = userVal & K2OSKERN_PHYSTRACK_PROP_MASK;
+    lead = useFrame - runFrame;
+    tail = runCount - (lead + aPageCount);
+
+    //
+    // the range is exactly what was asked for. alignment slack in front of it
+    // and whatever is left behind it go back on the tree as their own runs
+    //
+    if (lead > 0)
+    {
+        pTreeNode->mUserVal = (lead << K2OSKERN_PHYSTRACK_PAGE_COUNT_SHL) | props | K2OSKERN_PHYSTRACK_UNALLOC_FLAG;
+        K2TREE_Insert(&gData.PhysFreeTree, pTreeNode->mUserVal, pTreeNode);
+    }
+    if (tail > 0)
+    {
+        (pTreeNode + lead + aPageCount)->mUserVal = (tail << K2OSKERN_PHYSTRACK_PAGE_COUNT_SHL) | props | K2OSKERN_PHYSTRACK_UNALLOC_FLAG;
+        K2TREE_Insert(&gData.PhysFreeTree, (pTreeNode + lead + aPageCount)->mUserVal, pTreeNode + lead + aPageCount);
+    }
+
+    //
+    // first page of the range carries the contig flag so a free can find where 
+    // the range starts and where the next one begins
+    //
+    pTrackPage = (K2OSKERN_PHYSTRACK_PAGE *)(pTreeNode + lead);
+    left = aPageCount;
+    do {
+        pTrackPage->mFlags = (KernPhysPageList_Contig << K2OSKERN_PHYSTRACK_PAGE_LIST_SHL) | props;
+        pTrackPage->mpOwnerObject = NULL;
+        pTrackPage->ListLink.mpPrev = pTrackPage->ListLink.mpNext = NULL;
+        pTrackPage++;
+    } while (--left);
+    ((K2OSKERN_PHYSTRACK_PAGE *)(pTreeNode + lead))->mFlags |= K2OSKERN_PHYSTRACK_CONTIG_ALLOC_FLAG;
 
     K2OSKERN_SeqUnlock(&gData.PhysMemSeqLock, disp);
+
+    *apRetPhysAddr = useFrame << K2_VA32_MEMPAGE_BYTES_POW2;
+
+    return K2STAT_NO_ERROR;
 }
 
+K2STAT
+K2OSKERN_PhysFreeContig(
+    UINT32 aPhysAddr
+)
+{
+    K2OSKERN_PHYSTRACK_PAGE *   pTrackPage;
+    K2OSKERN_PHYSTRACK_PAGE *   pWork;
+    K2TREE_NODE *               pTreeNode;
+    UINT32                      props;
+    UINT32                      frame;
+    UINT32                      count;
+    BOOL                        disp;
+
+    if (0 != (aPhysAddr & K2_VA32_MEMPAGE_OFFSET_MASK))
+        return K2STAT_ERROR_BAD_ARGUMENT;
+
+    pTrackPage = (K2OSKERN_PHYSTRACK_PAGE *)K2OS_PHYS32_TO_PHYSTRACK(aPhysAddr);
+
+    disp = K2OSKERN_SeqLock(&gData.PhysMemSeqLock);
+
+    if ((K2OSKERN_PHYSTRACK_CONTIG_ALLOC_FLAG != (pTrackPage->mFlags & (K2OSKERN_PHYSTRACK_UNALLOC_FLAG | K2OSKERN_PHYSTRACK_CONTIG_ALLOC_FLAG))) ||
+        (KernPhysPageList_Contig != K2OSKERN_PHYSTRACK_PAGE_FLAGS_GET_LIST(pTrackPage->mFlags)))
+    {
+        K2OSKERN_SeqUnlock(&gData.PhysMemSeqLock, disp);
+        return K2STAT_ERROR_BAD_ARGUMENT;
+    }
+
+    props = pTrackPage->mFlags & K2OSKERN_PHYSTRACK_PROP_MASK & ~K2OSKERN_PHYSTRACK_CONTIG_ALLOC_FLAG;
+
+    //
+    // the range ends at the first page that is not a contig page or that 
+    // starts the next contig range
+    //
+    pWork = pTrackPage;
+    frame = aPhysAddr >> K2_VA32_MEMPAGE_BYTES_POW2;
+    count = 0;
+    do {
+        pWork->mFlags = props | K2OSKERN_PHYSTRACK_UNALLOC_FLAG;
+        pWork++;
+        frame++;
+        count++;
+    } while ((frame < K2_VA32_PAGEFRAMES_FOR_4G) &&
+             (0 == (pWork->mFlags & (K2OSKERN_PHYSTRACK_UNALLOC_FLAG | K2OSKERN_PHYSTRACK_CONTIG_ALLOC_FLAG))) &&
+             (KernPhysPageList_Contig == K2OSKERN_PHYSTRACK_PAGE_FLAGS_GET_LIST(pWork->mFlags)));
+
+    //
+    // if the range is followed by the head of a free run with the same
+    // properties they go back on the tree as one run
+    //
+    if ((frame < K2_VA32_PAGEFRAMES_FOR_4G) &&
+        (0 != (pWork->mFlags & K2OSKERN_PHYSTRACK_UNALLOC_FLAG)) &&
+        (0 != (pWork->mFlags & K2OSKERN_PHYSTRACK_PAGE_COUNT_MASK)) &&
+        (props == (pWork->mFlags & K2OSKERN_PHYSTRACK_PROP_MASK)))
+    {
+        pTreeNode = (K2TREE_NODE *)pWork;
+        count += pTreeNode->mUserVal >> K2OSKERN_PHYSTRACK_PAGE_COUNT_SHL;
+        K2TREE_Remove(&gData.PhysFreeTree, pTreeNode);
+        pTreeNode->mUserVal = props | K2OSKERN_PHYSTRACK_UNALLOC_FLAG;
+    }
+
+    pTreeNode = (K2TREE_NODE *)pTrackPage;
+    pTreeNode->mUserVal = (count << K2OSKERN_PHYSTRACK_PAGE_COUNT_SHL) | props | K2OSKERN_PHYSTRACK_UNALLOC_FLAG;
+    K2TREE_Insert(&gData.PhysFreeTree, pTreeNode->mUserVal, pTreeNode);
+
+    K2OSKERN_SeqUnlock(&gData.PhysMemSeqLock, disp);
+
+    return K2STAT_NO_ERROR;
+}
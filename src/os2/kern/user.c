@@ -203,10 +203,12 @@ KernUser_Init(
     K2_ASSERT(!K2STAT_IS_ERROR(stat));
 
     K2_ASSERT(0 == (parse.mpRawFileData->e_flags & DLX_EF_KERNEL_ONLY));
+    K2_ASSERT(0 == (parse.mpRawFileData->e_flags & DLX_EF_DEFLATED_MASK));
 
     K2_ASSERT(DLX_ET_DLX == parse.mpRawFileData->e_type);
     K2_ASSERT(DLX_ELFOSABI_K2 == parse.mpRawFileData->e_ident[EI_OSABI]);
-    K2_ASSERT(DLX_ELFOSABIVER_DLX == parse.mpRawFileData->e_ident[EI_ABIVERSION]);
+    K2_ASSERT((DLX_ELFOSABIVER_DLX == parse.mpRawFileData->e_ident[EI_ABIVERSION]) ||
+              (DLX_ELFOSABIVER_DLX_V1 == parse.mpRawFileData->e_ident[EI_ABIVERSION]));
 
     K2_ASSERT(3 < parse.mpRawFileData->e_shnum);
 
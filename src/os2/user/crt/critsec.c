@@ -31,12 +31,53 @@
 //
 #include "crt.h"
 
+//
+// mLockOwner is the thread index of the owner (never zero) or zero when the
+// section is free.  Entering and leaving an uncontended section is a single
+// compare-exchange/exchange on that word and never goes to the kernel.  Only
+// threads that fail to get the section after spinning register themselves
+// in mWaitingCount and block on the notify; a leaving thread only signals
+// the notify if it sees somebody registered there.
+//
+#define CRITSEC_DEFAULT_SPIN    100
+
 typedef struct _IntCritSec IntCritSec;
 struct _IntCritSec
 {
-    UINT32      mLockOwner;
-    K2OS_TOKEN  mTokNotify;
+    UINT32 volatile mLockOwner;
+    UINT32 volatile mWaitingCount;
+    UINT32          mRecursionCount;
+    UINT32          mSpinCount;
+    K2OS_TOKEN      mTokNotify;
 };
+K2_STATIC_ASSERT(sizeof(IntCritSec) <= K2OS_CACHELINE_BYTES);
+
+static
+IntCritSec *
+sGetIntSec(
+    K2OS_CRITSEC *apSec
+)
+{
+    return (IntCritSec *)((((UINT32)apSec) + (K2OS_CACHELINE_BYTES - 1)) & (~(K2OS_CACHELINE_BYTES - 1)));
+}
+
+static
+BOOL
+sTryGetSec(
+    IntCritSec *    apSec,
+    UINT32          aThreadIx
+)
+{
+    if (0 != apSec->mLockOwner)
+        return FALSE;
+
+    if (0 != K2ATOMIC_CompareExchange(&apSec->mLockOwner, aThreadIx, 0))
+        return FALSE;
+
+    apSec->mRecursionCount = 1;
+
+    return TRUE;
+}
 
 BOOL 
 K2OS_CritSec_Init(
@@ -44,9 +85,13 @@ K2OS_CritSec_Init(
 )
 {
     IntCritSec *pSec;
-    pSec = (IntCritSec *)((((UINT32)apSec) + (K2OS_CACHELINE_BYTES - 1)) & (~(K2OS_CACHELINE_BYTES - 1)));
+
+    pSec = sGetIntSec(apSec);
 
     pSec->mLockOwner = 0;
+    pSec->mWaitingCount = 0;
+    pSec->mRecursionCount = 0;
+    pSec->mSpinCount = CRITSEC_DEFAULT_SPIN;
     pSec->mTokNotify = K2OS_Notify_Create(0);
     if (NULL == pSec->mTokNotify)
         return FALSE;
@@ -59,6 +104,23 @@ K2OS_CritSec_TryEnter(
     K2OS_CRITSEC *apSec
 )
 {
+    IntCritSec *pSec;
+    UINT32      threadIx;
+
+    pSec = sGetIntSec(apSec);
+    threadIx = CRT_GET_CURRENT_THREAD_INDEX;
+
+    if (pSec->mLockOwner == threadIx)
+    {
+        pSec->mRecursionCount++;
+        return TRUE;
+    }
+
+    if (sTryGetSec(pSec, threadIx))
+        return TRUE;
+
+    K2OS_Thread_SetLastStatus(K2STAT_ERROR_OWNED);
+
     return FALSE;
 }
 
@@ -67,7 +129,51 @@ K2OS_CritSec_Enter(
     K2OS_CRITSEC *apSec
 )
 {
-    return K2STAT_ERROR_NOT_IMPL;
+    IntCritSec *pSec;
+    UINT32      threadIx;
+    UINT32      spinLeft;
+
+    pSec = sGetIntSec(apSec);
+    threadIx = CRT_GET_CURRENT_THREAD_INDEX;
+
+    if (pSec->mLockOwner == threadIx)
+    {
+        pSec->mRecursionCount++;
+        return TRUE;
+    }
+
+    if (sTryGetSec(pSec, threadIx))
+        return TRUE;
+
+    //
+    // owner may be about to leave on another core
+    //
+    spinLeft = pSec->mSpinCount;
+    while (spinLeft--)
+    {
+        if (sTryGetSec(pSec, threadIx))
+            return TRUE;
+    }
+
+    //
+    // register as a waiter before the last try so a leaving thread
+    // that we race with is guaranteed to see us and signal the notify
+    //
+    K2ATOMIC_Inc((INT32 volatile *)&pSec->mWaitingCount);
+    do {
+        if (sTryGetSec(pSec, threadIx))
+            break;
+
+        //
+        // notify latches a signal if nobody is waiting on it yet, so
+        // a wakeup is never lost. a stale one just causes another loop
+        //
+        K2OS_Thread_WaitForNotify(pSec->mTokNotify);
+
+    } while (1);
+    K2ATOMIC_Dec((INT32 volatile *)&pSec->mWaitingCount);
+
+    return TRUE;
 }
 
 BOOL 
@@ -75,7 +181,27 @@ K2OS_CritSec_Leave(
     K2OS_CRITSEC *apSec
 )
 {
-    return K2STAT_ERROR_NOT_IMPL;
+    IntCritSec *pSec;
+
+    pSec = sGetIntSec(apSec);
+
+    if (pSec->mLockOwner != CRT_GET_CURRENT_THREAD_INDEX)
+    {
+        K2OS_Thread_SetLastStatus(K2STAT_ERROR_NOT_OWNED);
+        return FALSE;
+    }
+
+    if (0 != --pSec->mRecursionCount)
+        return TRUE;
+
+    K2ATOMIC_Exchange(&pSec->mLockOwner, 0);
+
+    if (0 != pSec->mWaitingCount)
+    {
+        K2OS_Notify_Signal(pSec->mTokNotify, 1);
+    }
+
+    return TRUE;
 }
 
 BOOL 
@@ -86,7 +212,9 @@ K2OS_CritSec_Done(
     K2STAT      stat;
     IntCritSec *pSec;
 
-    pSec = (IntCritSec *)((((UINT32)apSec) + (K2OS_CACHELINE_BYTES - 1)) & (~(K2OS_CACHELINE_BYTES - 1)));
+    pSec = sGetIntSec(apSec);
+
+    K2_ASSERT(0 == pSec->mWaitingCount);
 
     stat = K2OS_Token_Destroy(pSec->mTokNotify);
     if (!K2STAT_IS_ERROR(stat))
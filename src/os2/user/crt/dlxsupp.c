@@ -199,6 +199,7 @@ CrtDlx_Init(
     sgDlxHost.RefChange = CrtDlx_RefChange;
     sgDlxHost.Purge = CrtDlx_Purge;
     sgDlxHost.ErrorPoint = CrtDlx_ErrorPoint;
+    sgDlxHost.LazyThunk = K2DLXSUPP_LazyThunk;
 
     stat = K2DLXSUPP_Init(sgpLoaderPage, &sgDlxHost, TRUE, FALSE, &preloadSelf);
     K2_ASSERT(!K2STAT_IS_ERROR(stat));
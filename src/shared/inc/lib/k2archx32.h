@@ -49,6 +49,7 @@ UINT32 K2_CALLCONV_REGS X32_ReadEBP(void);
 UINT32 K2_CALLCONV_REGS X32_ReadCR0(void);
 UINT32 K2_CALLCONV_REGS X32_ReadCR2(void);
 UINT32 K2_CALLCONV_REGS X32_ReadCR3(void);
+UINT32 K2_CALLCONV_REGS X32_ReadCR4(void);
 UINT32 K2_CALLCONV_REGS X32_ReadEFLAGS(void);
 
 void   K2_CALLCONV_REGS X32_LoadTR(UINT32 aSelector);
@@ -60,6 +61,7 @@ void   K2_CALLCONV_REGS X32_SetFS(UINT32 aSelector);
 UINT32 K2_CALLCONV_REGS X32_GetFSData(UINT32 aOffset);
 
 void   K2_CALLCONV_REGS X32_LoadCR3(UINT32 aPageDirPhysAddr);
+void   K2_CALLCONV_REGS X32_WriteCR4(UINT32 aValue);
 
 void   K2_CALLCONV_REGS X32_CallCPUID(X32_CPUID *apIo);
 
@@ -45,6 +45,7 @@ extern "C" {
 #define K2DLXSUPP_FLAG_PERMANENT        2
 #define K2DLXSUPP_FLAG_ENTRY_CALLED     4
 #define K2DLXSUPP_FLAG_KEEP_SYMBOLS     8
+#define K2DLXSUPP_FLAG_LINKED           16
 
 typedef struct _K2DLXSUPP_SEG K2DLXSUPP_SEG;
 struct _K2DLXSUPP_SEG
@@ -70,6 +71,22 @@ struct _K2DLXSUPP_OPENRESULT
     UINT32              mModulePageLinkAddr;
 };
 
+//
+// asynchronous sector read.  the loader fills in mpBuffer and mSectorCount and the
+// host fills in the rest.  the read is at the current file position which advances
+// when the read is started.  at completion the data is either in mpBuffer or, if the
+// host set mpHostData, at mpHostData which must stay valid until the load finishes.
+// in that case the loader copies the data out while it calculates the crc
+//
+typedef struct _K2DLXSUPP_READ K2DLXSUPP_READ;
+struct _K2DLXSUPP_READ
+{
+    void *              mpBuffer;
+    UINT32              mSectorCount;
+    void const *        mpHostData;
+    UINT32              mHostContext;
+};
+
 typedef K2STAT (*pfK2DLXSUPP_CritSec)(BOOL aEnter);
 
 typedef void   (*pfK2DLXSUPP_AtReInit)(DLX *apDlx, UINT32 aModulePageLinkAddr, K2DLXSUPP_HOST_FILE *apInOutHostFile);
@@ -84,6 +101,14 @@ typedef K2STAT (*pfK2DLXSUPP_Finalize)(void *apAcqContext, K2DLXSUPP_HOST_FILE a
 typedef K2STAT (*pfK2DLXSUPP_RefChange)(K2DLXSUPP_HOST_FILE aHostFile, DLX *apDlx, INT32 aRefChange);
 typedef K2STAT (*pfK2DLXSUPP_Purge)(K2DLXSUPP_HOST_FILE aHostFile);
 typedef K2STAT (*pfK2DLXSUPP_ErrorPoint)(char const *apFile, int aLine, K2STAT aStatus);
+typedef void * (*pfK2DLXSUPP_AllocScratch)(void *apAcqContext, UINT32 aBytes);
+typedef void   (*pfK2DLXSUPP_FreeScratch)(void *apAcqContext, void *apMem);
+typedef K2STAT (*pfK2DLXSUPP_ReadSectorsAsync)(void *apAcqContext, K2DLXSUPP_HOST_FILE aHostFile, K2DLXSUPP_READ *apRead);
+typedef K2STAT (*pfK2DLXSUPP_ReadComplete)(void *apAcqContext, K2DLXSUPP_HOST_FILE aHostFile, K2DLXSUPP_READ *apRead);
+typedef void   (*pfK2DLXSUPP_ParallelWork)(void *apAcqContext, void *apArg, UINT32 aIndex);
+typedef void   (*pfK2DLXSUPP_RunParallel)(void *apAcqContext, pfK2DLXSUPP_ParallelWork afWork, void *apArg, UINT32 aCount);
+typedef void   (*pfK2DLXSUPP_LazyThunk)(void);
+typedef UINT64 (*pfK2DLXSUPP_GetTime)(void);
 
 typedef struct _K2DLXSUPP_HOST K2DLXSUPP_HOST;
 struct _K2DLXSUPP_HOST
@@ -102,6 +127,31 @@ struct _K2DLXSUPP_HOST
     pfK2DLXSUPP_RefChange         RefChange;
     pfK2DLXSUPP_Purge             Purge;
     pfK2DLXSUPP_ErrorPoint        ErrorPoint;
+
+    // optional - only needed to load dlx with deflated segments
+    pfK2DLXSUPP_AllocScratch      AllocScratch;
+    pfK2DLXSUPP_FreeScratch       FreeScratch;
+
+    // optional - if present segment reads are overlapped with crc of the previous segment
+    pfK2DLXSUPP_ReadSectorsAsync  ReadSectorsAsync;
+    pfK2DLXSUPP_ReadComplete      ReadComplete;
+
+    // optional - run afWork for every index below aCount on as many threads as the host
+    // likes and return when they are all done.  if present modules that do not depend
+    // on each other are read, linked and finalized at the same time, so ReadSectors,
+    // the async reads, Finalize, the scratch functions and ErrorPoint must all be safe
+    // to call for different files at once.  callbacks are still made one at a time
+    pfK2DLXSUPP_RunParallel       RunParallel;
+
+    // optional - if present the slots of dlx with lazy bound code imports start out
+    // pointing here, and the first call through a slot binds it.  normally this is
+    // K2DLXSUPP_LazyThunk.  if not present those slots are bound at load like any
+    // other import
+    pfK2DLXSUPP_LazyThunk         LazyThunk;
+
+    // optional - if present the time spent in each phase of a load is measured
+    // with this clock and reported by DLX_GetLoadStats.  counts are kept either way
+    pfK2DLXSUPP_GetTime           GetTime;
 };
 
 typedef BOOL (*pfK2DLXSUPP_ConvertLoadPtr)(UINT32 * apAddr);
@@ -153,6 +203,23 @@ K2DLXSUPP_GetInfo(
     char const **       appRetFileName
     );
 
+//
+// first call through an unbound lazy import slot arrives at the thunk with the
+// slot address in eax (x32) or ip (a32).  the thunk saves argument registers,
+// calls K2DLXSUPP_LazyBind to bind the slot, and jumps to the bound address.
+// never call either of these directly
+//
+void
+K2DLXSUPP_LazyThunk(
+    void
+    );
+
+UINT32
+K2_CALLCONV_REGS
+K2DLXSUPP_LazyBind(
+    UINT32  aSlotAddr
+    );
+
 #ifdef __cplusplus
 };  // extern "C"
 #endif
@@ -52,7 +52,8 @@ typedef struct _DLX DLX;
 // Elf Extension definitions
 //
 #define DLX_ELFOSABI_K2                 0xDA
-#define DLX_ELFOSABIVER_DLX             0xAD
+#define DLX_ELFOSABIVER_DLX_V1          0xAD    // exports are binary search only
+#define DLX_ELFOSABIVER_DLX             0xAE    // exports may carry a hash index
 
 #define DLX_ET_DLX                      ET_OSSPEC_LO
 
@@ -66,9 +67,57 @@ typedef struct _DLX DLX;
 
 #define DLX_SHT_DLX_EXPORTS             SHT_LOOS
 #define DLX_SHT_DLX_IMPORTS             (SHT_LOOS + 1)
+#define DLX_SHT_DLX_RELOC               (SHT_LOOS + 2)
+#define DLX_SHT_DLX_SYMIDX              (SHT_LOOS + 3)
+#define DLX_SHT_DLX_LAZYSTUB            (SHT_LOOS + 4)
+
+//
+// symbol address index (DLX_SHT_DLX_SYMIDX section in the sym segment)
+//
+// sh_link is the symbol table and sh_info is the segment (DlxSeg_Text..DlxSeg_Data).
+// the section is the UINT32 indexes into the symbol table of the symbols in that
+// segment sorted by address, so address to name lookup is a binary search.
+//
+
+//
+// lazy bound code imports (DLX_SHT_DLX_LAZYSTUB section in the text segment)
+//
+// sh_link is a code import section and sh_info is a slot section in the data segment
+// holding one UINT32 per stub.  calls to imports go to a DLX_LAZY_STUB_BYTES stub that
+// jumps through its slot.  the word at DLX_LAZY_STUB_IXOFFSET in each stub is the index
+// of the import ref it calls, and the loader writes the rest of the stub.  an import
+// section with stubs is kept in the read segment and has a name for each ref that is
+// called so it can be bound after the load.  until a slot is bound it holds the host
+// lazy thunk, which binds it and then goes where it now points.
+//
+#define DLX_LAZY_STUB_BYTES             16
+#define DLX_LAZY_STUB_IXOFFSET          12
 
 #define DLX_EF_KERNEL_ONLY              0x00010000
 
+//
+// prelinked dlx - segment link addresses in the DLX_INFO are the preferred load
+// addresses and relocations have been applied for them.  each import section header
+// sh_info holds the digest of the export addresses the imports were bound to, or
+// zero if the imported dlx was not itself prelinked.  the digest is the chained
+// K2CRC_Calc32 of each DLX_EXPORT_REF.mAddr in order.
+//
+#define DLX_EF_PRELINKED                0x00020000
+
+//
+// deflated segments - the file data for the segment is a raw deflate stream (no zlib
+// header) made with a window of DLX_DEFLATE_WINDOW_BITS.  mFileBytes is the sector
+// rounded size of the compressed stream and mCRC32 is of the inflated data.  section
+// sh_offset values inside a deflated segment are not valid file offsets.
+//
+#define DLX_EF_DEFLATED_TEXT            0x00040000
+#define DLX_EF_DEFLATED_READ            0x00080000
+#define DLX_EF_DEFLATED_DATA            0x00100000
+#define DLX_EF_DEFLATED(seg)            (DLX_EF_DEFLATED_TEXT << ((seg) - DlxSeg_Text))
+#define DLX_EF_DEFLATED_MASK            (DLX_EF_DEFLATED_TEXT | DLX_EF_DEFLATED_READ | DLX_EF_DEFLATED_DATA)
+
+#define DLX_DEFLATE_WINDOW_BITS         12
+
 //
 // File structure
 //
@@ -111,6 +160,41 @@ struct _DLX_EXPORT_REF
 K2_PACKED_POP
 typedef struct _DLX_EXPORT_REF DLX_EXPORT_REF;
 
+//
+// compact relocations (DLX_SHT_DLX_RELOC section, sh_link and sh_info as for SHT_REL)
+//
+// DLX_RELOC_HDR, then mGroupCount groups each followed by its mWordCount words,
+// then mRelCount Elf32_Rel for anything that could not be put into a group.
+// a group holds relocations against symbols in this dlx that only need the
+// move of a segment added to the value at the target.  group words are
+// processed in order with a running offset into the target section:
+//   bit 0 clear - word >> 1 is the offset of a relocation.
+//                 running offset becomes that + 4
+//   bit 0 set   - bits 1..31 are relocations at running offset + (4 * (bit - 1)).
+//                 running offset advances by 31 * 4
+//
+#define DLX_RELOC_KIND_ABS32            0   // add move of mSymSegment
+#define DLX_RELOC_KIND_PC32             1   // add move of mSymSegment less move of target segment
+
+K2_PACKED_PUSH
+struct _DLX_RELOC_HDR
+{
+    UINT32  mGroupCount;
+    UINT32  mRelCount;
+} K2_PACKED_ATTRIB;
+K2_PACKED_POP
+typedef struct _DLX_RELOC_HDR DLX_RELOC_HDR;
+
+K2_PACKED_PUSH
+struct _DLX_RELOC_GROUP
+{
+    UINT16  mKind;
+    UINT16  mSymSegment;
+    UINT32  mWordCount;
+} K2_PACKED_ATTRIB;
+K2_PACKED_POP
+typedef struct _DLX_RELOC_GROUP DLX_RELOC_GROUP;
+
 K2_PACKED_PUSH
 struct _DLX_SEGMENT_INFO
 {
@@ -134,6 +218,55 @@ struct _DLX_EXPORTS_SECTION
 K2_PACKED_POP
 typedef struct _DLX_EXPORTS_SECTION DLX_EXPORTS_SECTION;
 
+//
+// export hash index
+//
+// if present this immediately follows Export[mCount] in an exports section, and
+// is followed by UINT32 Bloom[mBloomWords], UINT32 Bucket[mBucketCount], then
+// DLX_EXPORT_HASHENT Chain[mCount].  names stay sorted after the index and mCRC32
+// is still over the names only, so imports match whether or not it is there.
+// it is present if Export[0].mNameOffset leaves room for it before the names.
+//
+// a name with hash h is in the bloom filter if both bit (h % 32) and bit
+// ((h >> mBloomShift) % 32) of Bloom[(h / 32) & (mBloomWords - 1)] are set.
+// Bucket[h % mBucketCount] is the index of the first chain entry for that
+// bucket or DLX_EXPORT_HASH_EMPTY.  chain entries for a bucket are contiguous
+// and the last one has bit 0 of its mHash set.
+//
+#define DLX_EXPORT_HASH_EMPTY           ((UINT32)-1)
+
+K2_PACKED_PUSH
+struct _DLX_EXPORTS_HASH
+{
+    UINT32  mBucketCount;
+    UINT32  mBloomWords;        // power of 2
+    UINT32  mBloomShift;
+} K2_PACKED_ATTRIB;
+K2_PACKED_POP
+typedef struct _DLX_EXPORTS_HASH DLX_EXPORTS_HASH;
+
+K2_PACKED_PUSH
+struct _DLX_EXPORT_HASHENT
+{
+    UINT32  mHash;              // bit 0 set on last entry in bucket
+    UINT32  mExportIx;          // index into Export[]
+} K2_PACKED_ATTRIB;
+K2_PACKED_POP
+typedef struct _DLX_EXPORT_HASHENT DLX_EXPORT_HASHENT;
+
+static K2_INLINE UINT32
+DLX_ExportNameHash(char const *apName)
+{
+    UINT32 h;
+    h = 5381;
+    while (*apName != 0)
+    {
+        h = (h << 5) + h + (UINT8)(*apName);
+        apName++;
+    }
+    return h;
+}
+
 K2_PACKED_PUSH
 struct _DLX_INFO
 {
@@ -171,6 +304,47 @@ dlx_entry(
     UINT32  aReason
 );
 
+//
+// load statistics (DLX_GetLoadStats).  times are in units of the host
+// clock and stay zero if the host does not have one.  relocation counts
+// are of relocations actually applied
+//
+enum _DLXLoadPhase
+{
+    DlxLoadPhase_Open = 0,      // host open of the file
+    DlxLoadPhase_HdrRead,       // headers and dlx info
+    DlxLoadPhase_SegRead,       // segment data (includes inflate)
+    DlxLoadPhase_Crc,           // headers, dlx info and segments
+    DlxLoadPhase_Reloc,         // relocations, symbols and section addresses
+    DlxLoadPhase_Import,        // locating exporters and setting up lazy slots
+    DlxLoadPhase_Callback,      // entrypoint with DLX_ENTRY_REASON_LOAD
+    DlxLoadPhase_Count
+};
+typedef enum _DLXLoadPhase DlxLoadPhase;
+
+enum _DLXRelocStat
+{
+    DlxRelocStat_GroupAbs32 = 0,    // DLX_RELOC_KIND_ABS32 group entries
+    DlxRelocStat_GroupPc32,         // DLX_RELOC_KIND_PC32 group entries
+    DlxRelocStat_Abs32,             // R_386_32, R_ARM_ABS32
+    DlxRelocStat_Pc32,              // R_386_PC32
+    DlxRelocStat_Branch,            // R_ARM_PC24, R_ARM_CALL, R_ARM_JUMP24
+    DlxRelocStat_MovW,              // R_ARM_MOVW_ABS_NC
+    DlxRelocStat_MovT,              // R_ARM_MOVT_ABS
+    DlxRelocStat_Prel31,            // R_ARM_PREL31
+    DlxRelocStat_Count
+};
+typedef enum _DLXRelocStat DlxRelocStat;
+
+struct _DLX_LOAD_STATS
+{
+    UINT64  mPhaseTime[DlxLoadPhase_Count];
+    UINT32  mRelocCount[DlxRelocStat_Count];
+    UINT32  mFastImportCount;       // bound straight from the export ref
+    UINT32  mSlowImportCount;       // bound by name lookup
+};
+typedef struct _DLX_LOAD_STATS DLX_LOAD_STATS;
+
 //
 // API
 //
@@ -231,6 +405,12 @@ DLX_AddrToName(
     UINT32  aBufferLen
 );
 
+K2STAT
+DLX_GetLoadStats(
+    DLX *               apDlx,
+    DLX_LOAD_STATS *    apRetStats
+);
+
 #define K2STAT_MAKE_DLX_ERROR(x)                    K2STAT_MAKE_ERROR(K2STAT_FACILITY_DLX, (x))
 
 #define K2STAT_DLX_ERROR_FILE_CORRUPTED             K2STAT_MAKE_DLX_ERROR(1)
@@ -60,6 +60,7 @@ sPrepModule(
     K2STAT          status;
     DLX *           pSubModule;
     UINT32          impIx;
+    UINT64          startTime;
 
     pInfo = apDlx->mpInfo;
     pWork = (UINT8 *)pInfo;
@@ -78,10 +79,12 @@ sPrepModule(
     }
 
     // check the dlx info segment crc
+    startTime = iK2DLXSUPP_StatTime();
     crc = pInfo->SegInfo[DlxSeg_Info].mCRC32;
     pInfo->SegInfo[DlxSeg_Info].mCRC32 = 0;
     if (K2CRC_Calc32(0, pInfo, left) != crc)
         return K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_CRC_WRONG);
+    iK2DLXSUPP_StatPhase(apDlx, DlxLoadPhase_Crc, startTime);
     // dlx info segment is good
     pInfo->SegInfo[DlxSeg_Info].mCRC32 = crc;
 
@@ -99,18 +102,18 @@ sPrepModule(
 
     // update exports DATA addresses now (not loaded yet but who cares)
     // the ones in the DLX info will be updated to their LINK addresses by the relocation code
-    if (apDlx->mpExpCodeDataAddr != ((DLX_EXPORTS_SECTION *)-1))
-        apDlx->mpExpCodeDataAddr = (DLX_EXPORTS_SECTION *)(((UINT8 *)apDlx->mpExpCodeDataAddr) + apDlx->SegAlloc.Segment[DlxSeg_Read].mDataAddr);
+    if (apDlx->mpExpSecDataAddr[K2DLX_EXPIX_CODE] != ((DLX_EXPORTS_SECTION *)-1))
+        apDlx->mpExpSecDataAddr[K2DLX_EXPIX_CODE] = (DLX_EXPORTS_SECTION *)(((UINT8 *)apDlx->mpExpSecDataAddr[K2DLX_EXPIX_CODE]) + apDlx->SegAlloc.Segment[DlxSeg_Read].mDataAddr);
     else
-        apDlx->mpExpCodeDataAddr = NULL;
-    if (apDlx->mpExpReadDataAddr != ((DLX_EXPORTS_SECTION *)-1))
-        apDlx->mpExpReadDataAddr = (DLX_EXPORTS_SECTION *)(((UINT8 *)apDlx->mpExpReadDataAddr) + apDlx->SegAlloc.Segment[DlxSeg_Read].mDataAddr);
+        apDlx->mpExpSecDataAddr[K2DLX_EXPIX_CODE] = NULL;
+    if (apDlx->mpExpSecDataAddr[K2DLX_EXPIX_READ] != ((DLX_EXPORTS_SECTION *)-1))
+        apDlx->mpExpSecDataAddr[K2DLX_EXPIX_READ] = (DLX_EXPORTS_SECTION *)(((UINT8 *)apDlx->mpExpSecDataAddr[K2DLX_EXPIX_READ]) + apDlx->SegAlloc.Segment[DlxSeg_Read].mDataAddr);
     else
-        apDlx->mpExpReadDataAddr = NULL;
-    if (apDlx->mpExpDataDataAddr != ((DLX_EXPORTS_SECTION *)-1))
-        apDlx->mpExpDataDataAddr = (DLX_EXPORTS_SECTION *)(((UINT8 *)apDlx->mpExpDataDataAddr) + apDlx->SegAlloc.Segment[DlxSeg_Read].mDataAddr);
+        apDlx->mpExpSecDataAddr[K2DLX_EXPIX_READ] = NULL;
+    if (apDlx->mpExpSecDataAddr[K2DLX_EXPIX_DATA] != ((DLX_EXPORTS_SECTION *)-1))
+        apDlx->mpExpSecDataAddr[K2DLX_EXPIX_DATA] = (DLX_EXPORTS_SECTION *)(((UINT8 *)apDlx->mpExpSecDataAddr[K2DLX_EXPIX_DATA]) + apDlx->SegAlloc.Segment[DlxSeg_Read].mDataAddr);
     else
-        apDlx->mpExpDataDataAddr = NULL;
+        apDlx->mpExpSecDataAddr[K2DLX_EXPIX_DATA] = NULL;
 
     // move on to imports
     pWork += sizeof(DLX_INFO) - sizeof(UINT32);
@@ -180,9 +183,11 @@ sPrep(
     UINT32                  readSegEnd;
     UINT32                  chkAddr;
     K2DLXSUPP_OPENRESULT    openResult;
+    UINT64                  startTime;
 
     if (gpK2DLXSUPP_Vars->Host.Open == NULL)
         return K2DLXSUPP_ERRORPOINT(K2STAT_ERROR_NOT_IMPL);
+    startTime = iK2DLXSUPP_StatTime();
     status = gpK2DLXSUPP_Vars->Host.Open(apAcqContext, apSpec, apName, aNameLen, &openResult);
     if (K2STAT_IS_ERROR(status))
         return K2DLXSUPP_ERRORPOINT(status);
@@ -194,8 +199,11 @@ sPrep(
     pDlx->mFlags = gpK2DLXSUPP_Vars->mKeepSym ? K2DLXSUPP_FLAG_KEEP_SYMBOLS : 0;
     pDlx->mLinkAddr = openResult.mModulePageLinkAddr;
 
-    for (secIx = 0;secIx < 3;secIx++)
-        K2TREE_Init(&pDlx->SymTree[secIx], iK2DLXSUPP_CompareUINT32);
+    // module page is not zeroed by the host. indexes are filled in at link if symbols are kept
+    K2MEM_Zero(pDlx->SymIndex, sizeof(pDlx->SymIndex));
+
+    iK2DLXSUPP_StatAlloc(pDlx);
+    iK2DLXSUPP_StatPhase(pDlx, DlxLoadPhase_Open, startTime);
 
     do
     {
@@ -211,12 +219,14 @@ sPrep(
             status = K2DLXSUPP_ERRORPOINT(K2STAT_ERROR_NOT_IMPL);
             break;
         }
+        startTime = iK2DLXSUPP_StatTime();
         status = gpK2DLXSUPP_Vars->Host.ReadSectors(apAcqContext, pDlx->mHostFile, pPage->mHdrSectorsBuffer, 1);
         if (K2STAT_IS_ERROR(status))
         {
             status = K2DLXSUPP_ERRORPOINT(status);
             break;
         }
+        iK2DLXSUPP_StatPhase(pDlx, DlxLoadPhase_HdrRead, startTime);
         fileOffset = DLX_SECTOR_BYTES;
 
         pHdr = pDlx->mpElf = (Elf32_Ehdr *)pPage->mHdrSectorsBuffer;
@@ -235,7 +245,8 @@ sPrep(
             (pHdr->e_shoff != sizeof(Elf32_Ehdr)) ||
             (pHdr->e_type != DLX_ET_DLX) ||
             (pHdr->e_ident[EI_OSABI] != DLX_ELFOSABI_K2) ||
-            (pHdr->e_ident[EI_ABIVERSION] != DLX_ELFOSABIVER_DLX) ||
+            ((pHdr->e_ident[EI_ABIVERSION] != DLX_ELFOSABIVER_DLX) &&
+             (pHdr->e_ident[EI_ABIVERSION] != DLX_ELFOSABIVER_DLX_V1)) ||
             (pHdr->e_shstrndx != 2))
         {
             status = K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_FILE_CORRUPTED);
@@ -294,6 +305,7 @@ sPrep(
                 status = K2DLXSUPP_ERRORPOINT(K2STAT_ERROR_NOT_IMPL);
                 break;
             }
+            startTime = iK2DLXSUPP_StatTime();
             status = gpK2DLXSUPP_Vars->Host.ReadSectors(
                 apAcqContext,
                 pDlx->mHostFile,
@@ -304,17 +316,20 @@ sPrep(
                 status = K2DLXSUPP_ERRORPOINT(status);
                 break;
             }
+            iK2DLXSUPP_StatPhase(pDlx, DlxLoadPhase_HdrRead, startTime);
             fileOffset = dlxInfoEnd;
         }
         K2_ASSERT((fileOffset & DLX_SECTOROFFSET_MASK) == 0);
         pDlx->mCurSector = fileOffset / DLX_SECTOR_BYTES;
         pInfo = pDlx->mpInfo = (DLX_INFO *)(((UINT8 *)pHdr) + pDlx->mpSecHdr[1].sh_offset);
 
+        startTime = iK2DLXSUPP_StatTime();
         if (pInfo->mElfCRC != K2CRC_Calc32(0, pHdr, pDlx->mpSecHdr[1].sh_offset))
         {
             status = K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_CRC_WRONG);
             break;
         }
+        iK2DLXSUPP_StatPhase(pDlx, DlxLoadPhase_Crc, startTime);
 
         // data addresses
         pPage->ModuleSector.mSecAddr[1] = (UINT32)pInfo;
@@ -340,13 +355,14 @@ sPrep(
             else if (pDlx->mpSecHdr[secIx].sh_type == SHT_SYMTAB)
             {
                 chkAddr = pDlx->mpSecHdr[secIx].sh_entsize;
-                if ((chkAddr < sizeof(K2DLX_SYMTREE_NODE)) || (chkAddr & 3))
+                if ((chkAddr < sizeof(Elf32_Sym)) || (chkAddr & 3))
                 {
                     status = K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_FILE_CORRUPTED);
                     break;
                 }
             }
-            else if (pDlx->mpSecHdr[secIx].sh_type == SHT_REL)
+            else if ((pDlx->mpSecHdr[secIx].sh_type == SHT_REL) ||
+                 (pDlx->mpSecHdr[secIx].sh_type == DLX_SHT_DLX_RELOC))
                 pDlx->mRelocSectionCount++;
         }
         if (secIx < pHdr->e_shnum)
@@ -373,12 +389,12 @@ sPrep(
             }
             if ((chkAddr < readSegStart) || (chkAddr >= readSegEnd))
                 return K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_FILE_CORRUPTED);
-            pDlx->mpExpCodeDataAddr = (DLX_EXPORTS_SECTION *)(chkAddr - readSegStart);
+            pDlx->mpExpSecDataAddr[K2DLX_EXPIX_CODE] = (DLX_EXPORTS_SECTION *)(chkAddr - readSegStart);
             hasExports = TRUE;
             secIx--;
         }
         else
-            pDlx->mpExpCodeDataAddr = (DLX_EXPORTS_SECTION *)-1;
+            pDlx->mpExpSecDataAddr[K2DLX_EXPIX_CODE] = (DLX_EXPORTS_SECTION *)-1;
         chkAddr = (UINT32)pInfo->mpExpRead;
         if (chkAddr != 0)
         {
@@ -390,12 +406,12 @@ sPrep(
             }
             if ((chkAddr < readSegStart) || (chkAddr >= readSegEnd))
                 return K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_FILE_CORRUPTED);
-            pDlx->mpExpReadDataAddr = (DLX_EXPORTS_SECTION *)(chkAddr - readSegStart);
+            pDlx->mpExpSecDataAddr[K2DLX_EXPIX_READ] = (DLX_EXPORTS_SECTION *)(chkAddr - readSegStart);
             hasExports = TRUE;
             secIx--;
         }
         else
-            pDlx->mpExpReadDataAddr = (DLX_EXPORTS_SECTION *)-1;
+            pDlx->mpExpSecDataAddr[K2DLX_EXPIX_READ] = (DLX_EXPORTS_SECTION *)-1;
         chkAddr = (UINT32)pInfo->mpExpData;
         if (chkAddr != 0)
         {
@@ -407,12 +423,12 @@ sPrep(
             }
             if ((chkAddr < readSegStart) || (chkAddr >= readSegEnd))
                 return K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_FILE_CORRUPTED);
-            pDlx->mpExpDataDataAddr = (DLX_EXPORTS_SECTION *)(chkAddr - readSegStart);
+            pDlx->mpExpSecDataAddr[K2DLX_EXPIX_DATA] = (DLX_EXPORTS_SECTION *)(chkAddr - readSegStart);
             hasExports = TRUE;
             secIx--;
         }
         else
-            pDlx->mpExpDataDataAddr = (DLX_EXPORTS_SECTION *)-1;
+            pDlx->mpExpSecDataAddr[K2DLX_EXPIX_DATA] = (DLX_EXPORTS_SECTION *)-1;
 
         if (hasExports)
         {
@@ -434,6 +450,7 @@ sPrep(
 
     if (K2STAT_IS_ERROR(status))
     {
+        iK2DLXSUPP_StatFree(pDlx);
         if (gpK2DLXSUPP_Vars->Host.Purge != NULL)
             gpK2DLXSUPP_Vars->Host.Purge(openResult.mHostFile);
         return status;
@@ -477,6 +494,36 @@ sFindModuleOnList(
     return pDlx;
 }
 
+static
+K2STAT
+sLinkModule(
+    void *  apAcqContext,
+    DLX *   apDlx
+    )
+{
+    K2STAT status;
+
+    status = iK2DLXSUPP_LoadSegments(apAcqContext, apDlx);
+    if (K2STAT_IS_ERROR(status))
+        return status;
+
+    status = iK2DLXSUPP_Link(apDlx);
+    if (K2STAT_IS_ERROR(status))
+        return status;
+
+    if (gpK2DLXSUPP_Vars->Host.Finalize == NULL)
+        return K2DLXSUPP_ERRORPOINT(K2STAT_ERROR_NOT_IMPL);
+    status = gpK2DLXSUPP_Vars->Host.Finalize(apAcqContext, apDlx->mHostFile, &apDlx->SegAlloc);
+    if (K2STAT_IS_ERROR(status))
+        return K2DLXSUPP_ERRORPOINT(status);
+
+    iK2DLXSUPP_Cleanup(apDlx);
+
+    apDlx->mFlags |= K2DLXSUPP_FLAG_LINKED;
+
+    return K2STAT_NO_ERROR;
+}
+
 static
 K2STAT
 sLoadModule(
@@ -490,6 +537,7 @@ sLoadModule(
     DLX_IMPORT *    pImport;
     DLX *           pSubModule;
     K2STAT          status;
+    UINT64          startTime;
 
     K2_ASSERT(!(apDlx->mFlags & K2DLXSUPP_FLAG_FULLY_LOADED));
 
@@ -513,23 +561,17 @@ sLoadModule(
         }
     }
 
-    status = iK2DLXSUPP_LoadSegments(apAcqContext, apDlx);
-    if (K2STAT_IS_ERROR(status))
-        return status;
-
-    status = iK2DLXSUPP_Link(apDlx);
-    if (K2STAT_IS_ERROR(status))
-        return status;
-
-    if (gpK2DLXSUPP_Vars->Host.Finalize == NULL)
-        return K2DLXSUPP_ERRORPOINT(K2STAT_ERROR_NOT_IMPL);
-    status = gpK2DLXSUPP_Vars->Host.Finalize(apAcqContext, apDlx->mHostFile, &apDlx->SegAlloc);
-    if (K2STAT_IS_ERROR(status))
-        return K2DLXSUPP_ERRORPOINT(status);
-
-    iK2DLXSUPP_Cleanup(apDlx);
+    // may already have been done by a parallel load
+    if (!(apDlx->mFlags & K2DLXSUPP_FLAG_LINKED))
+    {
+        status = sLinkModule(apAcqContext, apDlx);
+        if (K2STAT_IS_ERROR(status))
+            return status;
+    }
 
+    startTime = iK2DLXSUPP_StatTime();
     status = iK2DLXSUPP_DoCallback(apAcqContext, apDlx, TRUE);
+    iK2DLXSUPP_StatPhase(apDlx, DlxLoadPhase_Callback, startTime);
     if (!K2STAT_IS_ERROR(status))
     {
         K2LIST_Remove(&gpK2DLXSUPP_Vars->AcqList, &apDlx->ListLink);
@@ -540,6 +582,171 @@ sLoadModule(
     return status;
 }
 
+#define K2DLX_LOADLEVEL_NONE    ((UINT32)-1)
+#define K2DLX_LOADLEVEL_BUSY    ((UINT32)-2)
+
+static
+K2STAT
+sCalcLoadLevel(
+    DLX *   apDlx
+    )
+{
+    DLX_INFO *      pInfo;
+    UINT8 *         pWork;
+    UINT32          impIx;
+    DLX_IMPORT *    pImport;
+    DLX *           pSubModule;
+    K2STAT          status;
+    UINT32          level;
+
+    //
+    // level is one more than the deepest import that is not loaded yet, so
+    // everything at the same level can be linked at the same time
+    //
+    if (apDlx->mLoadLevel == K2DLX_LOADLEVEL_BUSY)
+        return K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_FILE_CORRUPTED);
+    if (apDlx->mLoadLevel != K2DLX_LOADLEVEL_NONE)
+        return K2STAT_NO_ERROR;
+
+    apDlx->mLoadLevel = K2DLX_LOADLEVEL_BUSY;
+
+    level = 0;
+    pInfo = apDlx->mpInfo;
+    pWork = (UINT8 *)pInfo;
+    pWork += sizeof(DLX_INFO) - 4 + apDlx->mIntNameFieldLen;
+    for (impIx = 0; impIx < pInfo->mImportCount; impIx++)
+    {
+        pImport = (DLX_IMPORT *)pWork;
+        pSubModule = (DLX *)pImport->mReserved;
+        if (!(pSubModule->mFlags & K2DLXSUPP_FLAG_FULLY_LOADED))
+        {
+            status = sCalcLoadLevel(pSubModule);
+            if (K2STAT_IS_ERROR(status))
+                return status;
+            if (pSubModule->mLoadLevel >= level)
+                level = pSubModule->mLoadLevel + 1;
+        }
+        pWork += pImport->mSizeBytes;
+    }
+
+    apDlx->mLoadLevel = level;
+
+    return K2STAT_NO_ERROR;
+}
+
+static
+DLX *
+sFindAtLoadLevel(
+    UINT32  aLevel,
+    UINT32  aIndex
+    )
+{
+    K2LIST_LINK *   pLink;
+    DLX *           pDlx;
+
+    pLink = gpK2DLXSUPP_Vars->AcqList.mpHead;
+    while (pLink != NULL)
+    {
+        pDlx = K2_GET_CONTAINER(DLX, pLink, ListLink);
+        if (pDlx->mLoadLevel == aLevel)
+        {
+            if (aIndex == 0)
+                return pDlx;
+            aIndex--;
+        }
+        pLink = pLink->mpNext;
+    }
+
+    return NULL;
+}
+
+static
+void
+sParallelLinkOne(
+    void *  apAcqContext,
+    void *  apArg,
+    UINT32  aIndex
+    )
+{
+    DLX * pDlx;
+
+    // acquire list is not changed while work is running so this is safe to walk
+    pDlx = sFindAtLoadLevel(*((UINT32 *)apArg), aIndex);
+    K2_ASSERT(pDlx != NULL);
+
+    pDlx->mLoadStatus = sLinkModule(apAcqContext, pDlx);
+}
+
+static
+K2STAT
+sExecParallelLinks(
+    void *apAcqContext
+    )
+{
+    K2LIST_LINK *   pLink;
+    DLX *           pDlx;
+    K2STAT          status;
+    UINT32          level;
+    UINT32          maxLevel;
+    UINT32          count;
+
+    pLink = gpK2DLXSUPP_Vars->AcqList.mpHead;
+    while (pLink != NULL)
+    {
+        pDlx = K2_GET_CONTAINER(DLX, pLink, ListLink);
+        pDlx->mLoadLevel = K2DLX_LOADLEVEL_NONE;
+        pLink = pLink->mpNext;
+    }
+
+    maxLevel = 0;
+    pLink = gpK2DLXSUPP_Vars->AcqList.mpHead;
+    while (pLink != NULL)
+    {
+        pDlx = K2_GET_CONTAINER(DLX, pLink, ListLink);
+        status = sCalcLoadLevel(pDlx);
+        if (K2STAT_IS_ERROR(status))
+            return status;
+        if (pDlx->mLoadLevel > maxLevel)
+            maxLevel = pDlx->mLoadLevel;
+        pLink = pLink->mpNext;
+    }
+
+    //
+    // everything at a level only imports from lower levels (or already loaded
+    // modules) so each level can be read and linked in parallel once the
+    // levels below it are done
+    //
+    for (level = 0; level <= maxLevel; level++)
+    {
+        count = 0;
+        pLink = gpK2DLXSUPP_Vars->AcqList.mpHead;
+        while (pLink != NULL)
+        {
+            pDlx = K2_GET_CONTAINER(DLX, pLink, ListLink);
+            if (pDlx->mLoadLevel == level)
+            {
+                pDlx->mLoadStatus = K2STAT_ERROR_UNKNOWN;
+                count++;
+            }
+            pLink = pLink->mpNext;
+        }
+
+        gpK2DLXSUPP_Vars->Host.RunParallel(apAcqContext, sParallelLinkOne, &level, count);
+
+        pLink = gpK2DLXSUPP_Vars->AcqList.mpHead;
+        while (pLink != NULL)
+        {
+            pDlx = K2_GET_CONTAINER(DLX, pLink, ListLink);
+            if ((pDlx->mLoadLevel == level) &&
+                (K2STAT_IS_ERROR(pDlx->mLoadStatus)))
+                return pDlx->mLoadStatus;
+            pLink = pLink->mpNext;
+        }
+    }
+
+    return K2STAT_NO_ERROR;
+}
+
 static
 K2STAT
 sExecLoads(
@@ -547,6 +754,19 @@ sExecLoads(
     )
 {
     K2STAT status;
+
+    //
+    // if the host can run work in parallel then all the reading and linking is
+    // done up front, and the serial pass below only does the callbacks
+    //
+    if ((gpK2DLXSUPP_Vars->Host.RunParallel != NULL) &&
+        (gpK2DLXSUPP_Vars->AcqList.mNodeCount > 1))
+    {
+        status = sExecParallelLinks(apAcqContext);
+        if (K2STAT_IS_ERROR(status))
+            return status;
+    }
+
     do
     {
         status = sLoadModule(apAcqContext, K2_GET_CONTAINER(DLX, gpK2DLXSUPP_Vars->AcqList.mpHead, ListLink));
@@ -52,9 +52,9 @@ DLX_AddrToName(
     UINT32                  segEnd;
     char const *            pBaseName;
     UINT32                  baseAddr;
-    K2TREE_ANCHOR *         pAnchor;
-    K2TREE_NODE *           pTreeNode;
-    K2DLX_SYMTREE_NODE *    pSymTreeNode;
+    K2DLX_SYMINDEX *        pIndex;
+    Elf32_Sym const *       pSym;
+    UINT32                  b, e, m;
 
     if (aBufferLen == 0)
         return;
@@ -89,19 +89,24 @@ DLX_AddrToName(
 
     if (apDlx->mFlags & K2DLXSUPP_FLAG_KEEP_SYMBOLS)
     {
-        // find the closest matching symbol in the segment and set baseAddr and pBaseName
-        pAnchor = &apDlx->SymTree[segIx - DlxSeg_Text];
-        pTreeNode = K2TREE_FindOrAfter(pAnchor, aAddr);
-        if (pTreeNode != NULL)
+        // find the last symbol in the segment at or before the address and set baseAddr and pBaseName
+        pIndex = &apDlx->SymIndex[segIx - DlxSeg_Text];
+        b = 0;
+        e = pIndex->mCount;
+        while (b < e)
         {
-            if (pTreeNode->mUserVal != aAddr)
-                pTreeNode = K2TREE_PrevNode(pAnchor, pTreeNode);
-            if (pTreeNode != NULL)
-            {
-                pSymTreeNode = K2_GET_CONTAINER(K2DLX_SYMTREE_NODE, pTreeNode, TreeNode);
-                baseAddr = pSymTreeNode->TreeNode.mUserVal;
-                pBaseName = pSymTreeNode->mpSymName;
-            }
+            m = (b + e) / 2;
+            pSym = (Elf32_Sym const *)(pIndex->mpSymBase + (pIndex->mpIx[m] * pIndex->mSymEntBytes));
+            if (pSym->st_value > aAddr)
+                e = m;
+            else
+                b = m + 1;
+        }
+        if (b > 0)
+        {
+            pSym = (Elf32_Sym const *)(pIndex->mpSymBase + (pIndex->mpIx[b - 1] * pIndex->mSymEntBytes));
+            baseAddr = pSym->st_value;
+            pBaseName = pIndex->mpSymStr + pSym->st_name;
         }
     }
 
@@ -31,6 +31,96 @@
 //
 #include "idlx.h"
 
+static
+DLX_EXPORTS_HASH const *
+sGetExportHash(
+    DLX_EXPORTS_SECTION const * apSec
+    )
+{
+    DLX_EXPORTS_HASH const *    pHash;
+    UINT32                      b;
+    UINT32                      left;
+
+    //
+    // the index is only used if its header is sane and the bloom words,
+    // buckets and chain all fit between the export refs and the first name.
+    // caller has made sure there is at least one export
+    //
+    b = sizeof(DLX_EXPORTS_SECTION) + ((apSec->mCount - 1) * sizeof(DLX_EXPORT_REF));
+    if (apSec->Export[0].mNameOffset < b + sizeof(DLX_EXPORTS_HASH))
+        return NULL;
+    left = apSec->Export[0].mNameOffset - (b + sizeof(DLX_EXPORTS_HASH));
+
+    pHash = (DLX_EXPORTS_HASH const *)(((UINT8 const *)apSec) + b);
+
+    if ((pHash->mBucketCount == 0) ||
+        (pHash->mBloomWords == 0) ||
+        (0 != (pHash->mBloomWords & (pHash->mBloomWords - 1))) ||
+        (pHash->mBloomShift >= 32))
+        return NULL;
+
+    if (pHash->mBloomWords > (left / sizeof(UINT32)))
+        return NULL;
+    left -= pHash->mBloomWords * sizeof(UINT32);
+
+    if (pHash->mBucketCount > (left / sizeof(UINT32)))
+        return NULL;
+    left -= pHash->mBucketCount * sizeof(UINT32);
+
+    if (apSec->mCount > (left / sizeof(DLX_EXPORT_HASHENT)))
+        return NULL;
+
+    return pHash;
+}
+
+static
+K2STAT
+sFindHashedExport(
+    DLX_EXPORTS_SECTION const * apSec,
+    DLX_EXPORTS_HASH const *    apHash,
+    char const *                apName,
+    UINT32 *                    apRetAddr
+    )
+{
+    UINT32 const *              pBloom;
+    UINT32 const *              pBucket;
+    DLX_EXPORT_HASHENT const *  pEnt;
+    UINT32                      hash;
+    UINT32                      mask;
+    UINT32                      ix;
+    UINT32                      left;
+
+    hash = DLX_ExportNameHash(apName);
+
+    pBloom = (UINT32 const *)(apHash + 1);
+    mask = (((UINT32)1) << (hash & 31)) | (((UINT32)1) << ((hash >> apHash->mBloomShift) & 31));
+    if ((pBloom[(hash / 32) & (apHash->mBloomWords - 1)] & mask) != mask)
+        return K2STAT_ERROR_NOT_FOUND;
+
+    pBucket = pBloom + apHash->mBloomWords;
+    ix = pBucket[hash % apHash->mBucketCount];
+    if ((ix == DLX_EXPORT_HASH_EMPTY) || (ix >= apSec->mCount))
+        return K2STAT_ERROR_NOT_FOUND;
+
+    pEnt = ((DLX_EXPORT_HASHENT const *)(pBucket + apHash->mBucketCount)) + ix;
+    left = apSec->mCount - ix;
+    do
+    {
+        if (((pEnt->mHash | 1) == (hash | 1)) &&
+            (pEnt->mExportIx < apSec->mCount) &&
+            (0 == K2ASC_Comp(apName, ((char const *)apSec) + apSec->Export[pEnt->mExportIx].mNameOffset)))
+        {
+            *apRetAddr = apSec->Export[pEnt->mExportIx].mAddr;
+            return 0;
+        }
+        if (pEnt->mHash & 1)
+            break;
+        pEnt++;
+    } while (--left);
+
+    return K2STAT_ERROR_NOT_FOUND;
+}
+
 K2STAT
 iK2DLXSUPP_FindExport(
     DLX_EXPORTS_SECTION const * apSec,
@@ -38,11 +128,23 @@ iK2DLXSUPP_FindExport(
     UINT32 *                    apRetAddr
     )
 {
-    UINT32          b;
-    UINT32          e;
-    UINT32          m;
-    int             c;
-    char const *    pStrBase;
+    UINT32                      b;
+    UINT32                      e;
+    UINT32                      m;
+    int                         c;
+    char const *                pStrBase;
+    DLX_EXPORTS_HASH const *    pHash;
+
+    if (apSec->mCount == 0)
+        return K2STAT_ERROR_NOT_FOUND;
+
+    //
+    // use the hash index if the section has a usable one.
+    // otherwise binary search
+    //
+    pHash = sGetExportHash(apSec);
+    if (pHash != NULL)
+        return sFindHashedExport(apSec, pHash, apName, apRetAddr);
 
     pStrBase = (char *)apSec;
     b = 0;
@@ -65,6 +167,41 @@ iK2DLXSUPP_FindExport(
     return K2STAT_ERROR_NOT_FOUND;
 }
 
+UINT32
+iK2DLXSUPP_CalcExportDigest(
+    DLX_EXPORTS_SECTION const * apSec
+    )
+{
+    UINT32  crc;
+    UINT32  ix;
+
+    crc = 0;
+    for (ix = 0; ix < apSec->mCount; ix++)
+        crc = K2CRC_Calc32(crc, &apSec->Export[ix].mAddr, sizeof(UINT32));
+
+    return crc;
+}
+
+void
+iK2DLXSUPP_SetExportDigests(
+    DLX *   apDlx
+    )
+{
+    UINT32  ix;
+
+    //
+    // export addresses are final link addresses at this point.  these
+    // are what a prelinked importer compares against to skip relocation
+    //
+    for (ix = 0; ix < K2DLX_EXPIX_COUNT; ix++)
+    {
+        if (apDlx->mpExpSecDataAddr[ix] != NULL)
+            apDlx->mExpDigest[ix] = iK2DLXSUPP_CalcExportDigest(apDlx->mpExpSecDataAddr[ix]);
+        else
+            apDlx->mExpDigest[ix] = 0;
+    }
+}
+
 K2STAT
 DLX_FindExport(
     DLX *           apDlx,
@@ -92,8 +229,7 @@ DLX_FindExport(
         //
         // try data address first, then link address
         //
-        ppExp = (DLX_EXPORTS_SECTION const **)&apDlx->mpExpCodeDataAddr;
-        ppExp += (aDlxSegment - DlxSeg_Text);
+        ppExp = (DLX_EXPORTS_SECTION const **)&apDlx->mpExpSecDataAddr[aDlxSegment - DlxSeg_Text];
         if (*ppExp == NULL)
         {
             ppExp = (DLX_EXPORTS_SECTION const **)&apDlx->mpInfo->mpExpCode;
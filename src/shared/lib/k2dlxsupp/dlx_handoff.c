@@ -115,19 +115,19 @@ sHandoffOneDlxSector(
         apSector->Module.mSectorCount = 0;
         apSector->Module.mRelocSectionCount = 0;
 
-        if (apSector->Module.mpExpCodeDataAddr != NULL)
+        if (apSector->Module.mpExpSecDataAddr[K2DLX_EXPIX_CODE] != NULL)
         {
-            if (!ConvertLoadPtr((UINT32 *)&apSector->Module.mpExpCodeDataAddr))
+            if (!ConvertLoadPtr((UINT32 *)&apSector->Module.mpExpSecDataAddr[K2DLX_EXPIX_CODE]))
                 break;
         }
-        if (apSector->Module.mpExpReadDataAddr != NULL)
+        if (apSector->Module.mpExpSecDataAddr[K2DLX_EXPIX_READ] != NULL)
         {
-            if (!ConvertLoadPtr((UINT32 *)&apSector->Module.mpExpReadDataAddr))
+            if (!ConvertLoadPtr((UINT32 *)&apSector->Module.mpExpSecDataAddr[K2DLX_EXPIX_READ]))
                 break;
         }
-        if (apSector->Module.mpExpDataDataAddr != NULL)
+        if (apSector->Module.mpExpSecDataAddr[K2DLX_EXPIX_DATA] != NULL)
         {
-            if (!ConvertLoadPtr((UINT32 *)&apSector->Module.mpExpDataDataAddr))
+            if (!ConvertLoadPtr((UINT32 *)&apSector->Module.mpExpSecDataAddr[K2DLX_EXPIX_DATA]))
                 break;
         }
 
@@ -0,0 +1,158 @@
+//   
+//   BSD 3-Clause License
+//   
+//   Copyright (c) 2020, Kurt Kennett
+//   All rights reserved.
+//   
+//   Redistribution and use in source and binary forms, with or without
+//   modification, are permitted provided that the following conditions are met:
+//   
+//   1. Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//   
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//   
+//   3. Neither the name of the copyright holder nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//   
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//   FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//   SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//   CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+#include "idlx.h"
+#include <lib/zlib.h>
+
+#define INFLATE_READ_SECTORS    8
+
+static
+voidpf
+sZAlloc(
+    voidpf  aOpaque,
+    uInt    aItems,
+    uInt    aSize
+    )
+{
+    return (voidpf)gpK2DLXSUPP_Vars->Host.AllocScratch((void *)aOpaque, aItems * aSize);
+}
+
+static
+void
+sZFree(
+    voidpf  aOpaque,
+    voidpf  aAddress
+    )
+{
+    gpK2DLXSUPP_Vars->Host.FreeScratch((void *)aOpaque, (void *)aAddress);
+}
+
+K2STAT
+iK2DLXSUPP_InflateSegment(
+    void *      apAcqContext,
+    DLX *       apDlx,
+    UINT32      aSegIx,
+    UINT32      aSectorCount,
+    UINT32 *    apRetBytes
+    )
+{
+    z_stream    strm;
+    UINT8 *     pInBuf;
+    UINT8 *     pOut;
+    UINT32      chunk;
+    UINT32      crc;
+    int         zRet;
+    K2STAT      status;
+
+    if ((gpK2DLXSUPP_Vars->Host.AllocScratch == NULL) ||
+        (gpK2DLXSUPP_Vars->Host.FreeScratch == NULL))
+        return K2DLXSUPP_ERRORPOINT(K2STAT_ERROR_NOT_IMPL);
+
+    pInBuf = (UINT8 *)gpK2DLXSUPP_Vars->Host.AllocScratch(apAcqContext, INFLATE_READ_SECTORS * DLX_SECTOR_BYTES);
+    if (pInBuf == NULL)
+        return K2DLXSUPP_ERRORPOINT(K2STAT_ERROR_OUT_OF_MEMORY);
+
+    K2MEM_Zero(&strm, sizeof(strm));
+    strm.zalloc = sZAlloc;
+    strm.zfree = sZFree;
+    strm.opaque = (voidpf)apAcqContext;
+
+    // raw deflate stream - negative window bits means no zlib header or trailer
+    if (inflateInit2(&strm, -DLX_DEFLATE_WINDOW_BITS) != Z_OK)
+    {
+        gpK2DLXSUPP_Vars->Host.FreeScratch(apAcqContext, pInBuf);
+        return K2DLXSUPP_ERRORPOINT(K2STAT_ERROR_OUT_OF_MEMORY);
+    }
+
+    //
+    // inflate straight into the segment pages as the sectors come in, and crc
+    // each piece of output while it is still hot in the cache
+    //
+    pOut = (UINT8 *)apDlx->SegAlloc.Segment[aSegIx].mDataAddr;
+    strm.next_out = pOut;
+    strm.avail_out = K2_ROUNDUP(apDlx->mpInfo->SegInfo[aSegIx].mMemActualBytes, K2_VA32_MEMPAGE_BYTES);
+
+    crc = 0;
+    zRet = Z_OK;
+    status = K2STAT_NO_ERROR;
+
+    do
+    {
+        chunk = aSectorCount;
+        if (chunk > INFLATE_READ_SECTORS)
+            chunk = INFLATE_READ_SECTORS;
+
+        status = gpK2DLXSUPP_Vars->Host.ReadSectors(apAcqContext, apDlx->mHostFile, pInBuf, chunk);
+        if (K2STAT_IS_ERROR(status))
+        {
+            status = K2DLXSUPP_ERRORPOINT(status);
+            break;
+        }
+        aSectorCount -= chunk;
+
+        // sector padding after the end of the stream still has to be read past
+        if (zRet == Z_STREAM_END)
+            continue;
+
+        strm.next_in = pInBuf;
+        strm.avail_in = chunk * DLX_SECTOR_BYTES;
+
+        zRet = inflate(&strm, Z_NO_FLUSH);
+
+        crc = K2CRC_Calc32(crc, pOut, (UINT32)(strm.next_out - pOut));
+        pOut = strm.next_out;
+
+        if (((zRet != Z_OK) && (zRet != Z_STREAM_END)) ||
+            ((zRet == Z_OK) && (strm.avail_out == 0) && (strm.avail_in != 0)))
+        {
+            // bad stream or stream inflates to more than the segment holds
+            status = K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_FILE_CORRUPTED);
+            break;
+        }
+
+    } while (aSectorCount > 0);
+
+    if (!K2STAT_IS_ERROR(status))
+    {
+        if (zRet != Z_STREAM_END)
+            status = K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_FILE_CORRUPTED);
+        else if (crc != apDlx->mpInfo->SegInfo[aSegIx].mCRC32)
+            status = K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_CRC_WRONG);
+        else
+            *apRetBytes = (UINT32)strm.total_out;
+    }
+
+    inflateEnd(&strm);
+
+    gpK2DLXSUPP_Vars->Host.FreeScratch(apAcqContext, pInBuf);
+
+    return status;
+}
@@ -75,21 +75,18 @@ static void sPrintGuid(K2_GUID128 const *apGuid)
 
 static
 void
-sDumpSymTree(
-    K2TREE_ANCHOR *apAnchor
+sDumpSymIndex(
+    K2DLX_SYMINDEX *apIndex
     )
 {
-    K2DLX_SYMTREE_NODE *  pSymTreeNode;
-    K2TREE_NODE *         pTreeNode;
+    UINT32              ix;
+    Elf32_Sym const *   pSym;
 
-    pTreeNode = K2TREE_FirstNode(apAnchor);
-    K2_ASSERT(pTreeNode != NULL);
-    do
+    for (ix = 0; ix < apIndex->mCount; ix++)
     {
-        pSymTreeNode = K2_GET_CONTAINER(K2DLX_SYMTREE_NODE, pTreeNode, TreeNode);
-        DUMPF("       %08X %s\n", pSymTreeNode->TreeNode.mUserVal, pSymTreeNode->mpSymName);
-        pTreeNode = K2TREE_NextNode(apAnchor, pTreeNode);
-    } while (pTreeNode != NULL);
+        pSym = (Elf32_Sym const *)(apIndex->mpSymBase + (apIndex->mpIx[ix] * apIndex->mSymEntBytes));
+        DUMPF("       %08X %s\n", pSym->st_value, apIndex->mpSymStr + pSym->st_name);
+    }
 }
 
 static
@@ -127,9 +124,9 @@ sDumpOneDlx(DLX *apDlx)
     DUMPF("  SECTORCOUNT %d\n", apDlx->mSectorCount);
     DUMPF("  RELSECS     %d\n", apDlx->mRelocSectionCount);
     DUMPF("  HDRBYTES    %d\n", apDlx->mHdrBytes);
-    DUMPF("  EXPCODELOAD 0x%08X\n", (UINT32)apDlx->mpExpCodeDataAddr);
-    DUMPF("  EXPREADLOAD 0x%08X\n", (UINT32)apDlx->mpExpReadDataAddr);
-    DUMPF("  EXPDATALOAD 0x%08X\n", (UINT32)apDlx->mpExpDataDataAddr);
+    DUMPF("  EXPCODELOAD 0x%08X\n", (UINT32)apDlx->mpExpSecDataAddr[K2DLX_EXPIX_CODE]);
+    DUMPF("  EXPREADLOAD 0x%08X\n", (UINT32)apDlx->mpExpSecDataAddr[K2DLX_EXPIX_READ]);
+    DUMPF("  EXPDATALOAD 0x%08X\n", (UINT32)apDlx->mpExpSecDataAddr[K2DLX_EXPIX_DATA]);
     DUMPF("  SEGMENTS:\n");
     for (ix = 0; ix < DlxSeg_Count; ix++)
     {
@@ -139,8 +136,8 @@ sDumpOneDlx(DLX *apDlx)
             sgpSegName[ix]);
         if ((ix >= DlxSeg_Text) && (ix <= DlxSeg_Read))
         {
-            if (apDlx->SymTree[ix - DlxSeg_Text].mNodeCount > 0)
-                sDumpSymTree(&apDlx->SymTree[ix - DlxSeg_Text]);
+            if (apDlx->SymIndex[ix - DlxSeg_Text].mCount > 0)
+                sDumpSymIndex(&apDlx->SymIndex[ix - DlxSeg_Text]);
         }
     }
     
@@ -218,19 +215,6 @@ sDumpDLX(void)
 
 K2DLXSUPP_VARS * gpK2DLXSUPP_Vars = NULL;
 
-int
-iK2DLXSUPP_CompareUINT32(
-    UINT32        aKey,
-    K2TREE_NODE * apDlx
-    )
-{
-    if (aKey < apDlx->mUserVal)
-        return -1;
-    if (aKey == apDlx->mUserVal)
-        return 0;
-    return 1;
-}
-
 K2STAT
 K2DLXSUPP_Init(
     void *              apMemoryPage,
@@ -242,7 +226,6 @@ K2DLXSUPP_Init(
 {
     K2LIST_LINK *   pListLink;
     DLX *           pDlx;
-    UINT32          ixTree;
 
     if (apMemoryPage == NULL)
         return K2DLXSUPP_ERRORPOINT(K2STAT_ERROR_BAD_ARGUMENT);
@@ -287,21 +270,6 @@ K2DLXSUPP_Init(
     {
         gpK2DLXSUPP_Vars->mHandedOff = FALSE;
 
-        //
-        // symbol trees in nodes need to be adjusted
-        // to have thier comparison function addresses updated
-        // to the current library's address
-        //
-        pListLink = gpK2DLXSUPP_Vars->LoadedList.mpHead;
-        while (pListLink != NULL)
-        {
-            pDlx = K2_GET_CONTAINER(DLX, pListLink, ListLink);
-            K2_ASSERT(pDlx->mLinkAddr == (UINT32)pDlx);
-            for (ixTree = 0;ixTree < 3; ixTree++)
-                pDlx->SymTree[ixTree].mfCompareKeyToNode = iK2DLXSUPP_CompareUINT32;
-            pListLink = pListLink->mpNext;
-        }
-
         //
         // must be done last
         //
@@ -0,0 +1,171 @@
+//   
+//   BSD 3-Clause License
+//   
+//   Copyright (c) 2020, Kurt Kennett
+//   All rights reserved.
+//   
+//   Redistribution and use in source and binary forms, with or without
+//   modification, are permitted provided that the following conditions are met:
+//   
+//   1. Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//   
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//   
+//   3. Neither the name of the copyright holder nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//   
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//   FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//   SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//   CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+#include "idlx.h"
+
+static
+BOOL
+sFindSlot(
+    DLX *       apDlx,
+    UINT32      aSlotAddr,
+    UINT32 *    apRetStubAddr,
+    UINT32 *    apRetImpSecIx
+    )
+{
+    K2DLX_SECTOR *  pSector;
+    Elf32_Shdr *    pSecHdr;
+    UINT32          secCount;
+    UINT32          secIx;
+    UINT32          slotAddr;
+
+    //
+    // section headers and link addresses are kept after load,
+    // and lazy stub, slot and import sections are all in segments
+    // that stay loaded
+    //
+    if (0 == (apDlx->mFlags & K2DLXSUPP_FLAG_LINKED))
+        return FALSE;
+
+    pSector = K2_GET_CONTAINER(K2DLX_SECTOR, apDlx, Module);
+    pSecHdr = apDlx->mpSecHdr;
+    secCount = apDlx->mpElf->e_shnum;
+    for (secIx = 3; secIx < secCount; secIx++)
+    {
+        if ((pSecHdr[secIx].sh_type != DLX_SHT_DLX_LAZYSTUB) ||
+            (pSecHdr[secIx].sh_info >= secCount))
+            continue;
+
+        slotAddr = pSector->mSecAddr[pSecHdr[secIx].sh_info + secCount];
+        if ((aSlotAddr < slotAddr) ||
+            ((aSlotAddr - slotAddr) >= pSecHdr[pSecHdr[secIx].sh_info].sh_size))
+            continue;
+
+        *apRetStubAddr = pSector->mSecAddr[secIx + secCount] +
+            (((aSlotAddr - slotAddr) / sizeof(UINT32)) * DLX_LAZY_STUB_BYTES);
+        *apRetImpSecIx = pSecHdr[secIx].sh_link;
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+UINT32
+K2_CALLCONV_REGS
+K2DLXSUPP_LazyBind(
+    UINT32  aSlotAddr
+    )
+{
+    K2LIST_ANCHOR *         pList;
+    K2LIST_LINK *           pLink;
+    DLX *                   pDlx;
+    K2DLX_SECTOR *          pSector;
+    Elf32_Shdr *            pImpSecHdr;
+    DLX_EXPORTS_SECTION *   pImpSec;
+    DLX_EXPORTS_SECTION *   pExpSec;
+    UINT32                  stubAddr;
+    UINT32                  impSecIx;
+    UINT32                  refIx;
+    UINT32                  addr;
+    K2STAT                  status;
+    DLX_LOAD_STATS *        pStats;
+
+    if (gpK2DLXSUPP_Vars->Host.CritSec != NULL)
+    {
+        status = gpK2DLXSUPP_Vars->Host.CritSec(TRUE);
+        K2_ASSERT(!K2STAT_IS_ERROR(status));
+    }
+
+    //
+    // the caller may be the entrypoint of a dlx that is linked but
+    // still being loaded, so the acquire list is checked as well
+    //
+    addr = 0;
+    pDlx = NULL;
+    pList = &gpK2DLXSUPP_Vars->LoadedList;
+    do
+    {
+        pLink = pList->mpHead;
+        while (pLink != NULL)
+        {
+            pDlx = K2_GET_CONTAINER(DLX, pLink, ListLink);
+            if (sFindSlot(pDlx, aSlotAddr, &stubAddr, &impSecIx))
+                break;
+            pLink = pLink->mpNext;
+        }
+        if (pLink != NULL)
+            break;
+        if (pList == &gpK2DLXSUPP_Vars->AcqList)
+            break;
+        pList = &gpK2DLXSUPP_Vars->AcqList;
+    } while (1);
+
+    if (pLink != NULL)
+    {
+        //
+        // the loader left sh_entsize as the fast link flag and put the 
+        // link address of the exports being imported from in sh_info
+        //
+        pSector = K2_GET_CONTAINER(K2DLX_SECTOR, pDlx, Module);
+        pImpSecHdr = &pDlx->mpSecHdr[impSecIx];
+        pImpSec = (DLX_EXPORTS_SECTION *)pSector->mSecAddr[impSecIx + pDlx->mpElf->e_shnum];
+        pExpSec = (DLX_EXPORTS_SECTION *)pImpSecHdr->sh_info;
+        refIx = *((UINT32 *)(stubAddr + DLX_LAZY_STUB_IXOFFSET));
+        if (refIx < pImpSec->mCount)
+        {
+            // bound after the load but counted with it
+            pStats = iK2DLXSUPP_StatFind(pDlx);
+            if (pImpSecHdr->sh_entsize != 0)
+            {
+                addr = pExpSec->Export[refIx].mAddr;
+                if (pStats != NULL)
+                    pStats->mFastImportCount++;
+            }
+            else
+            {
+                status = iK2DLXSUPP_FindExport(pExpSec, ((char const *)pImpSec) + pImpSec->Export[refIx].mNameOffset, &addr);
+                if (K2STAT_IS_ERROR(status))
+                    addr = 0;
+                else if (pStats != NULL)
+                    pStats->mSlowImportCount++;
+            }
+            if (addr != 0)
+                *((UINT32 *)aSlotAddr) = addr;
+        }
+    }
+
+    if (gpK2DLXSUPP_Vars->Host.CritSec != NULL)
+        gpK2DLXSUPP_Vars->Host.CritSec(FALSE);
+
+    // an import that cannot be bound is fatal here, as the call cannot be completed
+    K2_ASSERT(addr != 0);
+
+    return addr;
+}
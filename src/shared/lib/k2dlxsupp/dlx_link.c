@@ -242,6 +242,34 @@ sRelinkOneX32(
 #endif
 #endif
 
+static
+DlxRelocStat
+sRelocStat(
+    UINT32  aMachine,
+    UINT32  aRelocType
+    )
+{
+    if (aMachine == EM_X32)
+        return (aRelocType == R_386_PC32) ? DlxRelocStat_Pc32 : DlxRelocStat_Abs32;
+
+    switch (aRelocType)
+    {
+    case R_ARM_PC24:
+    case R_ARM_CALL:
+    case R_ARM_JUMP24:
+        return DlxRelocStat_Branch;
+    case R_ARM_MOVW_ABS_NC:
+        return DlxRelocStat_MovW;
+    case R_ARM_MOVT_ABS:
+        return DlxRelocStat_MovT;
+    case R_ARM_PREL31:
+        return DlxRelocStat_Prel31;
+    default:
+        break;
+    }
+
+    return DlxRelocStat_Abs32;
+}
 
 static
 DLX *
@@ -269,7 +297,8 @@ sGetImportByIndex(
 static
 K2STAT
 sLocateImports(
-    K2DLX_SECTOR * apSector
+    K2DLX_SECTOR *  apSector,
+    BOOL *          apRetPrelinkBound
     )
 {
     Elf32_Shdr *            pSecHdrArray;
@@ -281,9 +310,11 @@ sLocateImports(
     K2_GUID128 *            pGuid;
     DLX *                   pImportFrom;
     DLX_INFO *              pImportInfo;
+    UINT32                  expIx;
 
     secCount = apSector->Module.mpElf->e_shnum;
     pSecHdrArray = apSector->Module.mpSecHdr;
+    *apRetPrelinkBound = TRUE;
 
     for (secIx = 3; secIx < secCount;secIx++)
     {
@@ -310,22 +341,25 @@ sLocateImports(
             {
                 if (pImportInfo->mpExpCode == NULL)
                     return K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_CODE_IMPORTS_NOT_FOUND);
-                pExpCheck = pImportFrom->mpExpCodeDataAddr;
+                pExpCheck = pImportFrom->mpExpSecDataAddr[K2DLX_EXPIX_CODE];
                 K2_ASSERT(pExpCheck != NULL);
+                expIx = 0;
             }
             else if (pSecHdr->sh_flags & SHF_WRITE)
             {
                 if (pImportInfo->mpExpData == NULL)
                     return K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_DATA_IMPORTS_NOT_FOUND);
-                pExpCheck = pImportFrom->mpExpDataDataAddr;
+                pExpCheck = pImportFrom->mpExpSecDataAddr[K2DLX_EXPIX_DATA];
                 K2_ASSERT(pExpCheck != NULL);
+                expIx = 2;
             }
             else
             {
                 if (pImportInfo->mpExpRead == NULL)
                     return K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_READ_IMPORTS_NOT_FOUND);
-                pExpCheck = pImportFrom->mpExpReadDataAddr;
+                pExpCheck = pImportFrom->mpExpSecDataAddr[K2DLX_EXPIX_READ];
                 K2_ASSERT(pExpCheck != NULL);
+                expIx = 1;
             }
             pSecHdr->sh_link = (Elf32_Word)pExpCheck;
 
@@ -336,6 +370,139 @@ sLocateImports(
                 pSecHdr->sh_entsize = 1;
             else
                 pSecHdr->sh_entsize = 0;
+
+            if (pSecHdr->sh_addralign != DlxSeg_Reloc)
+            {
+                // import sections only stay loaded when calls through them are
+                // bound lazily.  nothing is relocated against them, and the binder
+                // needs the link address of the exports once the load is done
+                if (expIx != 0)
+                    return K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_FILE_CORRUPTED);
+                pSecHdr->sh_info = (Elf32_Word)pImportInfo->mpExpCode;
+                continue;
+            }
+
+            // sh_info is the digest of the export addresses these imports
+            // were prelinked against.  if it is zero or the exporter did not
+            // end up at those addresses then the relocations must be redone
+            if ((pSecHdr->sh_entsize == 0) ||
+                (pSecHdr->sh_info == 0) ||
+                (pSecHdr->sh_info != pImportFrom->mExpDigest[expIx]))
+                *apRetPrelinkBound = FALSE;
+        }
+    }
+
+    return 0;
+}
+
+static
+K2STAT
+sSetupLazyStubs(
+    K2DLX_SECTOR *  apSector
+    )
+{
+    Elf32_Shdr *            pSecHdrArray;
+    Elf32_Shdr *            pStubSecHdr;
+    Elf32_Shdr *            pImpSecHdr;
+    UINT32                  secCount;
+    UINT32                  secIx;
+    UINT32                  stubCount;
+    UINT32                  refIx;
+    UINT32                  slotAddr;
+    UINT32                  word;
+    UINT8 *                 pStub;
+    UINT32 *                pSlot;
+    DLX_EXPORTS_SECTION *   pImpSec;
+    DLX_EXPORTS_SECTION *   pExpSec;
+    K2STAT                  status;
+    DLX_LOAD_STATS *        pStats;
+
+    secCount = apSector->Module.mpElf->e_shnum;
+    pSecHdrArray = apSector->Module.mpSecHdr;
+    pStats = iK2DLXSUPP_StatFind(&apSector->Module);
+
+    for (secIx = 3; secIx < secCount; secIx++)
+    {
+        pStubSecHdr = &pSecHdrArray[secIx];
+        if (pStubSecHdr->sh_type != DLX_SHT_DLX_LAZYSTUB)
+            continue;
+
+        if ((pStubSecHdr->sh_link >= secCount) ||
+            (pStubSecHdr->sh_info >= secCount))
+            return K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_FILE_CORRUPTED);
+
+        pImpSecHdr = &pSecHdrArray[pStubSecHdr->sh_link];
+        stubCount = pStubSecHdr->sh_size / DLX_LAZY_STUB_BYTES;
+        if (((pImpSecHdr->sh_flags & DLX_SHF_TYPE_MASK) != DLX_SHF_TYPE_IMPORTS) ||
+            (0 == (pImpSecHdr->sh_flags & SHF_EXECINSTR)) ||
+            (pImpSecHdr->sh_addralign == DlxSeg_Reloc) ||
+            (pStubSecHdr->sh_addralign != DlxSeg_Text) ||
+            (pSecHdrArray[pStubSecHdr->sh_info].sh_addralign != DlxSeg_Data) ||
+            (pSecHdrArray[pStubSecHdr->sh_info].sh_size != stubCount * sizeof(UINT32)))
+            return K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_FILE_CORRUPTED);
+
+        // stubs and slots are written at their data addresses but
+        // the stubs use the link address of the slots
+        pStub = (UINT8 *)apSector->mSecAddr[secIx];
+        pSlot = (UINT32 *)apSector->mSecAddr[pStubSecHdr->sh_info];
+        slotAddr = apSector->mSecAddr[pStubSecHdr->sh_info + secCount];
+
+        // sLocateImports left the DATA address of the exports in sh_link
+        pImpSec = (DLX_EXPORTS_SECTION *)apSector->mSecAddr[pStubSecHdr->sh_link];
+        pExpSec = (DLX_EXPORTS_SECTION *)pImpSecHdr->sh_link;
+
+        while (stubCount--)
+        {
+            K2MEM_Copy(&refIx, pStub + DLX_LAZY_STUB_IXOFFSET, sizeof(UINT32));
+            if ((refIx >= pImpSec->mCount) ||
+                (pImpSec->Export[refIx].mNameOffset >= pImpSecHdr->sh_size))
+                return K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_FILE_CORRUPTED);
+
+            if (apSector->Module.mpElf->e_machine == EM_X32)
+            {
+                // mov eax, slot
+                // jmp [eax]
+                pStub[0] = 0xB8;
+                K2MEM_Copy(pStub + 1, &slotAddr, sizeof(UINT32));
+                pStub[5] = 0xFF;
+                pStub[6] = 0x20;
+                K2MEM_Set(pStub + 7, 0xCC, DLX_LAZY_STUB_IXOFFSET - 7);
+            }
+            else
+            {
+                // ldr ip, [pc]
+                // ldr pc, [ip]
+                // .word slot
+                word = 0xE59FC000;
+                K2MEM_Copy(pStub, &word, sizeof(UINT32));
+                word = 0xE59CF000;
+                K2MEM_Copy(pStub + 4, &word, sizeof(UINT32));
+                K2MEM_Copy(pStub + 8, &slotAddr, sizeof(UINT32));
+            }
+
+            if (gpK2DLXSUPP_Vars->Host.LazyThunk != NULL)
+                *pSlot = (UINT32)gpK2DLXSUPP_Vars->Host.LazyThunk;
+            else if (pImpSecHdr->sh_entsize != 0)
+            {
+                *pSlot = pExpSec->Export[refIx].mAddr;
+                if (pStats != NULL)
+                    pStats->mFastImportCount++;
+            }
+            else
+            {
+                status = iK2DLXSUPP_FindExport(
+                    pExpSec,
+                    ((char const *)pImpSec) + pImpSec->Export[refIx].mNameOffset,
+                    pSlot);
+                if (K2STAT_IS_ERROR(status))
+                    return status;
+                if (pStats != NULL)
+                    pStats->mSlowImportCount++;
+            }
+
+            pStub += DLX_LAZY_STUB_BYTES;
+            pSlot++;
+            slotAddr += sizeof(UINT32);
         }
     }
 
@@ -364,6 +531,9 @@ sChangeAddresses(
     K2STAT              status;
     UINT32              entryAddr;
     DLX_INFO *          pInfo;
+    DLX_LOAD_STATS *    pStats;
+
+    pStats = iK2DLXSUPP_StatFind(&apSector->Module);
 
     sectionCount = apSector->Module.mpElf->e_shnum;
     pSecHdrArray = apSector->Module.mpSecHdr;
@@ -405,6 +575,8 @@ sChangeAddresses(
                     // fast link by offset
                     pRef = (DLX_EXPORT_REF *)(pTrgSecHdr->sh_link + symOffset);
                     pSym->st_value = pRef->mAddr;
+                    if (pStats != NULL)
+                        pStats->mFastImportCount++;
                 }
                 else
                 {
@@ -415,6 +587,8 @@ sChangeAddresses(
                         &pSym->st_value);
                     if (K2STAT_IS_ERROR(status))
                         return status;
+                    if (pStats != NULL)
+                        pStats->mSlowImportCount++;
                 }
             }
             else
@@ -457,6 +631,189 @@ sChangeAddresses(
     return 0;
 }
 
+static
+BOOL
+sAtPreferredAddr(
+    K2DLX_SECTOR * apSector
+    )
+{
+    DLX_INFO *  pInfo;
+    UINT32      segIx;
+
+    pInfo = apSector->Module.mpInfo;
+    for (segIx = DlxSeg_Text; segIx <= DlxSeg_Data; segIx++)
+    {
+        if ((pInfo->SegInfo[segIx].mMemActualBytes != 0) &&
+            (apSector->Module.SegAlloc.Segment[segIx].mLinkAddr != pInfo->SegInfo[segIx].mLinkAddr))
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+static
+Elf32_Rel *
+sGetRelocTail(
+    Elf32_Shdr *    apRelSecHdr,
+    DLX_RELOC_HDR * apHdr
+    )
+{
+    UINT8 *             pWork;
+    UINT8 *             pEnd;
+    DLX_RELOC_GROUP *   pGroup;
+    UINT32              left;
+
+    pWork = (UINT8 *)(apHdr + 1);
+    pEnd = ((UINT8 *)apHdr) + apRelSecHdr->sh_size;
+    left = apHdr->mGroupCount;
+    while (left--)
+    {
+        pGroup = (DLX_RELOC_GROUP *)pWork;
+        pWork += sizeof(DLX_RELOC_GROUP);
+        if ((pWork > pEnd) ||
+            (pGroup->mWordCount > ((UINT32)(pEnd - pWork)) / sizeof(UINT32)))
+            return NULL;
+        pWork += pGroup->mWordCount * sizeof(UINT32);
+    }
+    if ((apHdr->mRelCount * sizeof(Elf32_Rel)) > (UINT32)(pEnd - pWork))
+        return NULL;
+
+    return (Elf32_Rel *)pWork;
+}
+
+static
+void
+sAddAt(
+    UINT8 * apAddr,
+    UINT32  aMove
+    )
+{
+    UINT32 val;
+
+    K2MEM_Copy(&val, apAddr, sizeof(UINT32));
+    val += aMove;
+    K2MEM_Copy(apAddr, &val, sizeof(UINT32));
+}
+
+static
+K2STAT
+sProcessRelocGroups(
+    K2DLX_SECTOR * apSector
+    )
+{
+    Elf32_Shdr *        pSecHdrArray;
+    Elf32_Shdr *        pRelSecHdr;
+    Elf32_Shdr *        pTrgSecHdr;
+    DLX_INFO *          pInfo;
+    K2DLXSUPP_SEG *     pSeg;
+    UINT32              sectionCount;
+    UINT32              secIx;
+    UINT32              trgMove;
+    UINT32              move;
+    UINT8 *             pTrgData;
+    DLX_RELOC_HDR *     pHdr;
+    DLX_RELOC_GROUP *   pGroup;
+    UINT32 *            pWord;
+    UINT32              groupLeft;
+    UINT32              wordLeft;
+    UINT32              word;
+    UINT32              offset;
+    UINT32              at;
+    UINT32              applied;
+    DLX_LOAD_STATS *    pStats;
+
+    pStats = iK2DLXSUPP_StatFind(&apSector->Module);
+
+    pSecHdrArray = apSector->Module.mpSecHdr;
+    sectionCount = apSector->Module.mpElf->e_shnum;
+    pInfo = apSector->Module.mpInfo;
+    pSeg = apSector->Module.SegAlloc.Segment;
+
+    for (secIx = 3; secIx < sectionCount; secIx++)
+    {
+        pRelSecHdr = &pSecHdrArray[secIx];
+        if (pRelSecHdr->sh_type != DLX_SHT_DLX_RELOC)
+            continue;
+
+        pTrgSecHdr = &pSecHdrArray[pRelSecHdr->sh_info];
+        pTrgData = (UINT8 *)apSector->mSecAddr[pRelSecHdr->sh_info];
+
+        // addralign is segment index for section
+        if ((pTrgSecHdr->sh_addralign < DlxSeg_Text) ||
+            (pTrgSecHdr->sh_addralign > DlxSeg_Data))
+            return K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_FILE_CORRUPTED);
+        trgMove = pSeg[pTrgSecHdr->sh_addralign].mLinkAddr - pInfo->SegInfo[pTrgSecHdr->sh_addralign].mLinkAddr;
+
+        pHdr = (DLX_RELOC_HDR *)apSector->mSecAddr[secIx];
+        if (NULL == sGetRelocTail(pRelSecHdr, pHdr))
+            return K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_FILE_CORRUPTED);
+
+        pGroup = (DLX_RELOC_GROUP *)(pHdr + 1);
+        for (groupLeft = pHdr->mGroupCount; groupLeft > 0; groupLeft--)
+        {
+            pWord = (UINT32 *)(pGroup + 1);
+            wordLeft = pGroup->mWordCount;
+
+            if ((pGroup->mSymSegment < DlxSeg_Text) ||
+                (pGroup->mSymSegment > DlxSeg_Data))
+                return K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_FILE_CORRUPTED);
+            move = pSeg[pGroup->mSymSegment].mLinkAddr - pInfo->SegInfo[pGroup->mSymSegment].mLinkAddr;
+            if (pGroup->mKind == DLX_RELOC_KIND_PC32)
+                move -= trgMove;
+            else if (pGroup->mKind != DLX_RELOC_KIND_ABS32)
+                return K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_FILE_CORRUPTED);
+
+            if (move != 0)
+            {
+                // values at targets already hold the link-time address so
+                // all that is needed is to add how far the segment moved
+                applied = 0;
+                offset = 0;
+                while (wordLeft > 0)
+                {
+                    word = *pWord;
+                    if (0 == (word & 1))
+                    {
+                        offset = word >> 1;
+                        if ((offset + sizeof(UINT32)) > pTrgSecHdr->sh_size)
+                            return K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_FILE_CORRUPTED);
+                        sAddAt(pTrgData + offset, move);
+                        applied++;
+                        offset += sizeof(UINT32);
+                    }
+                    else
+                    {
+                        word >>= 1;
+                        at = offset;
+                        while (word != 0)
+                        {
+                            if (word & 1)
+                            {
+                                if ((at + sizeof(UINT32)) > pTrgSecHdr->sh_size)
+                                    return K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_FILE_CORRUPTED);
+                                sAddAt(pTrgData + at, move);
+                                applied++;
+                            }
+                            word >>= 1;
+                            at += sizeof(UINT32);
+                        }
+                        offset += 31 * sizeof(UINT32);
+                    }
+                    pWord++;
+                    wordLeft--;
+                }
+
+                if (pStats != NULL)
+                    pStats->mRelocCount[(pGroup->mKind == DLX_RELOC_KIND_PC32) ? DlxRelocStat_GroupPc32 : DlxRelocStat_GroupAbs32] += applied;
+            }
+
+            pGroup = (DLX_RELOC_GROUP *)(((UINT32 *)(pGroup + 1)) + pGroup->mWordCount);
+        }
+    }
+
+    return 0;
+}
+
 static
 K2STAT
 sProcessReloc(
@@ -468,6 +825,7 @@ sProcessReloc(
     Elf32_Shdr *    pRelSecHdr;
     Elf32_Shdr *    pSymSecHdr;
     Elf32_Shdr *    pTrgSecHdr;
+    Elf32_Shdr *    pImpSecHdr;
     UINT32          secIx;
     UINT32          sectionCount;
     UINT32          relIx;
@@ -482,23 +840,34 @@ sProcessReloc(
     Elf32_Sym *     pSym;
     K2STAT          status;
     pfLinkFunc      linkFunc;
+    BOOL            prelinked;
+    UINT32          symVal;
+    DLX_LOAD_STATS *pStats;
 
 #if K2_TOOLCHAIN_IS_MS
     sUnlinkOne = (apSector->Module.mpElf->e_machine == EM_X32) ? sUnlinkOneX32 : sUnlinkOneA32;
     sRelinkOne = (apSector->Module.mpElf->e_machine == EM_X32) ? sRelinkOneX32 : sRelinkOneA32;
 #endif
     if (!aLink)
+    {
         linkFunc = sUnlinkOne;
+        pStats = NULL;
+    }
     else
+    {
         linkFunc = sRelinkOne;
+        pStats = iK2DLXSUPP_StatFind(&apSector->Module);
+    }
 
     pSecHdrArray = apSector->Module.mpSecHdr;
     sectionCount = apSector->Module.mpElf->e_shnum;
+    prelinked = (apSector->Module.mpElf->e_flags & DLX_EF_PRELINKED) ? TRUE : FALSE;
 
     for (secIx = 3; secIx < sectionCount; secIx++)
     {
         pRelSecHdr = &pSecHdrArray[secIx];
-        if (pRelSecHdr->sh_type != SHT_REL)
+        if ((pRelSecHdr->sh_type != SHT_REL) &&
+            (pRelSecHdr->sh_type != DLX_SHT_DLX_RELOC))
             continue;
 
         // get symbol info and data
@@ -517,9 +886,22 @@ sProcessReloc(
         relEntBytes = pRelSecHdr->sh_entsize;
         if (relEntBytes < sizeof(Elf32_Rel))
             return K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_FILE_CORRUPTED);
-        relCount = pRelSecHdr->sh_size / relEntBytes;
+        if (pRelSecHdr->sh_type == SHT_REL)
+        {
+            relCount = pRelSecHdr->sh_size / relEntBytes;
+            pRel = (Elf32_Rel *)apSector->mSecAddr[secIx];
+        }
+        else
+        {
+            // only the relocations that could not be grouped
+            if (relEntBytes != sizeof(Elf32_Rel))
+                return K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_FILE_CORRUPTED);
+            pRel = sGetRelocTail(pRelSecHdr, (DLX_RELOC_HDR *)apSector->mSecAddr[secIx]);
+            if (pRel == NULL)
+                return K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_FILE_CORRUPTED);
+            relCount = ((DLX_RELOC_HDR *)apSector->mSecAddr[secIx])->mRelCount;
+        }
 
-        pRel = (Elf32_Rel *)apSector->mSecAddr[secIx];
         for (relIx = 0; relIx < relCount;relIx++)
         {
             symIx = ELF32_R_SYM(pRel->r_info);
@@ -530,16 +912,34 @@ sProcessReloc(
                 if ((pSym->st_shndx != 0) &&
                     (pSym->st_shndx < sectionCount))
                 {
+                    symVal = pSym->st_value;
+
                     // unlink and update relocation to just hold offset into rel target section
                     if (!aLink)
+                    {
                         pRel->r_offset -= pTrgSecHdr->sh_addr;
+                        if (prelinked)
+                        {
+                            // prelinked imports were bound to the address in the
+                            // import section ref, not the ref itself
+                            pImpSecHdr = &pSecHdrArray[pSym->st_shndx];
+                            if (((pImpSecHdr->sh_flags & DLX_SHF_TYPE_MASK) == DLX_SHF_TYPE_IMPORTS) &&
+                                (pImpSecHdr->sh_info != 0))
+                            {
+                                symVal = ((DLX_EXPORT_REF *)(apSector->mSecAddr[pSym->st_shndx] +
+                                    (symVal - pImpSecHdr->sh_addr)))->mAddr;
+                            }
+                        }
+                    }
                     status = linkFunc(
                         pTrgData + pRel->r_offset, 
                         pTrgSecHdr->sh_addr + pRel->r_offset,
                         ELF32_R_TYPE(pRel->r_info),
-                        pSym->st_value);
+                        symVal);
                     if (K2STAT_IS_ERROR(status))
                         return status;
+                    if (pStats != NULL)
+                        pStats->mRelocCount[sRelocStat(apSector->Module.mpElf->e_machine, ELF32_R_TYPE(pRel->r_info))]++;
                 }
             }
             pRel = (Elf32_Rel *)(((UINT8 *)pRel) + relEntBytes);
@@ -549,144 +949,48 @@ sProcessReloc(
     return 0;
 }
 
-static
-void
-sRetargetTreeNode(
-    K2TREE_ANCHOR * apAnchor,
-    K2TREE_NODE *   apTreeNode,
-    UINT32          aOffset,
-    K2TREE_NODE *   apNewNil
-    )
-{
-    K2TREE_NODE *pNode;
-
-    pNode = apTreeNode->mpLeftChild;
-    if (pNode != &apAnchor->NilNode)
-    {
-        sRetargetTreeNode(apAnchor, pNode, aOffset, apNewNil);
-        apTreeNode->mpLeftChild = (K2TREE_NODE *)(((UINT32)pNode) + aOffset);
-    }
-    else
-        apTreeNode->mpLeftChild = apNewNil;
-
-    pNode = apTreeNode->mpRightChild;
-    if (pNode != &apAnchor->NilNode)
-    {
-        sRetargetTreeNode(apAnchor, pNode, aOffset, apNewNil);
-        apTreeNode->mpRightChild = (K2TREE_NODE *)(((UINT32)pNode) + aOffset);
-    }
-    else
-        apTreeNode->mpRightChild = apNewNil;
-
-    pNode = K2TREE_NODE_PARENT(apTreeNode);
-    if (pNode != &apAnchor->NilNode)
-    {
-        pNode = (K2TREE_NODE *)(((UINT32)pNode) + aOffset);
-        K2TREE_NODE_SETPARENT(apTreeNode, pNode);
-    }
-    else
-        K2TREE_NODE_SETPARENT(apTreeNode, apNewNil);
-}
-
-static
-void 
-sRetargetTree(
-    K2DLX_SECTOR *  apSector,
-    UINT32          aTreeIx
-    )
-{
-    K2DLXSUPP_SEG * pSeg;
-    K2TREE_ANCHOR * pAnchor;
-    UINT32          segDiff;
-    UINT32          nodeDiff;
-    K2TREE_NODE *   pNewNilNode;
-
-    pAnchor = &apSector->Module.SymTree[aTreeIx];
-    if (pAnchor->mNodeCount == 0)
-        return;
-
-    pSeg = &apSector->Module.SegAlloc.Segment[DlxSeg_Sym];
-    segDiff = pSeg->mLinkAddr - pSeg->mDataAddr;
-
-    nodeDiff = apSector->Module.mLinkAddr - ((UINT32)&apSector->Module);
-    pNewNilNode = (K2TREE_NODE *)(((UINT8 *)&pAnchor->NilNode) + nodeDiff);
-
-    sRetargetTreeNode(pAnchor, pAnchor->RootNode.mpLeftChild, segDiff, pNewNilNode);
-
-    pAnchor->RootNode.mParentBal = (UINT32)pNewNilNode;
-    pAnchor->RootNode.mpLeftChild = (K2TREE_NODE *)(((UINT32)pAnchor->RootNode.mpLeftChild) + segDiff);
-    pAnchor->RootNode.mpRightChild = pNewNilNode;
-
-    pAnchor->NilNode.mParentBal = (UINT32)pNewNilNode;
-    pAnchor->NilNode.mpLeftChild = pNewNilNode;
-    pAnchor->NilNode.mpRightChild = pNewNilNode;
-}
-
-static
 void
-sPopulateSymTrees(
+iK2DLXSUPP_SetupSymIndex(
     K2DLX_SECTOR *apSector
     )
 {
-    Elf32_Shdr *            pSymSecHdr;
-    Elf32_Shdr *            pTrgSecHdr;
-    UINT32                  symStrAddr;
-    UINT32                  sectionCount;
-    UINT32                  secIx;
-    UINT8 *                 pSymBase;
-    UINT32                  entBytes;
-    UINT32                  symIx;
-    UINT32                  symCount;
-    Elf32_Sym *             pSym;
-    Elf32_Word              symAddr;
-    K2DLX_SYMTREE_NODE *    pSymTreeNode;
-    K2TREE_ANCHOR *         pAnchor;
+    Elf32_Shdr *        pIxSecHdr;
+    Elf32_Shdr *        pSymSecHdr;
+    UINT32              sectionCount;
+    UINT32              secIx;
+    K2DLX_SYMINDEX *    pIndex;
 
+    //
+    // index sections are made sorted by k2elf2dlx and symbols in one
+    // segment all move by the same amount, so all that needs doing here
+    // is pointing at them.  link addresses are used since that is where
+    // the sym segment ends up
+    //
     sectionCount = apSector->Module.mpElf->e_shnum;
-    for (secIx = 0; secIx < sectionCount; secIx++)
+    for (secIx = 3; secIx < sectionCount; secIx++)
     {
-        pSymSecHdr = &apSector->Module.mpSecHdr[secIx];
+        pIxSecHdr = &apSector->Module.mpSecHdr[secIx];
 
-        if (pSymSecHdr->sh_type != SHT_SYMTAB)
+        if (pIxSecHdr->sh_type != DLX_SHT_DLX_SYMIDX)
             continue;
 
-        K2_ASSERT(pSymSecHdr->sh_entsize >= sizeof(K2DLX_SYMTREE_NODE));
-
-        entBytes = pSymSecHdr->sh_entsize;
-        symCount = pSymSecHdr->sh_size / entBytes;
-        symStrAddr = apSector->mSecAddr[pSymSecHdr->sh_link + sectionCount];
-        pSymBase = (UINT8 *)apSector->mSecAddr[secIx];
-
-        for (symIx = 1; symIx < symCount; symIx++)
-        {
-            pSym = (Elf32_Sym *)(pSymBase + (symIx * entBytes));
-            
-            if ((pSym->st_shndx == 0) ||
-                (pSym->st_shndx >= sectionCount))
-                continue;
-
-            pTrgSecHdr = &apSector->Module.mpSecHdr[pSym->st_shndx];
-
-            if ((pTrgSecHdr->sh_flags & DLX_SHF_TYPE_MASK) == DLX_SHF_TYPE_IMPORTS)
-                continue;
-
-            if ((pTrgSecHdr->sh_addralign < DlxSeg_Text) ||
-                (pTrgSecHdr->sh_addralign > DlxSeg_Data))
-                continue;
-
-            pAnchor = &apSector->Module.SymTree[pTrgSecHdr->sh_addralign - DlxSeg_Text];
+        if ((pIxSecHdr->sh_info < DlxSeg_Text) ||
+            (pIxSecHdr->sh_info > DlxSeg_Data) ||
+            (pIxSecHdr->sh_link >= sectionCount))
+            continue;
 
-            symAddr = pSym->st_value;
+        pSymSecHdr = &apSector->Module.mpSecHdr[pIxSecHdr->sh_link];
+        if ((pSymSecHdr->sh_type != SHT_SYMTAB) ||
+            (pSymSecHdr->sh_link >= sectionCount))
+            continue;
 
-            pSymTreeNode = (K2DLX_SYMTREE_NODE *)pSym;
-            pSymTreeNode->mpSymName = (char *)symStrAddr + pSym->st_name;
-            pSymTreeNode->TreeNode.mUserVal = symAddr;
-            K2TREE_Insert(pAnchor, symAddr, &pSymTreeNode->TreeNode);
-        }
+        pIndex = &apSector->Module.SymIndex[pIxSecHdr->sh_info - DlxSeg_Text];
+        pIndex->mpIx = (UINT32 const *)apSector->mSecAddr[secIx + sectionCount];
+        pIndex->mCount = pIxSecHdr->sh_size / sizeof(UINT32);
+        pIndex->mpSymBase = (UINT8 const *)apSector->mSecAddr[pIxSecHdr->sh_link + sectionCount];
+        pIndex->mSymEntBytes = pSymSecHdr->sh_entsize;
+        pIndex->mpSymStr = (char const *)apSector->mSecAddr[pSymSecHdr->sh_link + sectionCount];
     }
-
-    for (secIx = 0;secIx < 3;secIx++)
-        sRetargetTree(apSector, secIx);
 }
 
 K2STAT
@@ -696,37 +1000,78 @@ iK2DLXSUPP_Link(
 {
     K2DLX_SECTOR *  pSector;
     K2STAT          status;
+    BOOL            importsBound;
+    UINT64          startTime;
+
+    pSector = K2_GET_CONTAINER(K2DLX_SECTOR, apDlx, Module);
+
+    importsBound = TRUE;
+    if (apDlx->mpInfo->mImportCount > 0)
+    {
+        startTime = iK2DLXSUPP_StatTime();
+
+        status = sLocateImports(pSector, &importsBound);
+        if (K2STAT_IS_ERROR(status))
+            return status;
+
+        // lazy stubs and slots are not covered by relocations
+        status = sSetupLazyStubs(pSector);
+        if (K2STAT_IS_ERROR(status))
+            return status;
+
+        iK2DLXSUPP_StatPhase(apDlx, DlxLoadPhase_Import, startTime);
+    }
 
     if (apDlx->mRelocSectionCount == 0)
+    {
+        iK2DLXSUPP_SetExportDigests(apDlx);
         return 0;
+    }
 
-    pSector = K2_GET_CONTAINER(K2DLX_SECTOR, apDlx, Module);
+    startTime = iK2DLXSUPP_StatTime();
 
-    if (apDlx->mpInfo->mImportCount > 0)
+    if ((apDlx->mpElf->e_flags & DLX_EF_PRELINKED) &&
+        (importsBound) &&
+        (sAtPreferredAddr(pSector)))
     {
-        status = sLocateImports(pSector);
+        // prelinked image is where it was linked to and all imports are at
+        // the addresses it was bound against, so relocation targets already
+        // hold their final values.  only symbols and headers need updating
+        status = sChangeAddresses(pSector);
         if (K2STAT_IS_ERROR(status))
             return status;
     }
+    else
+    {
+        // change values at targets of relocations 
+        // so that only offsets remain 
+        status = sProcessReloc(pSector, FALSE);
+        if (K2STAT_IS_ERROR(status))
+            return status;
 
-    // change values at targets of relocations 
-    // so that only offsets remain 
-    status = sProcessReloc(pSector, FALSE);
-    if (K2STAT_IS_ERROR(status))
-        return status;
+        // grouped relocations only need segment moves, which must be
+        // applied before the link addresses in the info are changed
+        status = sProcessRelocGroups(pSector);
+        if (K2STAT_IS_ERROR(status))
+            return status;
+
+        // now update the symbol tables, section addresses to point to the new addresses
+        status = sChangeAddresses(pSector);
+        if (K2STAT_IS_ERROR(status))
+            return status;
+
+        // apply relocations using updated symbol tables
+        status = sProcessReloc(pSector, TRUE);
+        if (K2STAT_IS_ERROR(status))
+            return status;
+    }
 
-    // now update the symbol tables, section addresses to point to the new addresses
-    status = sChangeAddresses(pSector);
-    if (K2STAT_IS_ERROR(status))
-        return status;
+    iK2DLXSUPP_StatPhase(apDlx, DlxLoadPhase_Reloc, startTime);
 
-    // apply relocations using updated symbol tables
-    status = sProcessReloc(pSector, TRUE);
-    if (K2STAT_IS_ERROR(status))
-        return status;
+    iK2DLXSUPP_SetExportDigests(apDlx);
 
     if (pSector->Module.mFlags & K2DLXSUPP_FLAG_KEEP_SYMBOLS)
-        sPopulateSymTrees(pSector);
+        iK2DLXSUPP_SetupSymIndex(pSector);
 
     return K2STAT_OK;
 }
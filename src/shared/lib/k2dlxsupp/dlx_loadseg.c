@@ -31,6 +31,59 @@
 //
 #include "idlx.h"
 
+static
+K2STAT
+sStartRead(
+    void *              apAcqContext,
+    DLX *               apDlx,
+    UINT32              aSegIx,
+    UINT32              aSector,
+    K2DLXSUPP_READ *    apRead
+    )
+{
+    DLX_SEGMENT_INFO *  pSegInfo;
+    K2STAT              status;
+
+    pSegInfo = &apDlx->mpInfo->SegInfo[aSegIx];
+
+    if ((aSector * DLX_SECTOR_BYTES) != pSegInfo->mFileOffset)
+        return K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_FILE_CORRUPTED);
+
+    K2MEM_Zero(apRead, sizeof(K2DLXSUPP_READ));
+    apRead->mpBuffer = (void *)apDlx->SegAlloc.Segment[aSegIx].mDataAddr;
+    apRead->mSectorCount = K2_ROUNDUP(pSegInfo->mFileBytes, DLX_SECTOR_BYTES) / DLX_SECTOR_BYTES;
+
+    status = gpK2DLXSUPP_Vars->Host.ReadSectorsAsync(apAcqContext, apDlx->mHostFile, apRead);
+    if (K2STAT_IS_ERROR(status))
+        return K2DLXSUPP_ERRORPOINT(status);
+
+    return K2STAT_NO_ERROR;
+}
+
+static
+UINT32
+sNextAsyncSeg(
+    DLX *   apDlx,
+    UINT32  aSegIx
+    )
+{
+    //
+    // next segment with file data, or DlxSeg_Count if there is none or it
+    // is deflated (inflate reads the file itself)
+    //
+    for (aSegIx++; aSegIx < DlxSeg_Count; aSegIx++)
+    {
+        if (apDlx->mpInfo->SegInfo[aSegIx].mFileBytes > 0)
+        {
+            if (apDlx->mpElf->e_flags & DLX_EF_DEFLATED(aSegIx))
+                break;
+            return aSegIx;
+        }
+    }
+
+    return DlxSeg_Count;
+}
+
 K2STAT
 iK2DLXSUPP_LoadSegments(
     void *  apAcqContext,
@@ -50,6 +103,15 @@ iK2DLXSUPP_LoadSegments(
     UINT32              endAddr;
     UINT32              linkAddr;
     UINT32              secSegOffset;
+    UINT32              dataBytes;
+    BOOL                useAsync;
+    K2DLXSUPP_READ      Read[2];
+    K2DLXSUPP_READ *    pRead;
+    UINT32              readIx;
+    UINT32              pendingSegIx;
+    UINT32              nextSegIx;
+    UINT32              crc;
+    UINT64              startTime;
 
     pElf = apDlx->mpElf;
     pSecHdr = apDlx->mpSecHdr;
@@ -58,7 +120,11 @@ iK2DLXSUPP_LoadSegments(
     K2MEM_Zero(&pSector->mSecAddr[3], (pElf->e_shnum - 3) * sizeof(UINT32));
     K2MEM_Zero(&pSector->mSecAddr[3 + pElf->e_shnum], (pElf->e_shnum - 3) * sizeof(UINT32));
 
-    secIx = 3;
+    useAsync = ((gpK2DLXSUPP_Vars->Host.ReadSectorsAsync != NULL) &&
+                (gpK2DLXSUPP_Vars->Host.ReadComplete != NULL));
+    readIx = 0;
+    pendingSegIx = DlxSeg_Count;
+    status = K2STAT_NO_ERROR;
 
     for (segIx = DlxSeg_Text; segIx < DlxSeg_Count; segIx++)
     {
@@ -67,39 +133,139 @@ iK2DLXSUPP_LoadSegments(
         {
             count /= DLX_SECTOR_BYTES;
 
-            if ((apDlx->mCurSector * DLX_SECTOR_BYTES) != pInfo->SegInfo[segIx].mFileOffset)
-                return K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_FILE_CORRUPTED);
+            if (pElf->e_flags & DLX_EF_DEFLATED(segIx))
+            {
+                K2_ASSERT(pendingSegIx == DlxSeg_Count);
+
+                if ((apDlx->mCurSector * DLX_SECTOR_BYTES) != pInfo->SegInfo[segIx].mFileOffset)
+                {
+                    status = K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_FILE_CORRUPTED);
+                    break;
+                }
+
+                startTime = iK2DLXSUPP_StatTime();
+                status = iK2DLXSUPP_InflateSegment(apAcqContext, apDlx, segIx, count, &dataBytes);
+                if (K2STAT_IS_ERROR(status))
+                    break;
+                iK2DLXSUPP_StatPhase(apDlx, DlxLoadPhase_SegRead, startTime);
+            }
+            else if (useAsync)
+            {
+                startTime = iK2DLXSUPP_StatTime();
+                if (pendingSegIx != segIx)
+                {
+                    status = sStartRead(apAcqContext, apDlx, segIx, apDlx->mCurSector, &Read[readIx]);
+                    if (K2STAT_IS_ERROR(status))
+                        break;
+                }
+
+                pRead = &Read[readIx];
+                pendingSegIx = DlxSeg_Count;
+                status = gpK2DLXSUPP_Vars->Host.ReadComplete(apAcqContext, apDlx->mHostFile, pRead);
+                if (K2STAT_IS_ERROR(status))
+                {
+                    status = K2DLXSUPP_ERRORPOINT(status);
+                    break;
+                }
+
+                //
+                // get the next segment read going before the crc of this one
+                //
+                readIx ^= 1;
+                nextSegIx = sNextAsyncSeg(apDlx, segIx);
+                if (nextSegIx != DlxSeg_Count)
+                {
+                    status = sStartRead(apAcqContext, apDlx, nextSegIx, apDlx->mCurSector + count, &Read[readIx]);
+                    if (K2STAT_IS_ERROR(status))
+                        break;
+                    pendingSegIx = nextSegIx;
+                }
+
+                dataBytes = count * DLX_SECTOR_BYTES;
+
+                iK2DLXSUPP_StatPhase(apDlx, DlxLoadPhase_SegRead, startTime);
+                startTime = iK2DLXSUPP_StatTime();
+
+                if (pRead->mpHostData != NULL)
+                {
+                    crc = K2CRC_MemCopyAndCalc32(0, pRead->mpBuffer, pRead->mpHostData, pInfo->SegInfo[segIx].mFileBytes);
+                    if (dataBytes > pInfo->SegInfo[segIx].mFileBytes)
+                    {
+                        K2MEM_Copy(((UINT8 *)pRead->mpBuffer) + pInfo->SegInfo[segIx].mFileBytes,
+                            ((UINT8 const *)pRead->mpHostData) + pInfo->SegInfo[segIx].mFileBytes,
+                            dataBytes - pInfo->SegInfo[segIx].mFileBytes);
+                    }
+                }
+                else
+                {
+                    crc = K2CRC_Calc32(0, pRead->mpBuffer, pInfo->SegInfo[segIx].mFileBytes);
+                }
+
+                if (crc != pInfo->SegInfo[segIx].mCRC32)
+                {
+                    status = K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_CRC_WRONG);
+                    break;
+                }
 
-            status = gpK2DLXSUPP_Vars->Host.ReadSectors(
-                apAcqContext,
-                apDlx->mHostFile, 
-                (void *)apDlx->SegAlloc.Segment[segIx].mDataAddr, 
-                count);
+                iK2DLXSUPP_StatPhase(apDlx, DlxLoadPhase_Crc, startTime);
+            }
+            else
+            {
+                if ((apDlx->mCurSector * DLX_SECTOR_BYTES) != pInfo->SegInfo[segIx].mFileOffset)
+                {
+                    status = K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_FILE_CORRUPTED);
+                    break;
+                }
+
+                startTime = iK2DLXSUPP_StatTime();
+                status = gpK2DLXSUPP_Vars->Host.ReadSectors(
+                    apAcqContext,
+                    apDlx->mHostFile, 
+                    (void *)apDlx->SegAlloc.Segment[segIx].mDataAddr, 
+                    count);
 
-            if (K2STAT_IS_ERROR(status))
-                return K2DLXSUPP_ERRORPOINT(status);
+                if (K2STAT_IS_ERROR(status))
+                {
+                    status = K2DLXSUPP_ERRORPOINT(status);
+                    break;
+                }
+                iK2DLXSUPP_StatPhase(apDlx, DlxLoadPhase_SegRead, startTime);
 
-            if (pInfo->SegInfo[segIx].mCRC32 !=
-                K2CRC_Calc32(0, (void const *)apDlx->SegAlloc.Segment[segIx].mDataAddr, pInfo->SegInfo[segIx].mFileBytes))
-                return K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_CRC_WRONG);
+                startTime = iK2DLXSUPP_StatTime();
+                if (pInfo->SegInfo[segIx].mCRC32 !=
+                    K2CRC_Calc32(0, (void const *)apDlx->SegAlloc.Segment[segIx].mDataAddr, pInfo->SegInfo[segIx].mFileBytes))
+                {
+                    status = K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_CRC_WRONG);
+                    break;
+                }
+                iK2DLXSUPP_StatPhase(apDlx, DlxLoadPhase_Crc, startTime);
+
+                dataBytes = count * DLX_SECTOR_BYTES;
+            }
 
             apDlx->mCurSector += count;
 
             if (segIx == DlxSeg_Data)
             {
                 // take care of zeroing out BSS
-                count *= DLX_SECTOR_BYTES;
                 totalSpace = K2_ROUNDUP(pInfo->SegInfo[DlxSeg_Data].mMemActualBytes, K2_VA32_MEMPAGE_BYTES);
-                totalSpace -= count;
+                totalSpace -= dataBytes;
                 if (totalSpace > 0)
-                    K2MEM_Zero((void *)(apDlx->SegAlloc.Segment[segIx].mDataAddr + count), totalSpace);
+                    K2MEM_Zero((void *)(apDlx->SegAlloc.Segment[segIx].mDataAddr + dataBytes), totalSpace);
             }
 
+            //
+            // sections made by k2elf2dlx (symbol indexes, lazy stubs) come after
+            // the ones from the source file, so sections are not in segment order
+            //
             startAddr = pInfo->SegInfo[segIx].mLinkAddr;
             endAddr = startAddr + pInfo->SegInfo[segIx].mMemActualBytes;
-            while ((pSecHdr[secIx].sh_addr >= startAddr) &&
-                    (pSecHdr[secIx].sh_addr < endAddr))
+            for (secIx = 3; secIx < pElf->e_shnum; secIx++)
             {
+                if ((pSecHdr[secIx].sh_addr < startAddr) ||
+                    (pSecHdr[secIx].sh_addr >= endAddr))
+                    continue;
+
                 // addralign is segment index for section
                 pSecHdr[secIx].sh_addralign = segIx;
                 secSegOffset = pSecHdr[secIx].sh_addr - startAddr;
@@ -107,22 +273,28 @@ iK2DLXSUPP_LoadSegments(
                 linkAddr = apDlx->SegAlloc.Segment[segIx].mLinkAddr;
                 if (linkAddr != 0)
                     pSector->mSecAddr[secIx + apDlx->mpElf->e_shnum] = secSegOffset + linkAddr;
-                secIx++;
             }
         }
     }
 
+    if (pendingSegIx != DlxSeg_Count)
+    {
+        // never leave a read outstanding into segment memory that is about to be freed
+        K2_ASSERT(K2STAT_IS_ERROR(status));
+        gpK2DLXSUPP_Vars->Host.ReadComplete(apAcqContext, apDlx->mHostFile, &Read[readIx]);
+    }
+
+    if (K2STAT_IS_ERROR(status))
+        return status;
+
     // 
-    // confirm we have done all sections, and all nonempty sections have addresses
+    // confirm we have done all sections, and all sections have addresses
     //
-    if (secIx != pElf->e_shnum)
-        return K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_FILE_CORRUPTED);
     for (secIx = 3; secIx < pElf->e_shnum; secIx++)
     {
-        if ((pSecHdr[secIx].sh_size > 0) && 
-            ((pSector->mSecAddr[secIx] == 0) || 
-             (pSecHdr[secIx].sh_addralign < DlxSeg_Text) ||
-             (pSecHdr->sh_addralign >= DlxSeg_Count)))
+        if ((pSector->mSecAddr[secIx] == 0) || 
+            (pSecHdr[secIx].sh_addralign < DlxSeg_Text) ||
+            (pSecHdr[secIx].sh_addralign >= DlxSeg_Count))
             return K2DLXSUPP_ERRORPOINT(K2STAT_DLX_ERROR_FILE_CORRUPTED);
     }
 
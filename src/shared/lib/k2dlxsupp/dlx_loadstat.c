@@ -0,0 +1,158 @@
+//   
+//   BSD 3-Clause License
+//   
+//   Copyright (c) 2020, Kurt Kennett
+//   All rights reserved.
+//   
+//   Redistribution and use in source and binary forms, with or without
+//   modification, are permitted provided that the following conditions are met:
+//   
+//   1. Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//   
+//   2. Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//   
+//   3. Neither the name of the copyright holder nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//   
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//   FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//   SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//   CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+#include "idlx.h"
+
+static
+K2DLX_LOADSTAT *
+sFind(
+    UINT32  aDlxLinkAddr
+    )
+{
+    K2DLX_LOADSTAT *    pStat;
+    UINT32              ix;
+
+    pStat = gpK2DLXSUPP_Vars->LoadStat;
+    for (ix = 0; ix < K2DLX_LOADSTAT_COUNT; ix++)
+    {
+        if (pStat->mDlxLinkAddr == aDlxLinkAddr)
+            return pStat;
+        pStat++;
+    }
+
+    return NULL;
+}
+
+void
+iK2DLXSUPP_StatAlloc(
+    DLX *   apDlx
+    )
+{
+    K2DLX_LOADSTAT * pStat;
+
+    // always inside the loader critical section
+    pStat = sFind(apDlx->mLinkAddr);
+    if (pStat == NULL)
+    {
+        pStat = sFind(0);
+        if (pStat == NULL)
+            return;
+    }
+
+    K2MEM_Zero(&pStat->Stats, sizeof(DLX_LOAD_STATS));
+    pStat->mDlxLinkAddr = apDlx->mLinkAddr;
+}
+
+void
+iK2DLXSUPP_StatFree(
+    DLX *   apDlx
+    )
+{
+    K2DLX_LOADSTAT * pStat;
+
+    pStat = sFind(apDlx->mLinkAddr);
+    if (pStat != NULL)
+        pStat->mDlxLinkAddr = 0;
+}
+
+DLX_LOAD_STATS *
+iK2DLXSUPP_StatFind(
+    DLX *   apDlx
+    )
+{
+    K2DLX_LOADSTAT * pStat;
+
+    pStat = sFind(apDlx->mLinkAddr);
+    if (pStat == NULL)
+        return NULL;
+
+    return &pStat->Stats;
+}
+
+UINT64
+iK2DLXSUPP_StatTime(
+    void
+    )
+{
+    if (gpK2DLXSUPP_Vars->Host.GetTime == NULL)
+        return 0;
+    return gpK2DLXSUPP_Vars->Host.GetTime();
+}
+
+void
+iK2DLXSUPP_StatPhase(
+    DLX *           apDlx,
+    DlxLoadPhase    aPhase,
+    UINT64          aStartTime
+    )
+{
+    DLX_LOAD_STATS *    pStats;
+    UINT64              endTime;
+
+    if (gpK2DLXSUPP_Vars->Host.GetTime == NULL)
+        return;
+
+    endTime = gpK2DLXSUPP_Vars->Host.GetTime();
+
+    pStats = iK2DLXSUPP_StatFind(apDlx);
+    if (pStats != NULL)
+        pStats->mPhaseTime[aPhase] += endTime - aStartTime;
+}
+
+K2STAT
+DLX_GetLoadStats(
+    DLX *               apDlx,
+    DLX_LOAD_STATS *    apRetStats
+    )
+{
+    DLX_LOAD_STATS * pStats;
+
+    if ((apDlx == NULL) || (apRetStats == NULL))
+        return K2DLXSUPP_ERRORPOINT(K2STAT_ERROR_BAD_ARGUMENT);
+
+    K2MEM_Zero(apRetStats, sizeof(DLX_LOAD_STATS));
+
+    apDlx = iK2DLXSUPP_FindAndAddRef(apDlx);
+
+    if (apDlx == NULL)
+        return K2DLXSUPP_ERRORPOINT(K2STAT_ERROR_NOT_FOUND);
+
+    pStats = iK2DLXSUPP_StatFind(apDlx);
+    if (pStats != NULL)
+        K2MEM_Copy(apRetStats, pStats, sizeof(DLX_LOAD_STATS));
+
+    DLX_Release(apDlx);
+
+    if (pStats == NULL)
+        return K2STAT_ERROR_NOT_FOUND;
+
+    return K2STAT_NO_ERROR;
+}
@@ -86,18 +86,18 @@ sPrepPreload(
     *apRetEndAddr = pInfo->SegInfo[DlxSeg_Sym].mLinkAddr + segBytes;
 
     // update exports DATA addresses now 
-    if (apDlx->mpExpCodeDataAddr != ((DLX_EXPORTS_SECTION *)-1))
-        apDlx->mpExpCodeDataAddr = (DLX_EXPORTS_SECTION *)(((UINT8 *)apDlx->mpExpCodeDataAddr) + apDlx->SegAlloc.Segment[DlxSeg_Read].mDataAddr);
+    if (apDlx->mpExpSecDataAddr[K2DLX_EXPIX_CODE] != ((DLX_EXPORTS_SECTION *)-1))
+        apDlx->mpExpSecDataAddr[K2DLX_EXPIX_CODE] = (DLX_EXPORTS_SECTION *)(((UINT8 *)apDlx->mpExpSecDataAddr[K2DLX_EXPIX_CODE]) + apDlx->SegAlloc.Segment[DlxSeg_Read].mDataAddr);
     else
-        apDlx->mpExpCodeDataAddr = NULL;
-    if (apDlx->mpExpReadDataAddr != ((DLX_EXPORTS_SECTION *)-1))
-        apDlx->mpExpReadDataAddr = (DLX_EXPORTS_SECTION *)(((UINT8 *)apDlx->mpExpReadDataAddr) + apDlx->SegAlloc.Segment[DlxSeg_Read].mDataAddr);
+        apDlx->mpExpSecDataAddr[K2DLX_EXPIX_CODE] = NULL;
+    if (apDlx->mpExpSecDataAddr[K2DLX_EXPIX_READ] != ((DLX_EXPORTS_SECTION *)-1))
+        apDlx->mpExpSecDataAddr[K2DLX_EXPIX_READ] = (DLX_EXPORTS_SECTION *)(((UINT8 *)apDlx->mpExpSecDataAddr[K2DLX_EXPIX_READ]) + apDlx->SegAlloc.Segment[DlxSeg_Read].mDataAddr);
     else
-        apDlx->mpExpReadDataAddr = NULL;
-    if (apDlx->mpExpDataDataAddr != ((DLX_EXPORTS_SECTION *)-1))
-        apDlx->mpExpDataDataAddr = (DLX_EXPORTS_SECTION *)(((UINT8 *)apDlx->mpExpDataDataAddr) + apDlx->SegAlloc.Segment[DlxSeg_Read].mDataAddr);
+        apDlx->mpExpSecDataAddr[K2DLX_EXPIX_READ] = NULL;
+    if (apDlx->mpExpSecDataAddr[K2DLX_EXPIX_DATA] != ((DLX_EXPORTS_SECTION *)-1))
+        apDlx->mpExpSecDataAddr[K2DLX_EXPIX_DATA] = (DLX_EXPORTS_SECTION *)(((UINT8 *)apDlx->mpExpSecDataAddr[K2DLX_EXPIX_DATA]) + apDlx->SegAlloc.Segment[DlxSeg_Read].mDataAddr);
     else
-        apDlx->mpExpDataDataAddr = NULL;
+        apDlx->mpExpSecDataAddr[K2DLX_EXPIX_DATA] = NULL;
 
     pWork += sizeof(DLX_INFO) - sizeof(UINT32);
     left -= sizeof(DLX_INFO) - sizeof(UINT32);
@@ -133,8 +133,6 @@ sExecPreload(
     K2MEM_Zero(&pSector->mSecAddr[3], (pElf->e_shnum - 3) * sizeof(UINT32));
     K2MEM_Zero(&pSector->mSecAddr[3 + pElf->e_shnum], (pElf->e_shnum - 3) * sizeof(UINT32));
 
-    secIx = 3;
-
     for (segIx = DlxSeg_Text; segIx < DlxSeg_Sym; segIx++)
     {
         count = K2_ROUNDUP(pInfo->SegInfo[segIx].mFileBytes, DLX_SECTOR_BYTES);
@@ -142,9 +140,13 @@ sExecPreload(
         {
             startAddr = pInfo->SegInfo[segIx].mLinkAddr;
             endAddr = startAddr + pInfo->SegInfo[segIx].mMemActualBytes;
-            while ((pSecHdr[secIx].sh_addr >= startAddr) &&
-                    (pSecHdr[secIx].sh_addr < endAddr))
+            for (secIx = 3; secIx < pElf->e_shnum; secIx++)
             {
+                // sections are not in segment order
+                if ((pSecHdr[secIx].sh_addr < startAddr) ||
+                    (pSecHdr[secIx].sh_addr >= endAddr))
+                    continue;
+
                 // addralign is segment index for section
                 pSecHdr[secIx].sh_addralign = segIx;
                 secSegOffset = pSecHdr[secIx].sh_addr - startAddr;
@@ -152,7 +154,6 @@ sExecPreload(
                 linkAddr = apDlx->SegAlloc.Segment[segIx].mLinkAddr;
                 if (linkAddr != 0)
                     pSector->mSecAddr[secIx + apDlx->mpElf->e_shnum] = secSegOffset + linkAddr;
-                secIx++;
             }
         }
     }
@@ -190,9 +191,6 @@ iK2DLXSUPP_Preload(
     pDlx->mFlags = gpK2DLXSUPP_Vars->mKeepSym ? K2DLXSUPP_FLAG_KEEP_SYMBOLS : 0;
     pDlx->mLinkAddr = (UINT32)apPreload->mpDlxPage;
 
-    for (secIx = 0;secIx < 3;secIx++)
-        K2TREE_Init(&pDlx->SymTree[secIx], iK2DLXSUPP_CompareUINT32);
-
     pData = (UINT8 const *)apPreload->mpDlxFileData;
     K2MEM_Copy(pPage->mHdrSectorsBuffer, pData, DLX_SECTOR_BYTES);
     pData += DLX_SECTOR_BYTES;
@@ -210,7 +208,9 @@ iK2DLXSUPP_Preload(
         (pHdr->e_shoff != sizeof(Elf32_Ehdr)) ||
         (pHdr->e_type != DLX_ET_DLX) ||
         (pHdr->e_ident[EI_OSABI] != DLX_ELFOSABI_K2) ||
-        (pHdr->e_ident[EI_ABIVERSION] != DLX_ELFOSABIVER_DLX) ||
+        ((pHdr->e_ident[EI_ABIVERSION] != DLX_ELFOSABIVER_DLX) &&
+             (pHdr->e_ident[EI_ABIVERSION] != DLX_ELFOSABIVER_DLX_V1)) ||
+        (pHdr->e_flags & DLX_EF_DEFLATED_MASK) ||
         (pHdr->e_shstrndx != 2))
     {
         K2_ASSERT(0);
@@ -295,13 +295,14 @@ iK2DLXSUPP_Preload(
         if (pDlx->mpSecHdr[secIx].sh_type == SHT_SYMTAB)
         {
             chkAddr = pDlx->mpSecHdr[secIx].sh_entsize;
-            if ((chkAddr < sizeof(K2DLX_SYMTREE_NODE)) || (chkAddr & 3))
+            if ((chkAddr < sizeof(Elf32_Sym)) || (chkAddr & 3))
             {
                 K2_ASSERT(0);
                 return;
             }
         }
-        else if (pDlx->mpSecHdr[secIx].sh_type == SHT_REL)
+        else if ((pDlx->mpSecHdr[secIx].sh_type == SHT_REL) ||
+                 (pDlx->mpSecHdr[secIx].sh_type == DLX_SHT_DLX_RELOC))
             pDlx->mRelocSectionCount++;
     }
 
@@ -330,12 +331,12 @@ iK2DLXSUPP_Preload(
             K2_ASSERT(0);
             return;
         }
-        pDlx->mpExpCodeDataAddr = (DLX_EXPORTS_SECTION *)(chkAddr - readSegStart);
+        pDlx->mpExpSecDataAddr[K2DLX_EXPIX_CODE] = (DLX_EXPORTS_SECTION *)(chkAddr - readSegStart);
         hasExports = TRUE;
         secIx--;
     }
     else
-        pDlx->mpExpCodeDataAddr = (DLX_EXPORTS_SECTION *)-1;
+        pDlx->mpExpSecDataAddr[K2DLX_EXPIX_CODE] = (DLX_EXPORTS_SECTION *)-1;
 
     chkAddr = (UINT32)pInfo->mpExpRead;
     if (chkAddr != 0)
@@ -351,12 +352,12 @@ iK2DLXSUPP_Preload(
             K2_ASSERT(0);
             return;
         }
-        pDlx->mpExpReadDataAddr = (DLX_EXPORTS_SECTION *)(chkAddr - readSegStart);
+        pDlx->mpExpSecDataAddr[K2DLX_EXPIX_READ] = (DLX_EXPORTS_SECTION *)(chkAddr - readSegStart);
         hasExports = TRUE;
         secIx--;
     }
     else
-        pDlx->mpExpReadDataAddr = (DLX_EXPORTS_SECTION *)-1;
+        pDlx->mpExpSecDataAddr[K2DLX_EXPIX_READ] = (DLX_EXPORTS_SECTION *)-1;
 
     chkAddr = (UINT32)pInfo->mpExpData;
     if (chkAddr != 0)
@@ -372,12 +373,12 @@ iK2DLXSUPP_Preload(
             K2_ASSERT(0);
             return;
         }
-        pDlx->mpExpDataDataAddr = (DLX_EXPORTS_SECTION *)(chkAddr - readSegStart);
+        pDlx->mpExpSecDataAddr[K2DLX_EXPIX_DATA] = (DLX_EXPORTS_SECTION *)(chkAddr - readSegStart);
         hasExports = TRUE;
         secIx--;
     }
     else
-        pDlx->mpExpDataDataAddr = (DLX_EXPORTS_SECTION *)-1;
+        pDlx->mpExpSecDataAddr[K2DLX_EXPIX_DATA] = (DLX_EXPORTS_SECTION *)-1;
 
     if (hasExports)
     {
@@ -397,5 +398,7 @@ iK2DLXSUPP_Preload(
 
     sExecPreload(pDlx, pData, fileOffset);
 
+    iK2DLXSUPP_SetExportDigests(pDlx);
+
     apPreload->mpListAnchorOut = &gpK2DLXSUPP_Vars->LoadedList;
 }
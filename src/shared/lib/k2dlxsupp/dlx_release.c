@@ -102,6 +102,8 @@ iK2DLXSUPP_ReleaseModule(
 
     iK2DLXSUPP_ReleaseImports(apDlx, apDlx->mpInfo->mImportCount);
 
+    iK2DLXSUPP_StatFree(apDlx);
+
     gpK2DLXSUPP_Vars->Host.Purge(apDlx->mHostFile);
 }
 
@@ -45,6 +45,24 @@
 extern "C" {
 #endif
 
+//
+// per-segment export arrays are indexed by (segment - DlxSeg_Text)
+//
+#define K2DLX_EXPIX_CODE    0
+#define K2DLX_EXPIX_READ    1
+#define K2DLX_EXPIX_DATA    2
+#define K2DLX_EXPIX_COUNT   3
+
+typedef struct _K2DLX_SYMINDEX K2DLX_SYMINDEX;
+struct _K2DLX_SYMINDEX
+{
+    UINT32 const *              mpIx;           // symbol indexes sorted by address
+    UINT32                      mCount;
+    UINT8 const *               mpSymBase;
+    UINT32                      mSymEntBytes;
+    char const *                mpSymStr;
+};
+
 struct _DLX
 {
     K2LIST_LINK                 ListLink;  // must be first thing in node
@@ -72,18 +90,14 @@ struct _DLX
 
     DLX_INFO *                  mpInfo;         // the mpExpXXX inside this gets updated during link
 
-    DLX_EXPORTS_SECTION *       mpExpCodeDataAddr;      // data addr of exports (Not link addr)
-    DLX_EXPORTS_SECTION *       mpExpReadDataAddr;
-    DLX_EXPORTS_SECTION *       mpExpDataDataAddr;
+    DLX_EXPORTS_SECTION *       mpExpSecDataAddr[K2DLX_EXPIX_COUNT];    // data addr of exports (Not link addr)
 
-    K2TREE_ANCHOR               SymTree[3];
-};
+    UINT32                      mExpDigest[K2DLX_EXPIX_COUNT];          // digest of final export addresses
 
-typedef struct _K2DLX_SYMTREE_NODE K2DLX_SYMTREE_NODE;
-struct _K2DLX_SYMTREE_NODE
-{
-    K2TREE_NODE TreeNode;
-    char *      mpSymName;
+    K2DLX_SYMINDEX              SymIndex[3];
+
+    UINT32                      mLoadLevel;     // depth in import graph during parallel load
+    K2STAT                      mLoadStatus;
 };
 
 #ifdef __cplusplus
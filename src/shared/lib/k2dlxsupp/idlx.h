@@ -70,6 +70,20 @@ struct _K2DLX_PAGE
 };
 K2_STATIC_ASSERT(sizeof(K2DLX_PAGE) == K2_VA32_MEMPAGE_BYTES);
 
+//
+// load stats live in the rest of the vars page, keyed by the link address of
+// the dlx page so they stay valid through handoff.  a dlx that is loaded when
+// they are all in use just does not get any
+//
+#define K2DLX_LOADSTAT_COUNT    32
+
+typedef struct _K2DLX_LOADSTAT K2DLX_LOADSTAT;
+struct _K2DLX_LOADSTAT
+{
+    DLX_LOAD_STATS  Stats;
+    UINT32          mDlxLinkAddr;   // 0 if not in use
+};
+
 typedef struct _K2DLXSUPP_VARS K2DLXSUPP_VARS;
 struct _K2DLXSUPP_VARS
 {
@@ -79,7 +93,9 @@ struct _K2DLXSUPP_VARS
     BOOL            mAcqDisabled;
     BOOL            mKeepSym;
     BOOL            mHandedOff;
+    K2DLX_LOADSTAT  LoadStat[K2DLX_LOADSTAT_COUNT];
 };
+K2_STATIC_ASSERT(sizeof(K2DLXSUPP_VARS) <= K2_VA32_MEMPAGE_BYTES);
 
 void
 iK2DLXSUPP_ReleaseImports(
@@ -105,6 +121,15 @@ iK2DLXSUPP_LoadSegments(
     DLX *   apDlx
     );
 
+K2STAT
+iK2DLXSUPP_InflateSegment(
+    void *      apAcqContext,
+    DLX *       apDlx,
+    UINT32      aSegIx,
+    UINT32      aSectorCount,
+    UINT32 *    apRetBytes
+    );
+
 K2STAT
 iK2DLXSUPP_Link(
     DLX *   apDlx
@@ -122,15 +147,24 @@ iK2DLXSUPP_FindExport(
     UINT32 *                    apRetAddr
     );
 
+UINT32
+iK2DLXSUPP_CalcExportDigest(
+    DLX_EXPORTS_SECTION const * apSec
+    );
+
+void
+iK2DLXSUPP_SetExportDigests(
+    DLX *   apDlx
+    );
+
 void
 iK2DLXSUPP_Cleanup(
     DLX *   apDlx
     );
 
-int
-iK2DLXSUPP_CompareUINT32(
-    UINT32          aKey,
-    K2TREE_NODE *   apDlx
+void
+iK2DLXSUPP_SetupSymIndex(
+    K2DLX_SECTOR *  apSector
     );
 
 void
@@ -138,6 +172,33 @@ iK2DLXSUPP_Preload(
     K2DLXSUPP_PRELOAD * apPreload
 );
 
+void
+iK2DLXSUPP_StatAlloc(
+    DLX *   apDlx
+    );
+
+void
+iK2DLXSUPP_StatFree(
+    DLX *   apDlx
+    );
+
+DLX_LOAD_STATS *
+iK2DLXSUPP_StatFind(
+    DLX *   apDlx
+    );
+
+UINT64
+iK2DLXSUPP_StatTime(
+    void
+    );
+
+void
+iK2DLXSUPP_StatPhase(
+    DLX *           apDlx,
+    DlxLoadPhase    aPhase,
+    UINT64          aStartTime
+    );
+
 #if K2_FLAG_NODEBUG
 #define K2DLXSUPP_ERRORPOINT(x)   x
 #else
@@ -132,7 +132,10 @@ static K2DLXSUPP_HOST sgDlxHost =
     sysDLX_Finalize,
     NULL,
     sysDLX_Purge,
-    NULL
+    NULL,
+
+    sysDLX_AllocScratch,
+    sysDLX_FreeScratch
 };
 
 static
@@ -208,7 +211,7 @@ K2OsLoaderEntryPoint (
 
     K2MEM_Zero(&gData, sizeof(gData));
     gData.mKernArenaLow = K2OS_KVA_FREE_BOTTOM;
-    gData.mKernArenaHigh = K2OS_KVA_FREE_TOP;
+    gData.mKernArenaHigh = K2OS_KVA_PRELINK_BASE;
     gData.LoadInfo.mpEFIST = (K2EFI_SYSTEM_TABLE *)gST;
 
     sSetupGraphics();
@@ -116,6 +116,8 @@ BOOL        sysDLX_PreCallback(void *apAcqContext, K2DLXSUPP_HOST_FILE aHostFile
 K2STAT      sysDLX_PostCallback(void *apAcqContext, K2DLXSUPP_HOST_FILE aHostFile, K2STAT aUserStatus, DLX *apDlx);
 K2STAT      sysDLX_Finalize(void *apAcqContext, K2DLXSUPP_HOST_FILE aHostFile, K2DLXSUPP_SEGALLOC *apUpdateAlloc);
 K2STAT      sysDLX_Purge(K2DLXSUPP_HOST_FILE aHostFile);
+void *      sysDLX_AllocScratch(void *apAcqContext, UINT32 aBytes);
+void        sysDLX_FreeScratch(void *apAcqContext, void *apMem);
 
 BOOL        sysDLX_ConvertLoadPtr(UINT32 * apAddr);
 
@@ -137,6 +137,45 @@ static EFIFILE * sFindFile(K2DLXSUPP_HOST_FILE aHostFile)
     return (EFIFILE *)pLink;
 }
 
+static BOOL sPrelinkRangeFree(UINT32 aVirtAddr, UINT32 aBytes)
+{
+    K2LIST_LINK *   pLink;
+    EFIDLX *        pDlx;
+    UINTN           segIx;
+    UINT32          segAddr;
+    UINT32          segBytes;
+
+    //
+    // prelinked segments can only go in the prelink window, and only 
+    // if no segment of a dlx prepared before this one is there already
+    //
+    if ((aVirtAddr < K2OS_KVA_PRELINK_BASE) ||
+        (aVirtAddr & K2_VA32_MEMPAGE_OFFSET_MASK) ||
+        (aBytes > K2OS_KVA_FREE_TOP - aVirtAddr))
+        return FALSE;
+
+    pLink = gData.EfiFileList.mpHead;
+    while (pLink != NULL)
+    {
+        pDlx = ((EFIFILE *)pLink)->mpDlx;
+        if (pDlx != NULL)
+        {
+            for (segIx = DlxSeg_Text; segIx < pDlx->mFirstNonLink; segIx++)
+            {
+                segAddr = pDlx->SegAlloc.Segment[segIx].mLinkAddr;
+                segBytes = K2_ROUNDUP(pDlx->Info.SegInfo[segIx].mMemActualBytes, K2_VA32_MEMPAGE_BYTES);
+                if ((segBytes > 0) &&
+                    (segAddr < aVirtAddr + aBytes) &&
+                    (aVirtAddr < segAddr + segBytes))
+                    return FALSE;
+            }
+        }
+        pLink = pLink->mpNext;
+    }
+
+    return TRUE;
+}
+
 static EFI_STATUS sLoadRofs(void)
 {
     EFI_STATUS              efiStatus;
@@ -728,6 +767,16 @@ K2STAT sysDLX_Prepare(void *apAcqContext, K2DLXSUPP_HOST_FILE aHostFile, DLX_INF
                 allocSize = K2_ROUNDUP(pOut->Info.SegInfo[segIx].mMemActualBytes, K2_VA32_MEMPAGE_BYTES);
                 if (allocSize > 0)
                 {
+                    //
+                    // a prelinked dlx goes where it was linked if it can, so 
+                    // that it does not need to be relocated
+                    //
+                    if (sPrelinkRangeFree(pOut->Info.SegInfo[segIx].mLinkAddr, allocSize))
+                    {
+                        pOut->SegAlloc.Segment[segIx].mLinkAddr = pOut->Info.SegInfo[segIx].mLinkAddr;
+                        continue;
+                    }
+
                     //
                     // DLX must go high as on A32, exception vectors at 0xFFFF0000 must be able
                     // to jump into kernel text segment directly (max 26-bit signed offset)
@@ -849,6 +898,26 @@ K2STAT sysDLX_Purge(K2DLXSUPP_HOST_FILE aHostFile)
     return status;
 }
 
+void * sysDLX_AllocScratch(void *apAcqContext, UINT32 aBytes)
+{
+    EFI_STATUS  efiStatus;
+    void *      pMem;
+
+    efiStatus = gBS->AllocatePool(EfiLoaderData, aBytes, &pMem);
+    if (efiStatus != EFI_SUCCESS)
+    {
+        K2Printf(L"*** AllocatePool for dlx scratch failed with status %r\n", efiStatus);
+        return NULL;
+    }
+
+    return pMem;
+}
+
+void sysDLX_FreeScratch(void *apAcqContext, void *apMem)
+{
+    gBS->FreePool(apMem);
+}
+
 void DumpFile(CHAR16 const *apFileName, void *apData, UINTN aDataBytes)
 {
     EFI_STATUS          efiStatus;